@@ -7,6 +7,9 @@
 
 #include <array>
 #include <atomic>
+
+#include "common/common.h"
+
 #if HAKLE_CPP_VERSION >= 17
 #include <bit>
 #endif
@@ -14,8 +17,6 @@
 #include <cstdio>
 #endif
 
-#include "common/common.h"
-
 namespace hakle {
 
 #ifdef HAKLE_USE_CONCEPT
@@ -169,7 +170,11 @@ struct HakleBlock : FreeListNode<HakleBlock<T, BLOCK_SIZE, Policy>>, Policy {
     HAKLE_CPP14_CONSTEXPR T* operator[]( std::size_t Index ) noexcept { return reinterpret_cast<T*>( Elements.data() ) + Index; }
     constexpr const T*       operator[]( std::size_t Index ) const noexcept { return reinterpret_cast<T*>( Elements.data() ) + Index; }
 
-    alignas( T ) std::array<HAKLE_BYTE, sizeof( T ) * BLOCK_SIZE> Elements{};
+    // user-provided, so value-initializing a block does not zero its element storage
+    HAKLE_CPP20_CONSTEXPR HakleBlock() noexcept {}
+
+    // raw storage, an element only exists between its placement new and its destruction
+    alignas( T ) std::array<HAKLE_BYTE, sizeof( T ) * BLOCK_SIZE> Elements;
 
     HakleBlock* Next{ nullptr };
 };
@@ -5,10 +5,16 @@
 #ifndef BLOCKMANAGER_H
 #define BLOCKMANAGER_H
 
+#include <algorithm>
 #include <atomic>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <thread>
 #include <type_traits>
+#include <utility>
 
 #include "Block.h"
 #include "common/CompressPair.h"
@@ -17,6 +23,30 @@
 
 #include <cassert>
 
+#if defined( __linux__ )
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// FreeList_Tagged keeps a tag in the top 16 bits of a pointer, so it needs 64-bit Linux on a target whose user space
+// addresses fit in 48 bits (x86-64 with 4-level paging, AArch64 with 48-bit VA and no top byte tags). Builds that tag
+// the top byte are left out here; a 5-level paging kernel can't be seen at compile time, FreeList_Tagged checks each add
+#if defined( __SANITIZE_HWADDRESS__ ) || defined( __ARM_FEATURE_MEMORY_TAGGING )
+#define HAKLE_TOP_BYTE_TAGGED 1
+#elif defined( __has_feature )
+#if __has_feature( hwaddress_sanitizer )
+#define HAKLE_TOP_BYTE_TAGGED 1
+#endif
+#endif
+
+#ifndef HAKLE_HAS_TAGGED_FREELIST
+#if defined( __linux__ ) && ( defined( __x86_64__ ) || defined( __aarch64__ ) ) && !defined( HAKLE_TOP_BYTE_TAGGED )
+#define HAKLE_HAS_TAGGED_FREELIST 1
+#else
+#define HAKLE_HAS_TAGGED_FREELIST 0
+#endif
+#endif
+
 // BlockPool + FreeList
 namespace hakle {
 
@@ -58,6 +88,12 @@ concept IsBlockManager = requires( T& t, AllocMode Mode, typename T::BlockType*
     t.ReturnBlocks( p );
 };
 
+// Optional extension, managers without it are served one block at a time (see RequisitionBlocks below)
+template <class T>
+concept IsBulkBlockManager = IsBlockManager<T> && requires( T& t, std::size_t Count, AllocMode Mode ) {
+    { t.RequisitionBlocks( Count, Mode ) } -> std::same_as<typename T::BlockType*>;
+};
+
 template <class BLOCK_TYPE, class T>
 concept CheckBlockManager = IsBlock<BLOCK_TYPE> && std::same_as<BLOCK_TYPE, typename T::BlockType>;
 
@@ -66,8 +102,22 @@ concept CheckBlockManager = IsBlock<BLOCK_TYPE> && std::same_as<BLOCK_TYPE, type
 // TODO: position?
 enum class AllocMode { CanAlloc, CannotAlloc };
 
+// What a manager does when a CanAlloc requisition would go over its budget
+enum class BudgetPolicy { Refuse, Wait };
+
+// Counters of a manager's block storage, only updated when the storage grows, shrinks or a growth is refused
+struct BlockCounters {
+    std::size_t CurrentBytes{};
+    std::size_t PeakBytes{};
+    // allocations past the initial pool, and the ones the budget refused
+    std::size_t OverflowAllocations{};
+    std::size_t RefusedAllocations{};
+};
+
 struct MemoryBase {
     bool HasOwner{ false };
+    // NUMA node whose manager the block belongs to, only used by NumaBlockManager
+    std::uint16_t HomeNode{ 0 };
 };
 
 template <class T>
@@ -76,6 +126,27 @@ struct FreeListNode : MemoryBase {
     std::atomic<T*>       FreeListNext{ 0 };
 };
 
+// Exponential backoff for a failed CAS: 1, 2, 4 ... pause hints, then the thread yields once MaxSpins is passed.
+// Only retries pay for it, an uncontended CAS never gets here.
+class Backoff {
+public:
+    HAKLE_CPP14_CONSTEXPR void Pause() noexcept {
+        if ( Spins > MaxSpins ) {
+            std::this_thread::yield();
+            return;
+        }
+        for ( std::uint32_t i = 0; i < Spins; ++i ) {
+            HAKLE_CPU_PAUSE();
+        }
+        Spins <<= 1;
+    }
+
+private:
+    static constexpr std::uint32_t MaxSpins = 64;
+
+    std::uint32_t Spins{ 1 };
+};
+
 template <HAKLE_CONCEPT( IsFreeListNode ) Node, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<Node>>
 class FreeList {
 public:
@@ -134,8 +205,27 @@ public:
         }
     }
 
+    // Adds a chain linked through FreeListNext (null terminated) with a single CAS on the head.
+    // Like Add, a node still referenced by a concurrent TryGet is left to whoever drops the last ref.
+    HAKLE_CPP14_CONSTEXPR void AddChain( Node* First ) noexcept {
+        Node* ChainHead = nullptr;
+        Node* ChainTail = nullptr;
+        while ( First != nullptr ) {
+            Node* Next = First->FreeListNext.load( std::memory_order_relaxed );
+            if ( First->FreeListRefs.fetch_add( AddFlag, std::memory_order_relaxed ) == 0 ) {
+                Link( ChainHead, ChainTail, First );
+            }
+            First = Next;
+        }
+
+        if ( ChainHead != nullptr ) {
+            InnerAddChain( ChainHead, ChainTail );
+        }
+    }
+
     HAKLE_CPP14_CONSTEXPR Node* TryGet() noexcept {
-        Node* CurrentHead = Head().load( std::memory_order_relaxed );
+        Backoff Retry;
+        Node*   CurrentHead = Head().load( std::memory_order_relaxed );
         while ( CurrentHead != nullptr ) {
             Node*    PrevHead = CurrentHead;
             uint32_t Refs     = CurrentHead->FreeListRefs.load( std::memory_order_relaxed );
@@ -143,6 +233,7 @@ public:
                  || ( !CurrentHead->FreeListRefs.compare_exchange_strong( Refs, Refs + 1, std::memory_order_acquire,
                                                                           std::memory_order_relaxed ) ) )  // try add refs
             {
+                Retry.Pause();
                 CurrentHead = Head().load( std::memory_order_relaxed );
                 continue;
             }
@@ -161,6 +252,57 @@ public:
                 // no one is using it, add it back
                 InnerAdd( PrevHead );
             }
+            Retry.Pause();
+        }
+        return nullptr;
+    }
+
+    // Takes up to MaxCount nodes with a single CAS on the head, linked through FreeListNext.
+    // While we hold a ref on the head it cannot be re-added, so if it is still the head when the CAS succeeds
+    // nothing below it has changed and the walked chain is exactly what we took.
+    HAKLE_CPP14_CONSTEXPR Node* TryGetChain( std::size_t MaxCount, std::size_t& Count ) noexcept {
+        Count = 0;
+        if HAKLE_UNLIKELY ( MaxCount == 0 ) {
+            return nullptr;
+        }
+
+        Backoff Retry;
+        Node*   CurrentHead = Head().load( std::memory_order_relaxed );
+        while ( CurrentHead != nullptr ) {
+            Node*    PrevHead = CurrentHead;
+            uint32_t Refs     = CurrentHead->FreeListRefs.load( std::memory_order_relaxed );
+            if ( ( Refs & RefsMask ) == 0 || ( !CurrentHead->FreeListRefs.compare_exchange_strong( Refs, Refs + 1, std::memory_order_acquire, std::memory_order_relaxed ) ) ) {
+                Retry.Pause();
+                CurrentHead = Head().load( std::memory_order_relaxed );
+                continue;
+            }
+
+            std::size_t ChainCount = 1;
+            Node*       ChainTail  = CurrentHead;
+            Node*       Next       = ChainTail->FreeListNext.load( std::memory_order_acquire );
+            while ( ChainCount < MaxCount && Next != nullptr ) {
+                ChainTail = Next;
+                Next      = ChainTail->FreeListNext.load( std::memory_order_acquire );
+                ++ChainCount;
+            }
+
+            if ( Head().compare_exchange_strong( CurrentHead, Next, std::memory_order_acquire, std::memory_order_relaxed ) ) {
+                // drop the list's ref of every node, and ours of the head
+                PrevHead->FreeListRefs.fetch_add( -2, std::memory_order_relaxed );
+                for ( Node* Taken = PrevHead; Taken != ChainTail; ) {
+                    Taken = Taken->FreeListNext.load( std::memory_order_relaxed );
+                    Taken->FreeListRefs.fetch_add( -1, std::memory_order_relaxed );
+                }
+                ChainTail->FreeListNext.store( nullptr, std::memory_order_relaxed );
+                Count = ChainCount;
+                return PrevHead;
+            }
+
+            Refs = PrevHead->FreeListRefs.fetch_add( -1, std::memory_order_relaxed );
+            if ( Refs == AddFlag + 1 ) {
+                InnerAdd( PrevHead );
+            }
+            Retry.Pause();
         }
         return nullptr;
     }
@@ -169,10 +311,21 @@ public:
     // only useful when there is no contention (e.g. destruction)
     constexpr Node* GetHead() const noexcept { return Head().load( std::memory_order_relaxed ); }
 
+    // Counts up to Limit nodes without taking any. Only a hint while other threads take or add nodes,
+    // and nodes must stay allocated while they are in use elsewhere, as blocks of a manager do.
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t EstimateSize( std::size_t Limit ) const noexcept {
+        std::size_t Count = 0;
+        for ( Node* Current = Head().load( std::memory_order_acquire ); Current != nullptr && Count < Limit; Current = Current->FreeListNext.load( std::memory_order_acquire ) ) {
+            ++Count;
+        }
+        return Count;
+    }
+
 private:
     // add when ref count == 0
     HAKLE_CPP14_CONSTEXPR void InnerAdd( Node* InNode ) noexcept {
-        Node* CurrentHead = Head().load( std::memory_order_relaxed );
+        Backoff Retry;
+        Node*   CurrentHead = Head().load( std::memory_order_relaxed );
         while ( true ) {
             // first update next then refs
             InNode->FreeListNext.store( CurrentHead, std::memory_order_relaxed );
@@ -180,6 +333,7 @@ private:
             if ( !Head().compare_exchange_strong( CurrentHead, InNode, std::memory_order_relaxed, std::memory_order_relaxed ) ) {
                 // check if someone already using it
                 if ( InNode->FreeListRefs.fetch_add( AddFlag - 1, std::memory_order_release ) == 1 ) {
+                    Retry.Pause();
                     continue;
                 }
             }
@@ -187,6 +341,57 @@ private:
         }
     }
 
+    static HAKLE_CPP14_CONSTEXPR void Link( Node*& ChainHead, Node*& ChainTail, Node* InNode ) noexcept {
+        if ( ChainTail == nullptr ) {
+            ChainHead = InNode;
+        }
+        else {
+            ChainTail->FreeListNext.store( InNode, std::memory_order_relaxed );
+        }
+        ChainTail = InNode;
+    }
+
+    // add a chain of nodes that all have ref count == 0
+    HAKLE_CPP14_CONSTEXPR void InnerAddChain( Node* ChainHead, Node* ChainTail ) noexcept {
+        Backoff Retry;
+        Node*   CurrentHead = Head().load( std::memory_order_relaxed );
+        while ( true ) {
+            // first update next then refs, each node's release publishes its own next
+            ChainTail->FreeListNext.store( CurrentHead, std::memory_order_relaxed );
+            for ( Node* Current = ChainHead;; ) {
+                Node* Next = Current->FreeListNext.load( std::memory_order_relaxed );
+                Current->FreeListRefs.store( 1, std::memory_order_release );
+                if ( Current == ChainTail ) {
+                    break;
+                }
+                Current = Next;
+            }
+            if ( Head().compare_exchange_strong( CurrentHead, ChainHead, std::memory_order_relaxed, std::memory_order_relaxed ) ) {
+                return;
+            }
+
+            // nodes someone took a ref on meanwhile are re-added by them, retry with the rest
+            Node* Current = ChainHead;
+            Node* End     = ChainTail;
+            ChainHead = ChainTail = nullptr;
+            while ( true ) {
+                Node* Next = Current->FreeListNext.load( std::memory_order_relaxed );
+                bool  Last = Current == End;
+                if ( Current->FreeListRefs.fetch_add( AddFlag - 1, std::memory_order_release ) == 1 ) {
+                    Link( ChainHead, ChainTail, Current );
+                }
+                if ( Last ) {
+                    break;
+                }
+                Current = Next;
+            }
+            if ( ChainHead == nullptr ) {
+                return;
+            }
+            Retry.Pause();
+        }
+    }
+
     static constexpr uint32_t RefsMask = 0x7fffffff;
     static constexpr uint32_t AddFlag  = 0x80000000;
 
@@ -252,6 +457,24 @@ public:
         } while ( !Head().compare_exchange_strong( CurrentHead, NewHead, std::memory_order_relaxed, std::memory_order_relaxed ) );
     }
 
+    // Adds a chain linked through FreeListNext (null terminated) with a single DCAS on the head.
+    HAKLE_CPP14_CONSTEXPR void AddChain( Node* First ) noexcept {
+        if ( First == nullptr ) {
+            return;
+        }
+        Node* ChainTail = First;
+        for ( Node* Next = ChainTail->FreeListNext.load( std::memory_order_relaxed ); Next != nullptr; Next = ChainTail->FreeListNext.load( std::memory_order_relaxed ) ) {
+            ChainTail = Next;
+        }
+
+        HeadPtr CurrentHead = Head().load( std::memory_order_relaxed );
+        HeadPtr NewHead{ First, 0 };
+        do {
+            NewHead.Tag = CurrentHead.Tag + 1;
+            ChainTail->FreeListNext.store( CurrentHead.Ptr, std::memory_order_relaxed );
+        } while ( !Head().compare_exchange_strong( CurrentHead, NewHead, std::memory_order_relaxed, std::memory_order_relaxed ) );
+    }
+
     HAKLE_CPP14_CONSTEXPR Node* TryGet() noexcept {
         HeadPtr CurrentHead = Head().load( std::memory_order_relaxed );
         HeadPtr NewHead;
@@ -265,10 +488,50 @@ public:
         return CurrentHead.Ptr;
     }
 
+    // Takes up to MaxCount nodes with a single DCAS on the head, linked through FreeListNext.
+    // The walk may read nodes that are concurrently taken, the tag makes the DCAS fail in that case.
+    HAKLE_CPP14_CONSTEXPR Node* TryGetChain( std::size_t MaxCount, std::size_t& Count ) noexcept {
+        Count = 0;
+        if HAKLE_UNLIKELY ( MaxCount == 0 ) {
+            return nullptr;
+        }
+
+        HeadPtr     CurrentHead = Head().load( std::memory_order_relaxed );
+        HeadPtr     NewHead;
+        Node*       ChainTail  = nullptr;
+        std::size_t ChainCount = 0;
+        while ( CurrentHead.Ptr != nullptr ) {
+            ChainCount  = 1;
+            ChainTail   = CurrentHead.Ptr;
+            NewHead.Ptr = ChainTail->FreeListNext.load( std::memory_order_relaxed );
+            while ( ChainCount < MaxCount && NewHead.Ptr != nullptr ) {
+                ChainTail   = NewHead.Ptr;
+                NewHead.Ptr = ChainTail->FreeListNext.load( std::memory_order_relaxed );
+                ++ChainCount;
+            }
+            NewHead.Tag = CurrentHead.Tag + 1;
+            if ( Head().compare_exchange_strong( CurrentHead, NewHead, std::memory_order_relaxed, std::memory_order_relaxed ) ) {
+                ChainTail->FreeListNext.store( nullptr, std::memory_order_relaxed );
+                Count = ChainCount;
+                break;
+            }
+        }
+        return CurrentHead.Ptr;
+    }
+
     // NOTE: This is intentionally not thread safe; it is up to the user to synchronize this call.
     // only useful when there is no contention (e.g. destruction)
     constexpr Node* GetHead() const noexcept { return Head().load( std::memory_order_relaxed ).Ptr; }
 
+    // Counts up to Limit nodes without taking any, only a hint while other threads take or add nodes
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t EstimateSize( std::size_t Limit ) const noexcept {
+        std::size_t Count = 0;
+        for ( Node* Current = Head().load( std::memory_order_acquire ).Ptr; Current != nullptr && Count < Limit; Current = Current->FreeListNext.load( std::memory_order_relaxed ) ) {
+            ++Count;
+        }
+        return Count;
+    }
+
 private:
     struct HeadPtr {
         Node*          Ptr{};
@@ -284,198 +547,2402 @@ private:
     CompressPair<std::atomic<HeadPtr>, AllocatorType> AllocatorPair{};
 };
 
-template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>>
-class BlockPool {
+#if HAKLE_HAS_TAGGED_FREELIST
+// Same interface as FreeList_DAS, but the head is one 64-bit word: a 48-bit pointer under a 16-bit tag, so a plain CAS
+// does without libatomic. Like FreeList_DAS a take may read the next of a node another thread just took, so nodes must
+// stay allocated while the list is in use, and the tag only makes an ABA of the head unlikely, not impossible.
+template <HAKLE_CONCEPT( IsFreeListNode ) Node, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<Node>>
+class FreeList_Tagged {
 public:
+#ifndef HAKLE_USE_CONCEPT
+    static_assert( std::is_base_of<FreeListNode<Node>, Node>::value, "Node must be derived from FreeListNode<Node>" );
+#endif
+    static_assert( sizeof( Node* ) == sizeof( std::uint64_t ), "FreeList_Tagged needs 64-bit pointers" );
+
     using AllocatorType   = ALLOCATOR_TYPE;
     using AllocatorTraits = HakeAllocatorTraits<AllocatorType>;
 
-    HAKLE_CPP14_CONSTEXPR explicit BlockPool( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{} ) : AllocatorPair{ InSize, InAllocator } {
-        if ( Size() > 0 ) {
-            Head = AllocatorTraits::Allocate( Allocator(), Size() );
-            for ( std::size_t i = 0; i < Size(); i++ ) {
-                AllocatorTraits::Construct( Allocator(), Head + i );
-                Head[ i ].HasOwner = true;
-            }
-        }
-    }
+    constexpr explicit FreeList_Tagged( const AllocatorType& InAllocator = AllocatorType{} ) : AllocatorPair( 0, InAllocator ) {}
 
-    HAKLE_CPP20_CONSTEXPR ~BlockPool() { Clear(); }
+    HAKLE_CPP20_CONSTEXPR ~FreeList_Tagged() { Clear(); }
 
-    HAKLE_CPP14_CONSTEXPR BlockPool( BlockPool&& Other ) noexcept : HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, AllocatorPair, Head ), HAKLE_MOVE_ATOMIC( Index ) { Other.Reset(); }
+    HAKLE_CPP14_CONSTEXPR FreeList_Tagged( FreeList_Tagged&& Other ) noexcept : HAKLE_MOVE_PAIR_ATOMIC1( AllocatorPair ) { Other.Reset(); }
 
-    constexpr BlockPool& operator=( BlockPool&& Other ) noexcept {
+    constexpr FreeList_Tagged& operator=( FreeList_Tagged&& Other ) noexcept {
         if ( this != &Other ) {
             Clear();
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, AllocatorPair, Head );
-            HAKLE_OP_MOVE_ATOMIC( Index );
+            Head().store( Other.Head().load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            Allocator() = std::move( Other.Allocator() );
             Other.Reset();
         }
         return *this;
     }
 
-    constexpr BlockPool( const BlockPool& Other )            = delete;
-    constexpr BlockPool& operator=( const BlockPool& Other ) = delete;
+    constexpr FreeList_Tagged( const FreeList_Tagged& Other )            = delete;
+    constexpr FreeList_Tagged& operator=( const FreeList_Tagged& Other ) = delete;
 
     HAKLE_CPP14_CONSTEXPR void Clear() noexcept {
-        AllocatorTraits::Destroy( Allocator(), Head, Size() );
-        AllocatorTraits::Deallocate( Allocator(), Head, Size() );
+        Node* CurrentNode = GetHead();
+        while ( CurrentNode != nullptr ) {
+            Node* Next = CurrentNode->FreeListNext.load( std::memory_order_relaxed );
+            if ( !CurrentNode->HasOwner ) {
+                AllocatorTraits::Destroy( Allocator(), CurrentNode );
+                AllocatorTraits::Deallocate( Allocator(), CurrentNode );
+            }
+            CurrentNode = Next;
+        }
     }
 
-    HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
-        Size() = 0;
-        Head   = nullptr;
-        Index.store( 0, std::memory_order_relaxed );
-    }
+    HAKLE_CPP14_CONSTEXPR void Reset() noexcept { Head().store( 0, std::memory_order_relaxed ); }
 
 #if HAKLE_CPP_VERSION >= 20
-    HAKLE_CPP14_CONSTEXPR void swap( BlockPool& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
-        HAKLE_SWAP_ATOMIC( Index );
+    HAKLE_CPP14_CONSTEXPR void swap( FreeList_Tagged& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
+        HAKLE_SWAP_ATOMIC( Head() );
         using std::swap;
-        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, AllocatorPair, Head );
+        HAKLE_SWAP( Allocator() );
     }
 #endif
 
-    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetSize() const noexcept { return Size(); }
+    HAKLE_CPP14_CONSTEXPR void Add( Node* InNode ) noexcept {
+        CheckHold( InNode );
+        InnerAddChain( InNode, InNode );
+    }
 
-    HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* GetBlock() noexcept {
-        if ( Index.load( std::memory_order_relaxed ) >= Size() )
-            return nullptr;
+    // Adds a chain linked through FreeListNext (null terminated) with a single CAS on the head.
+    HAKLE_CPP14_CONSTEXPR void AddChain( Node* First ) noexcept {
+        if ( First == nullptr ) {
+            return;
+        }
+        CheckHold( First );
+        Node* ChainTail = First;
+        for ( Node* Next = ChainTail->FreeListNext.load( std::memory_order_relaxed ); Next != nullptr; Next = ChainTail->FreeListNext.load( std::memory_order_relaxed ) ) {
+            CheckHold( Next );
+            ChainTail = Next;
+        }
+        InnerAddChain( First, ChainTail );
+    }
 
-        std::size_t CurrentIndex = Index.fetch_add( 1, std::memory_order_relaxed );
-        return CurrentIndex < Size() ? ( Head + CurrentIndex ) : nullptr;
+    HAKLE_CPP14_CONSTEXPR Node* TryGet() noexcept {
+        Backoff       Retry;
+        std::uint64_t CurrentHead = Head().load( std::memory_order_acquire );
+        while ( Node* HeadNode = Unpack( CurrentHead ) ) {
+            Node* Next = HeadNode->FreeListNext.load( std::memory_order_relaxed );
+            if ( Head().compare_exchange_weak( CurrentHead, Pack( Next, CurrentHead ), std::memory_order_acquire, std::memory_order_acquire ) ) {
+                return HeadNode;
+            }
+            Retry.Pause();
+        }
+        return nullptr;
     }
 
-private:
-    HAKLE_CPP14_CONSTEXPR AllocatorType& Allocator() noexcept { return AllocatorPair.Second(); }
-    constexpr const AllocatorType&       Allocator() const noexcept { return AllocatorPair.Second(); }
-    HAKLE_CPP14_CONSTEXPR std::size_t&           Size() noexcept { return AllocatorPair.First(); }
-    HAKLE_NODISCARD constexpr const std::size_t& Size() const noexcept { return AllocatorPair.First(); }
+    // Takes up to MaxCount nodes with a single CAS on the head, linked through FreeListNext.
+    // The walk may read nodes that are concurrently taken, the tag makes the CAS fail in that case.
+    HAKLE_CPP14_CONSTEXPR Node* TryGetChain( std::size_t MaxCount, std::size_t& Count ) noexcept {
+        Count = 0;
+        if HAKLE_UNLIKELY ( MaxCount == 0 ) {
+            return nullptr;
+        }
 
-    // compressed allocator
-    CompressPair<std::size_t, AllocatorType> AllocatorPair{};
-    BLOCK_TYPE*                              Head{ nullptr };
-    std::atomic<std::size_t>                 Index{ 0 };
-};
+        Backoff       Retry;
+        std::uint64_t CurrentHead = Head().load( std::memory_order_acquire );
+        while ( Node* HeadNode = Unpack( CurrentHead ) ) {
+            std::size_t ChainCount = 1;
+            Node*       ChainTail  = HeadNode;
+            Node*       Next       = ChainTail->FreeListNext.load( std::memory_order_relaxed );
+            while ( ChainCount < MaxCount && Next != nullptr ) {
+                ChainTail = Next;
+                Next      = ChainTail->FreeListNext.load( std::memory_order_relaxed );
+                ++ChainCount;
+            }
+            if ( Head().compare_exchange_weak( CurrentHead, Pack( Next, CurrentHead ), std::memory_order_acquire, std::memory_order_acquire ) ) {
+                ChainTail->FreeListNext.store( nullptr, std::memory_order_relaxed );
+                Count = ChainCount;
+                return HeadNode;
+            }
+            Retry.Pause();
+        }
+        return nullptr;
+    }
 
-template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE>
-class BlockManagerBase : private CompressPairElem<ALLOCATOR_TYPE, 0> {
-public:
-    using AllocatorType        = ALLOCATOR_TYPE;
-    using BlockAllocatorTraits = HakeAllocatorTraits<AllocatorType>;
-    using BlockType            = BLOCK_TYPE;
-#ifdef HAKLE_USE_CONCEPT
-    constexpr static std::size_t BlockSize = BlockType::BlockSize;
-    using ValueType                        = typename BlockType::ValueType;
-#else
-    using BlockTraits                      = BlockTraits<BlockType>;
-    constexpr static std::size_t BlockSize = BlockTraits::BlockSize;
-    using ValueType                        = typename BlockTraits::ValueType;
-#endif
+    // NOTE: This is intentionally not thread safe; it is up to the user to synchronize this call.
+    // only useful when there is no contention (e.g. destruction)
+    constexpr Node* GetHead() const noexcept { return Unpack( Head().load( std::memory_order_relaxed ) ); }
 
-    constexpr BlockManagerBase() = default;
-    constexpr explicit BlockManagerBase( const AllocatorType& InAllocator = AllocatorType{} ) : Base( InAllocator ) {}
-    HAKLE_CPP14_CONSTEXPR ~BlockManagerBase() = default;
+    // Counts up to Limit nodes without taking any, only a hint while other threads take or add nodes
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t EstimateSize( std::size_t Limit ) const noexcept {
+        std::size_t Count = 0;
+        for ( Node* Current = Unpack( Head().load( std::memory_order_acquire ) ); Current != nullptr && Count < Limit; Current = Current->FreeListNext.load( std::memory_order_relaxed ) ) {
+            ++Count;
+        }
+        return Count;
+    }
 
-    HAKLE_CPP14_CONSTEXPR                   BlockManagerBase( BlockManagerBase&& Other ) noexcept = default;
-    HAKLE_CPP14_CONSTEXPR BlockManagerBase& operator=( BlockManagerBase&& Other ) noexcept        = default;
+    // False for an address above the low 48 bits, e.g. a high mmap on a kernel with 5-level paging (57-bit VA) or a
+    // pointer with a tagged top byte; the head has no room for it
+    static bool CanHold( const Node* InNode ) noexcept { return ( reinterpret_cast<std::uintptr_t>( InNode ) & ~PointerMask ) == 0; }
 
-    HAKLE_CPP14_CONSTEXPR                   BlockManagerBase( const BlockManagerBase& Other ) = delete;
-    HAKLE_CPP14_CONSTEXPR BlockManagerBase& operator=( const BlockManagerBase& Other )        = delete;
+private:
+    static constexpr unsigned      PointerBits = 48;
+    static constexpr std::uint64_t PointerMask = ( std::uint64_t{ 1 } << PointerBits ) - 1;
+
+    // Checked on every add, release builds included: a truncated pointer would hand out some other memory later, so
+    // stop here instead
+    static void CheckHold( const Node* InNode ) noexcept {
+        if HAKLE_UNLIKELY ( !CanHold( InNode ) ) {
+            std::abort();
+        }
+    }
 
-#if HAKLE_CPP_VERSION >= 20
-    HAKLE_CPP14_CONSTEXPR void swap( BlockManagerBase& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
-        // TODO: swap allocator_type traits
-        // TODO: checking user-defined allocator, blockmanager, block,
-        using std::swap;
-        swap( static_cast<Base&>( *this ), static_cast<Base&>( Other ) );
+    // every successful CAS bumps the tag of the head it replaces
+    static std::uint64_t Pack( Node* InNode, std::uint64_t OldHead ) noexcept {
+        std::uint64_t Address = reinterpret_cast<std::uint64_t>( InNode );
+        assert( ( Address & ~PointerMask ) == 0 && "Add lets only nodes in the low 48 bits in" );
+        return ( ( OldHead & ~PointerMask ) + ( std::uint64_t{ 1 } << PointerBits ) ) | Address;
     }
-#endif
 
-    using AllocMode = hakle::AllocMode;
+    static Node* Unpack( std::uint64_t InHead ) noexcept { return reinterpret_cast<Node*>( InHead & PointerMask ); }
 
-    virtual HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode InMode ) = 0;
-    virtual HAKLE_CPP20_CONSTEXPR void       ReturnBlocks( BlockType* InBlock )   = 0;
-    virtual HAKLE_CPP20_CONSTEXPR void       ReturnBlock( BlockType* InBlock )    = 0;
+    HAKLE_CPP14_CONSTEXPR void InnerAddChain( Node* ChainHead, Node* ChainTail ) noexcept {
+        Backoff       Retry;
+        std::uint64_t CurrentHead = Head().load( std::memory_order_relaxed );
+        while ( true ) {
+            ChainTail->FreeListNext.store( Unpack( CurrentHead ), std::memory_order_relaxed );
+            if ( Head().compare_exchange_weak( CurrentHead, Pack( ChainHead, CurrentHead ), std::memory_order_release, std::memory_order_relaxed ) ) {
+                return;
+            }
+            Retry.Pause();
+        }
+    }
 
-    HAKLE_CPP14_CONSTEXPR AllocatorType& Allocator() noexcept { return Base::Get(); }
-    constexpr const AllocatorType&       Allocator() const noexcept { return Base::Get(); }
+    HAKLE_CPP14_CONSTEXPR AllocatorType& Allocator() noexcept { return AllocatorPair.Second(); }
+    constexpr const AllocatorType&       Allocator() const noexcept { return AllocatorPair.Second(); }
+    HAKLE_CPP14_CONSTEXPR std::atomic<std::uint64_t>& Head() noexcept { return AllocatorPair.First(); }
+    constexpr const std::atomic<std::uint64_t>&       Head() const noexcept { return AllocatorPair.First(); }
 
-private:
-    using Base = CompressPairElem<ALLOCATOR_TYPE, 0>;
+    // compressed allocator
+    CompressPair<std::atomic<std::uint64_t>, AllocatorType> AllocatorPair{};
 };
+#endif
 
-// We set a block pool and a free list
-template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>>
-class HakleBlockManager : public BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE> {
+// Elimination slots in front of another free list, a drop-in FREE_LIST_TYPE for HakleBlockManager.
+// Add offers its node on a random slot for a few pauses and TryGet probes a random slot before the inner list, so an
+// Add and a TryGet that meet on a slot exchange the node without touching the head of the inner list. An offer nobody
+// took is withdrawn into the inner list, so slots only hold nodes while an Add is waiting on them.
+// Each slot adapts how long an offer waits: a taken offer opens it to OfferSpins, a withdrawn one halves it. Once it
+// is closed, only one Add in ProbeInterval offers there for ProbeSpins, so an uncontended Add goes straight to the
+// inner list.
+template <HAKLE_CONCEPT( IsFreeListNode ) Node, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<Node>, class INNER_LIST_TYPE = FreeList<Node, ALLOCATOR_TYPE>,
+          std::size_t SLOT_COUNT = 8>
+class EliminationFreeList {
 public:
-    using BaseManager = BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE>;
-    // TODO:
-    // using typename BaseManager::AllocatorType;
-    using AllocatorType = typename BaseManager::AllocatorType;
+    static_assert( SLOT_COUNT > 0, "EliminationFreeList needs at least one slot" );
 
-    using typename BaseManager::BlockAllocatorTraits;
-    using typename BaseManager::BlockType;
-    using typename BaseManager::ValueType;
+    using AllocatorType = ALLOCATOR_TYPE;
+    using InnerListType = INNER_LIST_TYPE;
 
-    using AllocMode = typename BaseManager::AllocMode;
+    static constexpr std::uint32_t OfferSpins    = 16;
+    static constexpr std::uint32_t ProbeSpins    = 4;
+    static constexpr std::uint32_t ProbeInterval = 64;
 
-    constexpr explicit HakleBlockManager( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{} ) : BaseManager( InAllocator ), Pool( InSize, InAllocator ), List( InAllocator ) {}
-    HAKLE_CPP20_CONSTEXPR ~HakleBlockManager() = default;
+    constexpr explicit EliminationFreeList( const AllocatorType& InAllocator = AllocatorType{} ) : Inner( InAllocator ) {}
 
-    HAKLE_CPP14_CONSTEXPR                    HakleBlockManager( HakleBlockManager&& Other ) noexcept = default;
-    HAKLE_CPP14_CONSTEXPR HakleBlockManager& operator=( HakleBlockManager&& Other ) noexcept         = default;
+    // slots are empty once no Add is running, so moving and swapping only concern the inner list
+    HAKLE_CPP14_CONSTEXPR EliminationFreeList( EliminationFreeList&& Other ) noexcept : Inner( std::move( Other.Inner ) ) {}
 
-    HAKLE_CPP14_CONSTEXPR                    HakleBlockManager( const HakleBlockManager& Other ) = delete;
-    HAKLE_CPP14_CONSTEXPR HakleBlockManager& operator=( const HakleBlockManager& Other )         = delete;
+    HAKLE_CPP14_CONSTEXPR EliminationFreeList& operator=( EliminationFreeList&& Other ) noexcept {
+        if ( this != &Other ) {
+            Inner = std::move( Other.Inner );
+        }
+        return *this;
+    }
+
+    constexpr EliminationFreeList( const EliminationFreeList& Other )            = delete;
+    constexpr EliminationFreeList& operator=( const EliminationFreeList& Other ) = delete;
 
 #if HAKLE_CPP_VERSION >= 20
-    HAKLE_CPP14_CONSTEXPR void swap( HakleBlockManager& Other ) noexcept HAKLE_REQUIRES( std::swappable<BlockPool<BlockType, AllocatorType>>&& std::swappable<FreeList<BlockType, AllocatorType>> ) {
-        BaseManager::swap( Other );
-        Pool.swap( Other.Pool );
-        List.swap( Other.List );
-    }
+    HAKLE_CPP14_CONSTEXPR void swap( EliminationFreeList& Other ) noexcept HAKLE_REQUIRES( std::swappable<InnerListType> ) { Inner.swap( Other.Inner ); }
 #endif
 
-    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetBlockPoolSize() const noexcept { return Pool.GetSize(); }
-
-    HAKLE_CPP14_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) override {
-        BlockType* Block = Pool.GetBlock();
-        if ( Block != nullptr ) {
-            return Block;
+    HAKLE_CPP14_CONSTEXPR void Add( Node* InNode ) noexcept {
+        std::uint32_t Random = NextRandom();
+        Slot&         Offer  = Slots[ Random % SLOT_COUNT ];
+        std::uint32_t Window = Offer.Window.load( std::memory_order_relaxed );
+        if ( Window == 0 ) {
+            if ( ( Random >> 16 ) % ProbeInterval != 0 ) {
+                Inner.Add( InNode );
+                return;
+            }
+            Window = ProbeSpins;
         }
 
-        Block = List.TryGet();
-        if ( Block != nullptr ) {
+        Node* Expected = nullptr;
+        if ( Offer.Parked.load( std::memory_order_relaxed ) == nullptr
+             && Offer.Parked.compare_exchange_strong( Expected, InNode, std::memory_order_release, std::memory_order_relaxed ) ) {
+            for ( std::uint32_t i = 0; i < Window; ++i ) {
+                if ( Offer.Parked.load( std::memory_order_relaxed ) != InNode ) {
+                    Offer.Window.store( OfferSpins, std::memory_order_relaxed );
+                    return;
+                }
+                HAKLE_CPU_PAUSE();
+            }
+            // whoever clears the slot owns the node, a failed withdraw means a TryGet took it
+            Expected = InNode;
+            if ( !Offer.Parked.compare_exchange_strong( Expected, nullptr, std::memory_order_acquire, std::memory_order_relaxed ) ) {
+                Offer.Window.store( OfferSpins, std::memory_order_relaxed );
+                return;
+            }
+            Offer.Window.store( Window / 2, std::memory_order_relaxed );
+        }
+        Inner.Add( InNode );
+    }
+
+    // chains are already one CAS on the inner head, they skip the slots
+    HAKLE_CPP14_CONSTEXPR void AddChain( Node* First ) noexcept { Inner.AddChain( First ); }
+
+    HAKLE_CPP14_CONSTEXPR Node* TryGet() noexcept {
+        if ( Node* Offered = TakeOffer( Slots[ NextRandom() % SLOT_COUNT ] ) ) {
+            return Offered;
+        }
+        if ( Node* Taken = Inner.TryGet() ) {
+            return Taken;
+        }
+        // an empty inner list may still have adds waiting on their offers
+        for ( Slot& Other : Slots ) {
+            if ( Node* Offered = TakeOffer( Other ) ) {
+                return Offered;
+            }
+        }
+        return nullptr;
+    }
+
+    // An offer on a random slot, then a chain from the inner list, then offers on the other slots while still short
+    HAKLE_CPP14_CONSTEXPR Node* TryGetChain( std::size_t MaxCount, std::size_t& Count ) noexcept {
+        Count = 0;
+        if HAKLE_UNLIKELY ( MaxCount == 0 ) {
+            return nullptr;
+        }
+
+        Node* ChainHead = TakeOffer( Slots[ NextRandom() % SLOT_COUNT ] );
+        if ( ChainHead != nullptr ) {
+            ++Count;
+        }
+        if ( Count < MaxCount ) {
+            std::size_t Got   = 0;
+            Node*       Chain = Inner.TryGetChain( MaxCount - Count, Got );
+            if ( ChainHead != nullptr ) {
+                ChainHead->FreeListNext.store( Chain, std::memory_order_relaxed );
+            }
+            else {
+                ChainHead = Chain;
+            }
+            Count += Got;
+        }
+        else {
+            ChainHead->FreeListNext.store( nullptr, std::memory_order_relaxed );
+        }
+        for ( std::size_t i = 0; i < SLOT_COUNT && Count < MaxCount; ++i ) {
+            if ( Node* Offered = TakeOffer( Slots[ i ] ) ) {
+                Offered->FreeListNext.store( ChainHead, std::memory_order_relaxed );
+                ChainHead = Offered;
+                ++Count;
+            }
+        }
+        return ChainHead;
+    }
+
+    // Counts up to Limit nodes in the inner list and the slots, only a hint while other threads take or add nodes
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t EstimateSize( std::size_t Limit ) const noexcept {
+        std::size_t Count = Inner.EstimateSize( Limit );
+        for ( const Slot& Current : Slots ) {
+            Count += Current.Parked.load( std::memory_order_relaxed ) != nullptr ? 1 : 0;
+        }
+        return std::min( Count, Limit );
+    }
+
+private:
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) Slot {
+        std::atomic<Node*> Parked{ nullptr };
+        // pauses an offer waits here, 0 while offers on this slot keep being withdrawn
+        std::atomic<std::uint32_t> Window{ 0 };
+    };
+
+    // xorshift per thread, threads spread over the slots instead of each sticking to one
+    static std::uint32_t NextRandom() noexcept {
+        // constant initialized, so reaching it costs no thread_local init guard
+        thread_local std::uint32_t State = 0;
+        if HAKLE_UNLIKELY ( State == 0 ) {
+            State = static_cast<std::uint32_t>( CurrentThreadIndex() ) * 2654435761u + 1;
+        }
+        State ^= State << 13;
+        State ^= State >> 17;
+        State ^= State << 5;
+        return State;
+    }
+
+    static HAKLE_CPP14_CONSTEXPR Node* TakeOffer( Slot& InSlot ) noexcept {
+        if ( InSlot.Parked.load( std::memory_order_relaxed ) == nullptr ) {
+            return nullptr;
+        }
+        return InSlot.Parked.exchange( nullptr, std::memory_order_acquire );
+    }
+
+    InnerListType Inner;
+    Slot          Slots[ SLOT_COUNT ];
+};
+
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>>
+class BlockPool {
+public:
+    using AllocatorType   = ALLOCATOR_TYPE;
+    using AllocatorTraits = HakeAllocatorTraits<AllocatorType>;
+
+    // Only allocates, a block is constructed when it is first handed out, so untouched pool pages are never committed
+    HAKLE_CPP14_CONSTEXPR explicit BlockPool( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{} ) : AllocatorPair{ InSize, InAllocator } {
+        if ( Size() > 0 ) {
+            Head = AllocatorTraits::Allocate( Allocator(), Size() );
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR ~BlockPool() { Clear(); }
+
+    HAKLE_CPP14_CONSTEXPR BlockPool( BlockPool&& Other ) noexcept : HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, AllocatorPair, Head ), HAKLE_MOVE_ATOMIC( Index ) { Other.Reset(); }
+
+    constexpr BlockPool& operator=( BlockPool&& Other ) noexcept {
+        if ( this != &Other ) {
+            Clear();
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, AllocatorPair, Head );
+            HAKLE_OP_MOVE_ATOMIC( Index );
+            Other.Reset();
+        }
+        return *this;
+    }
+
+    constexpr BlockPool( const BlockPool& Other )            = delete;
+    constexpr BlockPool& operator=( const BlockPool& Other ) = delete;
+
+    HAKLE_CPP14_CONSTEXPR void Clear() noexcept {
+        AllocatorTraits::Destroy( Allocator(), Head, std::min( Index.load( std::memory_order_relaxed ), Size() ) );
+        AllocatorTraits::Deallocate( Allocator(), Head, Size() );
+    }
+
+    HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
+        Size() = 0;
+        Head   = nullptr;
+        Index.store( 0, std::memory_order_relaxed );
+    }
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( BlockPool& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
+        HAKLE_SWAP_ATOMIC( Index );
+        using std::swap;
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, AllocatorPair, Head );
+    }
+#endif
+
+    // Hands the storage over to whoever keeps the blocks this pool handed out and starts over with new storage of the
+    // same size. Every block of the old storage is constructed, Count is set to how many it had not handed out yet,
+    // they sit at its end.
+    // NOTE: not thread safe
+    HAKLE_CPP20_CONSTEXPR BLOCK_TYPE* Renew( std::size_t& Count ) {
+        Count = 0;
+        if ( Head == nullptr ) {
+            return nullptr;
+        }
+
+        BLOCK_TYPE* NewHead = AllocatorTraits::Allocate( Allocator(), Size() );
+        BLOCK_TYPE* Old     = Head;
+        GetBlocks( Size(), Count );
+        Head = NewHead;
+        Index.store( 0, std::memory_order_relaxed );
+        return Old;
+    }
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetSize() const noexcept { return Size(); }
+    HAKLE_NODISCARD constexpr BLOCK_TYPE*              GetData() const noexcept { return Head; }
+    // blocks not handed out yet
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetRemaining() const noexcept { return Size() - std::min( Index.load( std::memory_order_relaxed ), Size() ); }
+
+    HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* GetBlock() {
+        if ( Index.load( std::memory_order_relaxed ) >= Size() )
+            return nullptr;
+
+        std::size_t CurrentIndex = Index.fetch_add( 1, std::memory_order_relaxed );
+        if ( CurrentIndex >= Size() )
+            return nullptr;
+
+        ConstructBlocks( Head + CurrentIndex, 1 );
+        return Head + CurrentIndex;
+    }
+
+    // Claims up to MaxCount contiguous blocks with one fetch_add, Count is set to the number actually claimed
+    HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* GetBlocks( std::size_t MaxCount, std::size_t& Count ) {
+        Count = 0;
+        if ( MaxCount == 0 || Index.load( std::memory_order_relaxed ) >= Size() )
+            return nullptr;
+
+        std::size_t CurrentIndex = Index.fetch_add( MaxCount, std::memory_order_relaxed );
+        if ( CurrentIndex >= Size() )
+            return nullptr;
+
+        Count = std::min( MaxCount, Size() - CurrentIndex );
+        ConstructBlocks( Head + CurrentIndex, Count );
+        return Head + CurrentIndex;
+    }
+
+private:
+    // the claiming thread owns the range, nobody else can see these blocks yet
+    HAKLE_CPP14_CONSTEXPR void ConstructBlocks( BLOCK_TYPE* First, std::size_t Count ) {
+        for ( std::size_t i = 0; i < Count; ++i ) {
+            AllocatorTraits::Construct( Allocator(), First + i );
+            First[ i ].HasOwner = true;
+        }
+    }
+
+    HAKLE_CPP14_CONSTEXPR AllocatorType& Allocator() noexcept { return AllocatorPair.Second(); }
+    constexpr const AllocatorType&       Allocator() const noexcept { return AllocatorPair.Second(); }
+    HAKLE_CPP14_CONSTEXPR std::size_t&           Size() noexcept { return AllocatorPair.First(); }
+    HAKLE_NODISCARD constexpr const std::size_t& Size() const noexcept { return AllocatorPair.First(); }
+
+    // compressed allocator
+    CompressPair<std::size_t, AllocatorType> AllocatorPair{};
+    BLOCK_TYPE*                              Head{ nullptr };
+    std::atomic<std::size_t>                 Index{ 0 };
+};
+
+// Storage a manager grows into once its pool is used up, allocated SlabSize blocks at a time.
+// Blocks are carved off the newest slab with one fetch_add and a used up slab is replaced with one CAS,
+// so taking blocks stays lock-free. Like the pool, a block is only constructed when it is carved.
+// Trim gives slabs whose blocks are all free back to the allocator while the slabs are in use: threads that may touch a
+// block they do not own (carving, walking the free list) hold a Guard, and a released slab is only freed once every
+// guard from before its release is gone.
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>>
+class BlockSlabs {
+public:
+    using AllocatorType   = ALLOCATOR_TYPE;
+    using AllocatorTraits = HakeAllocatorTraits<AllocatorType>;
+    using Guard           = EpochPins::Guard;
+
+    // a slab spans 16 pages of 4KiB, untouched pages of it are never committed
+    static constexpr std::size_t DefaultSlabBytes = 64 * 1024;
+    static constexpr std::size_t DefaultSlabSize  = DefaultSlabBytes / sizeof( BLOCK_TYPE ) > 0 ? DefaultSlabBytes / sizeof( BLOCK_TYPE ) : 1;
+
+    HAKLE_CPP14_CONSTEXPR explicit BlockSlabs( std::size_t InSlabSize = DefaultSlabSize, const AllocatorType& InAllocator = AllocatorType{} )
+        : AllocatorPair{ std::max<std::size_t>( InSlabSize, 1 ), InAllocator } {}
+
+    HAKLE_CPP20_CONSTEXPR ~BlockSlabs() { Clear(); }
+
+    HAKLE_CPP14_CONSTEXPR BlockSlabs( BlockSlabs&& Other ) noexcept
+        : HAKLE_MOVE( AllocatorPair ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_ATOMIC, Newest, BlockCount, BlockLimit, PeakBlockCount, GrowCount, RefuseCount, TrimBatchBlocks ),
+          HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, Pins, Retired, RetiredCount ) {
+        Other.Reset();
+    }
+
+    HAKLE_CPP14_CONSTEXPR BlockSlabs& operator=( BlockSlabs&& Other ) noexcept {
+        if ( this != &Other ) {
+            Clear();
+            HAKLE_OP_MOVE( AllocatorPair );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, Newest, BlockCount, BlockLimit, PeakBlockCount, GrowCount, RefuseCount, TrimBatchBlocks );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, Pins, Retired, RetiredCount );
+            Other.Reset();
+        }
+        return *this;
+    }
+
+    BlockSlabs( const BlockSlabs& Other )            = delete;
+    BlockSlabs& operator=( const BlockSlabs& Other ) = delete;
+
+    HAKLE_CPP14_CONSTEXPR void Clear() noexcept {
+        DeleteSlabs( Newest.load( std::memory_order_relaxed ) );
+        DeleteSlabs( Retired );
+        Newest.store( nullptr, std::memory_order_relaxed );
+        BlockCount.store( 0, std::memory_order_relaxed );
+        Retired      = nullptr;
+        RetiredCount = 0;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
+        Retired      = nullptr;
+        RetiredCount = 0;
+        Newest.store( nullptr, std::memory_order_relaxed );
+        BlockCount.store( 0, std::memory_order_relaxed );
+        BlockLimit.store( NoLimit, std::memory_order_relaxed );
+        PeakBlockCount.store( 0, std::memory_order_relaxed );
+        GrowCount.store( 0, std::memory_order_relaxed );
+        RefuseCount.store( 0, std::memory_order_relaxed );
+        TrimBatchBlocks.store( 0, std::memory_order_relaxed );
+    }
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( BlockSlabs& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
+        HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, Newest, BlockCount, BlockLimit, PeakBlockCount, GrowCount, RefuseCount, TrimBatchBlocks );
+        Pins.swap( Other.Pins );
+        using std::swap;
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, AllocatorPair, Retired, RetiredCount );
+    }
+#endif
+
+    static constexpr std::size_t NoLimit = static_cast<std::size_t>( -1 );
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetSlabSize() const noexcept { return SlabSize(); }
+    // what a Guard pins, hold one while carving blocks or walking a free list that may hold slab blocks
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR EpochPins& GetPins() noexcept { return Pins; }
+    // The trimming thread brackets each batch of free blocks it has off the free lists with these, so a requisition
+    // that finds no free block can tell it is only out for a moment. Begin before taking, end after handing back.
+    HAKLE_CPP14_CONSTEXPR void BeginTrimBatch( std::size_t Count ) noexcept { TrimBatchBlocks.fetch_add( Count, std::memory_order_seq_cst ); }
+    HAKLE_CPP14_CONSTEXPR void EndTrimBatch( std::size_t Count ) noexcept { TrimBatchBlocks.fetch_sub( Count, std::memory_order_seq_cst ); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR bool HasTrimBatch() const noexcept { return TrimBatchBlocks.load( std::memory_order_seq_cst ) != 0; }
+    // bytes of block storage currently held in slabs, released slabs count until they are freed
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetBytes() const noexcept { return BlockCount.load( std::memory_order_relaxed ) * sizeof( BLOCK_TYPE ); }
+    // bytes of slabs Trim released that a guard may still reach, trimming thread only
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetReleasedBytes() const noexcept { return RetiredCount * sizeof( BLOCK_TYPE ); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetPeakBytes() const noexcept { return PeakBlockCount.load( std::memory_order_relaxed ) * sizeof( BLOCK_TYPE ); }
+    // slabs allocated so far, and growths refused because of the block limit
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetGrowCount() const noexcept { return GrowCount.load( std::memory_order_relaxed ); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetRefuseCount() const noexcept { return RefuseCount.load( std::memory_order_relaxed ); }
+
+    // Most blocks the slabs may hold together, the last slab is cut short to fit. Slabs already held are kept.
+    HAKLE_CPP14_CONSTEXPR void SetBlockLimit( std::size_t InLimit ) noexcept { BlockLimit.store( InLimit, std::memory_order_relaxed ); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetBlockLimit() const noexcept { return BlockLimit.load( std::memory_order_relaxed ); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR bool        HasRoom() const noexcept { return BlockCount.load( std::memory_order_relaxed ) < BlockLimit.load( std::memory_order_relaxed ); }
+
+    // Claims up to MaxCount contiguous blocks from the newest slab, Count is set to the number actually claimed.
+    // When the newest slab is used up a new one is allocated if CanGrow, otherwise nothing is returned.
+    HAKLE_CPP20_CONSTEXPR BLOCK_TYPE* GetBlocks( std::size_t MaxCount, std::size_t& Count, bool CanGrow ) {
+        Count = 0;
+        if HAKLE_UNLIKELY ( MaxCount == 0 ) {
+            return nullptr;
+        }
+
+        Slab* Current = Newest.load( std::memory_order_acquire );
+        while ( true ) {
+            if ( Current != nullptr && Current->Index.load( std::memory_order_relaxed ) < Current->Size ) {
+                std::size_t CurrentIndex = Current->Index.fetch_add( MaxCount, std::memory_order_relaxed );
+                if ( CurrentIndex < Current->Size ) {
+                    Count = std::min( MaxCount, Current->Size - CurrentIndex );
+                    ConstructBlocks( Current->Blocks + CurrentIndex, Count );
+                    return Current->Blocks + CurrentIndex;
+                }
+            }
+
+            Slab* Latest = Newest.load( std::memory_order_acquire );
+            if ( Latest != Current ) {
+                Current = Latest;
+                continue;
+            }
+            if ( !CanGrow ) {
+                return nullptr;
+            }
+
+            std::size_t NewSize = ReserveBlocks();
+            if ( NewSize == 0 ) {
+                RefuseCount.fetch_add( 1, std::memory_order_relaxed );
+                return nullptr;
+            }
+
+            // the creator claims its blocks before the slab is published, a slab that loses the race is freed again
+            Slab* NewSlab = nullptr;
+            HAKLE_TRY { NewSlab = CreateSlab( NewSize ); }
+            HAKLE_CATCH( ... ) {
+                BlockCount.fetch_sub( NewSize, std::memory_order_relaxed );
+                HAKLE_RETHROW;
+            }
+            Count = std::min( MaxCount, NewSize );
+            NewSlab->Index.store( Count, std::memory_order_relaxed );
+            ConstructBlocks( NewSlab->Blocks, Count );
+            NewSlab->Next = Current;
+            if ( Newest.compare_exchange_strong( Current, NewSlab, std::memory_order_release, std::memory_order_acquire ) ) {
+                GrowCount.fetch_add( 1, std::memory_order_relaxed );
+                return NewSlab->Blocks;
+            }
+            DeleteSlab( NewSlab );
+            BlockCount.fetch_sub( NewSize, std::memory_order_relaxed );
+            Count = 0;
+        }
+    }
+
+    // Trim releases slabs whose blocks are all free until at most TargetBytes are held. It runs in steps so the caller
+    // never has to hold more than a batch of free blocks that may stay:
+    //   BeginTrim, then CountBlocks on every free block, PickReleasable, Collect on every free block again, EndTrim.
+    // CountBlocks may see a block twice, it only picks the candidates. Collect keeps the blocks of candidate slabs and
+    // hands back the rest at once, a slab is released only if Collect kept every block carved from it.
+    // Safe next to GetBlocks and guarded readers: older slabs are used up, and the newest one is sealed with a CAS on its
+    // index before it is released, so nothing carves from a released slab. A released slab is freed once no guard from
+    // before its release is left, which may be in a later call.
+    // NOTE: only one thread may trim at a time, between BeginTrim and EndTrim the other steps are the trimming thread's
+
+    // Returns false when there is nothing to release, EndTrim must still be called
+    HAKLE_CPP20_CONSTEXPR bool BeginTrim( std::size_t TargetBytes ) noexcept {
+        TrimFirst  = Newest.load( std::memory_order_acquire );
+        TrimTarget = TargetBytes;
+        if ( TrimFirst == nullptr || GetBytes() - GetReleasedBytes() <= TargetBytes ) {
+            TrimFirst = nullptr;
+            return false;
+        }
+
+        // Only Trim follows the links behind the newest slab, so they can be sorted by address in place
+        TrimSlabs = SortChain( TrimFirst, []( Slab* InSlab ) noexcept { return InSlab->Blocks; } );
+        for ( Slab* Current = TrimSlabs; Current != nullptr; Current = Current->Next ) {
+            Current->FreeCount = 0;
+            Current->Collected = 0;
+            Current->Candidate = false;
+        }
+        return true;
+    }
+
+    // Counts a chain of free blocks linked through FreeListNext against their slabs, returns it sorted by address
+    HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* CountBlocks( BLOCK_TYPE* FreeBlocks ) noexcept {
+        BLOCK_TYPE* Sorted = SortFree( FreeBlocks );
+        ForEachSlabOf( Sorted, TrimSlabs, []( BLOCK_TYPE* Block, Slab* Owner ) noexcept {
+            Block->FreeListNext.store( Block->Next, std::memory_order_relaxed );
+            if ( Owner != nullptr ) {
+                ++Owner->FreeCount;
+            }
+        } );
+        return Sorted;
+    }
+
+    // Slabs that looked all free while counting become candidates, in address order, until TargetBytes would be reached
+    HAKLE_CPP14_CONSTEXPR void PickReleasable() noexcept {
+        std::size_t Held = GetBytes() - GetReleasedBytes();
+        for ( Slab* Current = TrimSlabs; Current != nullptr && Held > TrimTarget; Current = Current->Next ) {
+            if ( Current->FreeCount >= std::min( Current->Index.load( std::memory_order_relaxed ), Current->Size ) ) {
+                Current->Candidate = true;
+                Held -= Current->Size * sizeof( BLOCK_TYPE );
+            }
+        }
+    }
+
+    // Keeps the blocks of candidate slabs and returns the others, again linked through FreeListNext
+    HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* Collect( BLOCK_TYPE* FreeBlocks ) noexcept {
+        BLOCK_TYPE* Others = nullptr;
+        ForEachSlabOf( SortFree( FreeBlocks ), TrimSlabs, [ this, &Others ]( BLOCK_TYPE* Block, Slab* Owner ) noexcept {
+            if ( Owner != nullptr && Owner->Candidate ) {
+                ++Owner->Collected;
+                Block->FreeListNext.store( Kept, std::memory_order_relaxed );
+                Kept = Block;
+            }
+            else {
+                Block->FreeListNext.store( Others, std::memory_order_relaxed );
+                Others = Block;
+            }
+        } );
+        return Others;
+    }
+
+    // Releases the candidate slabs Collect got every block of, returns the bytes freed. Blocks Collect kept from slabs
+    // that stay are handed back in FreeBlocks, linked through FreeListNext.
+    HAKLE_CPP20_CONSTEXPR std::size_t EndTrim( BLOCK_TYPE*& FreeBlocks ) noexcept {
+        FreeBlocks = nullptr;
+        Slab* First = TrimFirst;
+        if ( First == nullptr ) {
+            return FreeRetired();
+        }
+
+        // a slab can go once nothing carved from it is still handed out
+        for ( Slab* Current = TrimSlabs; Current != nullptr; Current = Current->Next ) {
+            if ( !Current->Candidate ) {
+                continue;
+            }
+            Current->Candidate = false;
+            std::size_t Index  = Current->Index.load( std::memory_order_relaxed );
+            if ( Current->Collected != std::min( Index, Current->Size ) ) {
+                continue;
+            }
+            // the newest slab may still be carved from, the CAS fails if that happened since the count
+            if ( Index < Current->Size && !Current->Index.compare_exchange_strong( Index, Index + Current->Size, std::memory_order_relaxed, std::memory_order_relaxed ) ) {
+                continue;
+            }
+            Current->Carved    = std::min( Index, Current->Size );
+            Current->FreeCount = ReleaseMark;
+        }
+
+        // hand back the kept blocks of slabs that stay, then unlink the released slabs
+        ForEachSlabOf( SortFree( Kept ), TrimSlabs, [ &FreeBlocks ]( BLOCK_TYPE* Block, Slab* Owner ) noexcept {
+            if ( Owner->FreeCount != ReleaseMark ) {
+                Block->FreeListNext.store( FreeBlocks, std::memory_order_relaxed );
+                FreeBlocks = Block;
+            }
+        } );
+        Kept = nullptr;
+
+        Slab*  Slabs    = TrimSlabs;
+        Slab*  Remain   = nullptr;
+        Slab** Link     = &Remain;
+        Slab*  Released = nullptr;
+        while ( Slabs != nullptr ) {
+            Slab* Next = Slabs->Next;
+            if ( Slabs->FreeCount == ReleaseMark ) {
+                Slabs->Next = Released;
+                Released    = Slabs;
+            }
+            else if ( Slabs != First ) {
+                *Link = Slabs;
+                Link  = &Slabs->Next;
+            }
+            Slabs = Next;
+        }
+        *Link     = nullptr;
+        TrimSlabs = nullptr;
+        TrimFirst = nullptr;
+
+        if ( First->FreeCount != ReleaseMark ) {
+            First->Next = Remain;
+        }
+        else {
+            // slabs published meanwhile sit in front of the released one, their links are set before they are published
+            Slab* Expected = First;
+            if ( !Newest.compare_exchange_strong( Expected, Remain, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+                while ( Expected->Next != First ) {
+                    Expected = Expected->Next;
+                }
+                Expected->Next = Remain;
+            }
+        }
+
+        // Collect took every block of these slabs off the free lists, so a guard taken from now on cannot reach them
+        std::uint64_t Epoch = Pins.GetEpoch();
+        while ( Released != nullptr ) {
+            Slab* Next            = Released->Next;
+            Released->RetireEpoch = Epoch;
+            Released->Next        = Retired;
+            Retired               = Released;
+            RetiredCount += Released->Size;
+            Released = Next;
+        }
+        return FreeRetired();
+    }
+
+    // Takes over the slabs of Other that back blocks it handed out, slabs whose blocks are all free stay with Other.
+    // FreeBlocks holds Other's free blocks linked through FreeListNext, the ones of slabs that stay are left in it.
+    // Returns the free blocks of the slabs taken over, Other's newest slab carved to the end if it is one of them,
+    // linked through FreeListNext.
+    // NOTE: not thread safe
+    HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* Adopt( BlockSlabs& Other, BLOCK_TYPE*& FreeBlocks ) noexcept {
+        Slab* OtherFirst = Other.Newest.load( std::memory_order_relaxed );
+        if ( this == &Other || OtherFirst == nullptr ) {
+            return nullptr;
+        }
+
+        Slab*       Slabs  = SortChain( OtherFirst, []( Slab* InSlab ) noexcept { return InSlab->Blocks; } );
+        BLOCK_TYPE* Sorted = SortFree( FreeBlocks );
+        for ( Slab* Current = Slabs; Current != nullptr; Current = Current->Next ) {
+            Current->FreeCount = 0;
+        }
+        ForEachSlabOf( Sorted, Slabs, []( BLOCK_TYPE*, Slab* Owner ) noexcept {
+            if ( Owner != nullptr ) {
+                ++Owner->FreeCount;
+            }
+        } );
+        // a slab moves once one of its carved blocks is not free, FreeCount marks the ones that move
+        for ( Slab* Current = Slabs; Current != nullptr; Current = Current->Next ) {
+            Current->FreeCount = Current->FreeCount < std::min( Current->Index.load( std::memory_order_relaxed ), Current->Size ) ? ReleaseMark : 0;
+        }
+
+        BLOCK_TYPE* Moved = nullptr;
+        FreeBlocks        = nullptr;
+        ForEachSlabOf( Sorted, Slabs, [ &Moved, &FreeBlocks ]( BLOCK_TYPE* Block, Slab* Owner ) noexcept {
+            BLOCK_TYPE*& To = Owner != nullptr && Owner->FreeCount == ReleaseMark ? Moved : FreeBlocks;
+            Block->FreeListNext.store( To, std::memory_order_relaxed );
+            To = Block;
+        } );
+        bool FirstMoves = OtherFirst->FreeCount == ReleaseMark;
+        if ( FirstMoves ) {
+            std::size_t Count     = 0;
+            BLOCK_TYPE* Remaining = Other.GetBlocks( OtherFirst->Size, Count, false );
+            for ( std::size_t i = 0; i < Count; ++i ) {
+                Remaining[ i ].FreeListNext.store( Moved, std::memory_order_relaxed );
+                Moved = Remaining + i;
+            }
+        }
+
+        // the slabs that move go behind our newest slab, which may still have blocks to carve; Other keeps its newest
+        // slab in front if it stays
+        Slab*       Stay      = nullptr;
+        Slab*       MoveFirst = nullptr;
+        Slab*       MoveLast  = nullptr;
+        std::size_t MoveCount = 0;
+        while ( Slabs != nullptr ) {
+            Slab* Next       = Slabs->Next;
+            bool  Move       = Slabs->FreeCount == ReleaseMark;
+            Slabs->FreeCount = 0;
+            if ( Move ) {
+                Slabs->Next = MoveFirst;
+                MoveFirst   = Slabs;
+                MoveLast    = MoveLast != nullptr ? MoveLast : Slabs;
+                MoveCount += Slabs->Size;
+            }
+            else if ( Slabs != OtherFirst ) {
+                Slabs->Next = Stay;
+                Stay        = Slabs;
+            }
+            Slabs = Next;
+        }
+        if ( !FirstMoves ) {
+            OtherFirst->Next = Stay;
+            Stay             = OtherFirst;
+        }
+        Other.Newest.store( Stay, std::memory_order_relaxed );
+        Other.BlockCount.fetch_sub( MoveCount, std::memory_order_relaxed );
+        if ( MoveFirst != nullptr ) {
+            LinkAdopted( MoveFirst, MoveLast, MoveCount );
+        }
+        return Moved;
+    }
+
+    // Keeps the storage Pool hands over when it renews, as a slab that is freed like one. Returns the blocks Pool had
+    // not handed out yet, linked through FreeListNext.
+    // NOTE: not thread safe
+    HAKLE_CPP20_CONSTEXPR BLOCK_TYPE* AdoptPool( BlockPool<BLOCK_TYPE, AllocatorType>& Pool ) {
+        std::size_t Size = Pool.GetSize();
+        if ( Size == 0 ) {
+            return nullptr;
+        }
+
+        SlabAllocatorType SlabAllocator( Allocator() );
+        Slab*             NewSlab = SlabAllocatorTraits::Allocate( SlabAllocator );
+        std::size_t       Count   = 0;
+        BLOCK_TYPE*       Blocks  = nullptr;
+        HAKLE_TRY { Blocks = Pool.Renew( Count ); }
+        HAKLE_CATCH( ... ) {
+            SlabAllocatorTraits::Deallocate( SlabAllocator, NewSlab );
+            HAKLE_RETHROW;
+        }
+        SlabAllocatorTraits::Construct( SlabAllocator, NewSlab );
+        NewSlab->Blocks = Blocks;
+        NewSlab->Size   = Size;
+        NewSlab->Index.store( Size, std::memory_order_relaxed );
+        LinkAdopted( NewSlab, NewSlab, Size );
+
+        BLOCK_TYPE* Remaining = nullptr;
+        for ( std::size_t i = Size - Count; i < Size; ++i ) {
+            Blocks[ i ].FreeListNext.store( Remaining, std::memory_order_relaxed );
+            Remaining = Blocks + i;
+        }
+        return Remaining;
+    }
+
+private:
+    struct Slab {
+        Slab*                    Next{ nullptr };
+        BLOCK_TYPE*              Blocks{ nullptr };
+        std::size_t              Size{ 0 };
+        std::atomic<std::size_t> Index{ 0 };
+        // only used by Trim, Carved is set when it seals the slab against carving
+        std::size_t   FreeCount{ 0 };
+        std::size_t   Collected{ 0 };
+        bool          Candidate{ false };
+        std::size_t   Carved{ ReleaseMark };
+        std::uint64_t RetireEpoch{ 0 };
+    };
+
+    static constexpr std::size_t ReleaseMark = static_cast<std::size_t>( -1 );
+
+    // Takes room for the next slab out of the block limit before it is allocated, returns its size or 0 when over the limit
+    HAKLE_CPP14_CONSTEXPR std::size_t ReserveBlocks() noexcept {
+        std::size_t Current = BlockCount.load( std::memory_order_relaxed );
+        std::size_t NewSize = 0;
+        do {
+            std::size_t Limit = BlockLimit.load( std::memory_order_relaxed );
+            if ( Current >= Limit ) {
+                return 0;
+            }
+            NewSize = std::min( SlabSize(), Limit - Current );
+        } while ( !BlockCount.compare_exchange_weak( Current, Current + NewSize, std::memory_order_relaxed, std::memory_order_relaxed ) );
+
+        UpdatePeak( Current + NewSize );
+        return NewSize;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void UpdatePeak( std::size_t InCount ) noexcept {
+        std::size_t Peak = PeakBlockCount.load( std::memory_order_relaxed );
+        while ( Peak < InCount && !PeakBlockCount.compare_exchange_weak( Peak, InCount, std::memory_order_relaxed, std::memory_order_relaxed ) ) {
+        }
+    }
+
+    // links a chain of slabs taken over from elsewhere behind the newest slab
+    HAKLE_CPP14_CONSTEXPR void LinkAdopted( Slab* First, Slab* Last, std::size_t Count ) noexcept {
+        Slab* Front = Newest.load( std::memory_order_relaxed );
+        if ( Front == nullptr ) {
+            Last->Next = nullptr;
+            Newest.store( First, std::memory_order_relaxed );
+        }
+        else {
+            Last->Next  = Front->Next;
+            Front->Next = First;
+        }
+        UpdatePeak( BlockCount.fetch_add( Count, std::memory_order_relaxed ) + Count );
+    }
+
+    using SlabAllocatorType   = typename AllocatorTraits::template RebindAlloc<Slab>;
+    using SlabAllocatorTraits = typename AllocatorTraits::template RebindTraits<Slab>;
+
+    // Frees the released slabs no guard can reach anymore, returns their bytes. Advancing twice lets an idle
+    // manager free a slab in the same Trim call that released it.
+    HAKLE_CPP20_CONSTEXPR std::size_t FreeRetired() noexcept {
+        if ( Retired == nullptr ) {
+            return 0;
+        }
+        Pins.TryAdvance();
+        std::uint64_t Epoch = Pins.TryAdvance();
+
+        std::size_t Freed = 0;
+        Slab**      Link  = &Retired;
+        while ( *Link != nullptr ) {
+            Slab* Current = *Link;
+            if ( EpochPins::CanFree( Current->RetireEpoch, Epoch ) ) {
+                *Link = Current->Next;
+                Freed += Current->Size * sizeof( BLOCK_TYPE );
+                RetiredCount -= Current->Size;
+                BlockCount.fetch_sub( Current->Size, std::memory_order_relaxed );
+                DeleteSlab( Current );
+            }
+            else {
+                Link = &Current->Next;
+            }
+        }
+        return Freed;
+    }
+
+    // the claiming thread owns the range, nobody else can see these blocks yet
+    HAKLE_CPP14_CONSTEXPR void ConstructBlocks( BLOCK_TYPE* First, std::size_t Count ) {
+        for ( std::size_t i = 0; i < Count; ++i ) {
+            AllocatorTraits::Construct( Allocator(), First + i );
+            First[ i ].HasOwner = true;
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR Slab* CreateSlab( std::size_t InSize ) {
+        SlabAllocatorType SlabAllocator( Allocator() );
+        BLOCK_TYPE*       Blocks  = AllocatorTraits::Allocate( Allocator(), InSize );
+        Slab*             NewSlab = nullptr;
+        HAKLE_TRY { NewSlab = SlabAllocatorTraits::Allocate( SlabAllocator ); }
+        HAKLE_CATCH( ... ) {
+            AllocatorTraits::Deallocate( Allocator(), Blocks, InSize );
+            HAKLE_RETHROW;
+        }
+        SlabAllocatorTraits::Construct( SlabAllocator, NewSlab );
+        NewSlab->Blocks = Blocks;
+        NewSlab->Size   = InSize;
+        return NewSlab;
+    }
+
+    // only the carved blocks were constructed
+    HAKLE_CPP20_CONSTEXPR void DeleteSlab( Slab* InSlab ) noexcept {
+        std::size_t Carved = InSlab->Carved != ReleaseMark ? InSlab->Carved : std::min( InSlab->Index.load( std::memory_order_relaxed ), InSlab->Size );
+        AllocatorTraits::Destroy( Allocator(), InSlab->Blocks, Carved );
+        AllocatorTraits::Deallocate( Allocator(), InSlab->Blocks, InSlab->Size );
+        SlabAllocatorType SlabAllocator( Allocator() );
+        SlabAllocatorTraits::Destroy( SlabAllocator, InSlab );
+        SlabAllocatorTraits::Deallocate( SlabAllocator, InSlab );
+    }
+
+    HAKLE_CPP20_CONSTEXPR void DeleteSlabs( Slab* Current ) noexcept {
+        while ( Current != nullptr ) {
+            Slab* Next = Current->Next;
+            DeleteSlab( Current );
+            Current = Next;
+        }
+    }
+
+    // Merge sort of a chain linked through Next by the address KeyOf gives, so it needs no memory
+    template <class Node, class KeyOfType>
+    static HAKLE_CPP14_CONSTEXPR Node* SortChain( Node* First, KeyOfType KeyOf ) noexcept {
+        if ( First == nullptr || First->Next == nullptr ) {
+            return First;
+        }
+
+        Node* Slow = First;
+        Node* Fast = First->Next;
+        while ( Fast != nullptr && Fast->Next != nullptr ) {
+            Slow = Slow->Next;
+            Fast = Fast->Next->Next;
+        }
+        Node* Second = Slow->Next;
+        Slow->Next   = nullptr;
+        First        = SortChain( First, KeyOf );
+        Second       = SortChain( Second, KeyOf );
+
+        Node*  Result = nullptr;
+        Node** Link   = &Result;
+        while ( First != nullptr && Second != nullptr ) {
+            Node*& Smaller = std::less<>{}( KeyOf( Second ), KeyOf( First ) ) ? Second : First;
+            *Link          = Smaller;
+            Link           = &Smaller->Next;
+            Smaller        = Smaller->Next;
+        }
+        *Link = First != nullptr ? First : Second;
+        return Result;
+    }
+
+    // Relinks a chain of free blocks from FreeListNext to Next and sorts it by address, Trim owns these blocks
+    static HAKLE_CPP14_CONSTEXPR BLOCK_TYPE* SortFree( BLOCK_TYPE* FreeBlocks ) noexcept {
+        for ( BLOCK_TYPE* Block = FreeBlocks; Block != nullptr; Block = Block->Next ) {
+            Block->Next = Block->FreeListNext.load( std::memory_order_relaxed );
+        }
+        return SortChain( FreeBlocks, []( BLOCK_TYPE* Block ) noexcept { return Block; } );
+    }
+
+    // Calls Func( Block, Owner ) for every block of a sorted chain, Owner is the slab it belongs to or null
+    template <class FuncType>
+    static HAKLE_CPP14_CONSTEXPR void ForEachSlabOf( BLOCK_TYPE* Blocks, Slab* Slabs, FuncType Func ) noexcept {
+        std::less<> Less;
+        while ( Blocks != nullptr ) {
+            BLOCK_TYPE* Next = Blocks->Next;
+            while ( Slabs != nullptr && !Less( Blocks, Slabs->Blocks + Slabs->Size ) ) {
+                Slabs = Slabs->Next;
+            }
+            Func( Blocks, Slabs != nullptr && !Less( Blocks, Slabs->Blocks ) ? Slabs : nullptr );
+            Blocks = Next;
+        }
+    }
+
+    HAKLE_CPP14_CONSTEXPR AllocatorType& Allocator() noexcept { return AllocatorPair.Second(); }
+    constexpr const AllocatorType&       Allocator() const noexcept { return AllocatorPair.Second(); }
+    HAKLE_CPP14_CONSTEXPR std::size_t&           SlabSize() noexcept { return AllocatorPair.First(); }
+    HAKLE_NODISCARD constexpr const std::size_t& SlabSize() const noexcept { return AllocatorPair.First(); }
+
+    // compressed allocator
+    CompressPair<std::size_t, AllocatorType> AllocatorPair{};
+    // newest slab first, the only one blocks are carved from
+    std::atomic<Slab*> Newest{ nullptr };
+    // blocks in slabs, including the ones of slabs that are being allocated
+    std::atomic<std::size_t> BlockCount{ 0 };
+    std::atomic<std::size_t> BlockLimit{ NoLimit };
+    std::atomic<std::size_t> PeakBlockCount{ 0 };
+    std::atomic<std::size_t> GrowCount{ 0 };
+    std::atomic<std::size_t> RefuseCount{ 0 };
+    std::atomic<std::size_t> TrimBatchBlocks{ 0 };
+    EpochPins                Pins;
+    // slabs Trim released that a guard may still reach, and their blocks; only touched by the trimming thread
+    Slab*       Retired{ nullptr };
+    std::size_t RetiredCount{ 0 };
+    // state of the Trim in progress: the newest slab when it began, all slabs sorted by address and the kept blocks
+    Slab*       TrimFirst{ nullptr };
+    Slab*       TrimSlabs{ nullptr };
+    BLOCK_TYPE* Kept{ nullptr };
+    std::size_t TrimTarget{ 0 };
+};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasRequisitionBlocks : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasRequisitionBlocks<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<BLOCK_MANAGER_TYPE&>().RequisitionBlocks( std::size_t{}, AllocMode{} ) )>> : std::true_type {};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasMemoryBudget : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasMemoryBudget<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<BLOCK_MANAGER_TYPE&>().SetMemoryBudget( std::size_t{}, BudgetPolicy{} ) )>> : std::true_type {};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasTrim : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasTrim<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<BLOCK_MANAGER_TYPE&>().Trim( std::size_t{} ) )>> : std::true_type {};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasMaintain : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasMaintain<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<BLOCK_MANAGER_TYPE&>().Maintain( std::size_t{}, std::size_t{} ) )>> : std::true_type {};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasReserve : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasReserve<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<BLOCK_MANAGER_TYPE&>().Reserve( std::size_t{} ) )>> : std::true_type {};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasMemoryStats : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasMemoryStats<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<const BLOCK_MANAGER_TYPE&>().GetMemoryStats() )>> : std::true_type {};
+
+template <class BLOCK_MANAGER_TYPE, class = void>
+struct HasAdoptBlocks : std::false_type {};
+
+template <class BLOCK_MANAGER_TYPE>
+struct HasAdoptBlocks<BLOCK_MANAGER_TYPE, std::void_t<decltype( std::declval<BLOCK_MANAGER_TYPE&>().AdoptBlocks( std::declval<BLOCK_MANAGER_TYPE&>() ) )>> : std::true_type {};
+
+// Manager.AdoptBlocks( Other ), managers whose AdoptBlocks returns bool may refuse and must then leave both untouched
+template <class BLOCK_MANAGER_TYPE>
+inline HAKLE_CPP20_CONSTEXPR bool AdoptBlocks( BLOCK_MANAGER_TYPE& Manager, BLOCK_MANAGER_TYPE& Other ) {
+    HAKLE_CONSTEXPR_IF( std::is_same<decltype( Manager.AdoptBlocks( Other ) ), bool>::value ) { return Manager.AdoptBlocks( Other ); }
+    else {
+        Manager.AdoptBlocks( Other );
+        return true;
+    }
+}
+
+// Fallback for managers that only hand out single blocks
+template <class BLOCK_MANAGER_TYPE>
+inline HAKLE_CPP20_CONSTEXPR typename BLOCK_MANAGER_TYPE::BlockType* RequisitionBlocksOneByOne( BLOCK_MANAGER_TYPE& Manager, std::size_t Count, AllocMode Mode ) {
+    using BlockType = typename BLOCK_MANAGER_TYPE::BlockType;
+
+    BlockType* First = nullptr;
+    BlockType* Last  = nullptr;
+    HAKLE_TRY {
+        for ( ; Count > 0; --Count ) {
+            BlockType* Block = Manager.RequisitionBlock( Mode );
+            if ( Block == nullptr ) {
+                break;
+            }
+            if ( Last == nullptr ) {
+                First = Block;
+            }
+            else {
+                Last->Next = Block;
+            }
+            Last = Block;
+        }
+    }
+    HAKLE_CATCH( ... ) {
+        if ( Last != nullptr ) {
+            Last->Next = nullptr;
+            Manager.ReturnBlocks( First );
+        }
+        HAKLE_RETHROW;
+    }
+
+    if ( Last != nullptr ) {
+        Last->Next = nullptr;
+    }
+    return First;
+}
+
+// Requisitions Count blocks linked through Next, using the manager's batched path when it has one
+template <HAKLE_CONCEPT( IsBlockManager ) BLOCK_MANAGER_TYPE>
+inline HAKLE_CPP20_CONSTEXPR typename BLOCK_MANAGER_TYPE::BlockType* RequisitionBlocks( BLOCK_MANAGER_TYPE& Manager, std::size_t Count, AllocMode Mode ) {
+    HAKLE_CONSTEXPR_IF( HasRequisitionBlocks<BLOCK_MANAGER_TYPE>::value ) { return Manager.RequisitionBlocks( Count, Mode ); }
+    else {
+        return RequisitionBlocksOneByOne( Manager, Count, Mode );
+    }
+}
+
+// Fallback for managers without a Reserve: Count blocks are requisitioned and handed straight back
+template <class BLOCK_MANAGER_TYPE>
+inline HAKLE_CPP20_CONSTEXPR bool ReserveBlocksOneByOne( BLOCK_MANAGER_TYPE& Manager, std::size_t Count ) {
+    using BlockType = typename BLOCK_MANAGER_TYPE::BlockType;
+
+    BlockType* First  = nullptr;
+    bool       Result = true;
+    HAKLE_TRY {
+        for ( std::size_t i = 0; i < Count; ++i ) {
+            BlockType* Block = Manager.RequisitionBlock( AllocMode::CanAlloc );
+            if HAKLE_UNLIKELY ( Block == nullptr ) {
+                Result = false;
+                break;
+            }
+            Block->Next = First;
+            First       = Block;
+        }
+    }
+    HAKLE_CATCH( ... ) {
+        if ( First != nullptr ) {
+            Manager.ReturnBlocks( First );
+        }
+        HAKLE_RETHROW;
+    }
+
+    if ( First != nullptr ) {
+        Manager.ReturnBlocks( First );
+    }
+    return Result;
+}
+
+// Makes sure the next Count requisitions do not allocate, the blocks end up in whatever free storage the manager uses.
+// Managers with a Reserve grow their storage without taking blocks and refuse instead of waiting on a budget.
+template <HAKLE_CONCEPT( IsBlockManager ) BLOCK_MANAGER_TYPE>
+inline HAKLE_CPP20_CONSTEXPR bool ReserveBlocks( BLOCK_MANAGER_TYPE& Manager, std::size_t Count ) {
+    HAKLE_CONSTEXPR_IF( HasReserve<BLOCK_MANAGER_TYPE>::value ) { return Manager.Reserve( Count ); }
+    else {
+        return ReserveBlocksOneByOne( Manager, Count );
+    }
+}
+
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE>
+class BlockManagerBase : private CompressPairElem<ALLOCATOR_TYPE, 0> {
+public:
+    using AllocatorType        = ALLOCATOR_TYPE;
+    using BlockAllocatorTraits = HakeAllocatorTraits<AllocatorType>;
+    using BlockType            = BLOCK_TYPE;
+#ifdef HAKLE_USE_CONCEPT
+    constexpr static std::size_t BlockSize = BlockType::BlockSize;
+    using ValueType                        = typename BlockType::ValueType;
+#else
+    using BlockTraits                      = BlockTraits<BlockType>;
+    constexpr static std::size_t BlockSize = BlockTraits::BlockSize;
+    using ValueType                        = typename BlockTraits::ValueType;
+#endif
+
+    constexpr BlockManagerBase() = default;
+    constexpr explicit BlockManagerBase( const AllocatorType& InAllocator = AllocatorType{} ) : Base( InAllocator ) {}
+    HAKLE_CPP14_CONSTEXPR ~BlockManagerBase() = default;
+
+    HAKLE_CPP14_CONSTEXPR                   BlockManagerBase( BlockManagerBase&& Other ) noexcept = default;
+    HAKLE_CPP14_CONSTEXPR BlockManagerBase& operator=( BlockManagerBase&& Other ) noexcept        = default;
+
+    HAKLE_CPP14_CONSTEXPR                   BlockManagerBase( const BlockManagerBase& Other ) = delete;
+    HAKLE_CPP14_CONSTEXPR BlockManagerBase& operator=( const BlockManagerBase& Other )        = delete;
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( BlockManagerBase& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
+        // TODO: swap allocator_type traits
+        // TODO: checking user-defined allocator, blockmanager, block,
+        using std::swap;
+        swap( static_cast<Base&>( *this ), static_cast<Base&>( Other ) );
+    }
+#endif
+
+    using AllocMode = hakle::AllocMode;
+
+    HAKLE_CPP14_CONSTEXPR AllocatorType& Allocator() noexcept { return Base::Get(); }
+    constexpr const AllocatorType&       Allocator() const noexcept { return Base::Get(); }
+
+private:
+    using Base = CompressPairElem<ALLOCATOR_TYPE, 0>;
+};
+
+// Runtime polymorphic block manager, for code that picks its manager at run time. Queues are templated on the
+// concrete manager type and call it directly, so the pool and free list fast paths inline; going through this
+// interface costs an indirect call at every block boundary.
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>>
+class PolymorphicBlockManager : public BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE> {
+public:
+    using BaseManager = BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE>;
+    using typename BaseManager::AllocatorType;
+    using typename BaseManager::AllocMode;
+    using typename BaseManager::BlockType;
+
+    constexpr explicit PolymorphicBlockManager( const AllocatorType& InAllocator = AllocatorType{} ) : BaseManager( InAllocator ) {}
+    virtual HAKLE_CPP20_CONSTEXPR ~PolymorphicBlockManager() = default;
+
+    virtual HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode InMode ) = 0;
+    virtual HAKLE_CPP20_CONSTEXPR void       ReturnBlocks( BlockType* InBlock )   = 0;
+    virtual HAKLE_CPP20_CONSTEXPR void       ReturnBlock( BlockType* InBlock )    = 0;
+
+    // Requisitions Count blocks linked through Next, fewer only when InMode is CannotAlloc and the manager runs dry.
+    // Managers that can hand out several blocks at once should override this.
+    virtual HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode InMode ) { return RequisitionBlocksOneByOne( *this, Count, InMode ); }
+};
+
+// Puts any block manager behind PolymorphicBlockManager
+template <HAKLE_CONCEPT( IsBlockManager ) INNER_MANAGER_TYPE>
+class PolymorphicBlockManagerAdapter final : public PolymorphicBlockManager<typename INNER_MANAGER_TYPE::BlockType, typename INNER_MANAGER_TYPE::AllocatorType> {
+public:
+    using InnerManagerType = INNER_MANAGER_TYPE;
+    using BaseManager      = PolymorphicBlockManager<typename InnerManagerType::BlockType, typename InnerManagerType::AllocatorType>;
+    using typename BaseManager::AllocatorType;
+    using typename BaseManager::AllocMode;
+    using typename BaseManager::BlockType;
+
+    template <class... Args>
+    explicit PolymorphicBlockManagerAdapter( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{}, Args&&... InArgs )
+        : BaseManager( InAllocator ), Manager( InSize, InAllocator, std::forward<Args>( InArgs )... ) {}
+
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) override { return Manager.RequisitionBlock( Mode ); }
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode Mode ) override { return hakle::RequisitionBlocks( Manager, Count, Mode ); }
+    HAKLE_CPP20_CONSTEXPR void       ReturnBlock( BlockType* InBlock ) override { Manager.ReturnBlock( InBlock ); }
+    HAKLE_CPP20_CONSTEXPR void       ReturnBlocks( BlockType* InBlock ) override { Manager.ReturnBlocks( InBlock ); }
+
+    HAKLE_CPP14_CONSTEXPR InnerManagerType& Get() noexcept { return Manager; }
+    constexpr const InnerManagerType&       Get() const noexcept { return Manager; }
+
+private:
+    InnerManagerType Manager;
+};
+
+// We set a block pool and a free list
+// FREE_LIST_TYPE may be FreeList_Tagged or FreeList_DAS over the same block type instead of the refcounted FreeList
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>, class FREE_LIST_TYPE = FreeList<BLOCK_TYPE, ALLOCATOR_TYPE>>
+class HakleBlockManager : public BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE> {
+public:
+    using BaseManager = BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE>;
+    // TODO:
+    // using typename BaseManager::AllocatorType;
+    using AllocatorType = typename BaseManager::AllocatorType;
+
+    using typename BaseManager::BlockAllocatorTraits;
+    using typename BaseManager::BlockType;
+    using typename BaseManager::ValueType;
+
+    using AllocMode = typename BaseManager::AllocMode;
+
+    // once the InSize pool blocks are used up, the manager grows by slabs of InSlabSize blocks
+    constexpr explicit HakleBlockManager( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{}, std::size_t InSlabSize = BlockSlabs<BLOCK_TYPE, ALLOCATOR_TYPE>::DefaultSlabSize )
+        : BaseManager( InAllocator ), Pool( InSize, InAllocator ), Slabs( InSlabSize, InAllocator ), List( InAllocator ), Parked( InAllocator ) {}
+    HAKLE_CPP20_CONSTEXPR ~HakleBlockManager() = default;
+
+    HAKLE_CPP14_CONSTEXPR                    HakleBlockManager( HakleBlockManager&& Other ) noexcept = default;
+    HAKLE_CPP14_CONSTEXPR HakleBlockManager& operator=( HakleBlockManager&& Other ) noexcept         = default;
+
+    HAKLE_CPP14_CONSTEXPR                    HakleBlockManager( const HakleBlockManager& Other ) = delete;
+    HAKLE_CPP14_CONSTEXPR HakleBlockManager& operator=( const HakleBlockManager& Other )         = delete;
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( HakleBlockManager& Other ) noexcept
+        HAKLE_REQUIRES( std::swappable<BlockPool<BlockType, AllocatorType>>&& std::swappable<FREE_LIST_TYPE>&& std::swappable<BlockSlabs<BlockType, AllocatorType>> ) {
+        BaseManager::swap( Other );
+        Pool.swap( Other.Pool );
+        List.swap( Other.List );
+        Parked.swap( Other.Parked );
+        Slabs.swap( Other.Slabs );
+        using std::swap;
+        HAKLE_SWAP( Policy );
+        HAKLE_SWAP( HighRounds );
+        HandedOut.swap( Other.HandedOut );
+    }
+#endif
+
+    static constexpr std::size_t NoBudget    = static_cast<std::size_t>( -1 );
+    static constexpr std::size_t NoHighWater = static_cast<std::size_t>( -1 );
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetBlockPoolSize() const noexcept { return Pool.GetSize(); }
+    HAKLE_NODISCARD constexpr BlockType*              GetBlockPoolData() const noexcept { return Pool.GetData(); }
+    // bytes held by the slabs grown past the pool
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetSlabBytes() const noexcept { return Slabs.GetBytes(); }
+
+    // Caps the blocks the manager holds, pool included. A CanAlloc requisition that would go over it fails like CannotAlloc,
+    // or with BudgetPolicy::Wait yields until another thread returns a block. Blocks already held are kept.
+    // NOTE: set it before the manager is shared
+    HAKLE_CPP14_CONSTEXPR void SetBlockBudget( std::size_t MaxBlocks, BudgetPolicy InPolicy = BudgetPolicy::Refuse ) noexcept {
+        std::size_t PoolSize = Pool.GetSize();
+        Slabs.SetBlockLimit( MaxBlocks == NoBudget ? BlockSlabs<BlockType, AllocatorType>::NoLimit : ( MaxBlocks > PoolSize ? MaxBlocks - PoolSize : 0 ) );
+        Policy = InPolicy;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void SetMemoryBudget( std::size_t MaxBytes, BudgetPolicy InPolicy = BudgetPolicy::Refuse ) noexcept {
+        SetBlockBudget( MaxBytes == NoBudget ? NoBudget : MaxBytes / sizeof( BlockType ), InPolicy );
+    }
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR BlockCounters GetCounters() const noexcept {
+        std::size_t PoolBytes = Pool.GetSize() * sizeof( BlockType );
+        return BlockCounters{ PoolBytes + Slabs.GetBytes(), PoolBytes + Slabs.GetPeakBytes(), Slabs.GetGrowCount(), Slabs.GetRefuseCount() };
+    }
+
+    // Blocks requisitioned and not returned yet count as producer blocks, the rest of the pool and slabs as free
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept {
+        MemoryStats Stats;
+        Stats.PoolBlockBytes     = Pool.GetSize() * sizeof( BlockType );
+        Stats.OverflowBlockBytes = Slabs.GetBytes();
+        std::ptrdiff_t Out       = HandedOut.Get();
+        Stats.ProducerBlockBytes = Out > 0 ? static_cast<std::size_t>( Out ) * sizeof( BlockType ) : 0;
+        std::size_t Held         = Stats.PoolBlockBytes + Stats.OverflowBlockBytes;
+        Stats.FreeBlockBytes     = Held > Stats.ProducerBlockBytes ? Held - Stats.ProducerBlockBytes : 0;
+        return Stats;
+    }
+
+    HAKLE_CPP14_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) {
+        BlockType* Block = Pool.GetBlock();
+        if ( Block != nullptr ) {
+            HandedOut.Add( 1 );
+            return Block;
+        }
+
+        Block = TryGetFree();
+        if ( Block != nullptr ) {
+            HandedOut.Add( 1 );
             return Block;
         }
 
-        // TODO: constexpr
-        // HAKLE_CONSTEXPR_IF( Mode == AllocMode::CannotAlloc ) { return nullptr; }
-        if ( Mode == AllocMode::CannotAlloc ) {
+        // the newest slab may have blocks left even when CannotAlloc, a new slab is only allocated when CanAlloc
+        // If user finishes using the block, it must be returned to the free list
+        std::size_t Count = 0;
+        Block             = CarveBlocks( 1, Count, Mode == AllocMode::CanAlloc );
+        while ( Block == nullptr && ShouldWait( Mode, 1 ) ) {
+            std::this_thread::yield();
+            Block = TryGetFree();
+            if ( Block == nullptr && Slabs.HasRoom() ) {
+                Block = CarveBlocks( 1, Count, true );
+            }
+        }
+        if ( Block != nullptr ) {
+            HandedOut.Add( 1 );
+        }
+        return Block;
+    }
+
+    // Pool range first (one fetch_add), then a chain from the free list (one CAS), then carve the rest off the slabs.
+    // With BudgetPolicy::Wait a short requisition gives back what it got before it yields and then tries for the whole
+    // Count again, so two bulk requisitions never sit on parts of the budget waiting for each other.
+    HAKLE_CPP14_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode Mode ) {
+        std::size_t Got   = 0;
+        BlockType*  First = TakeBlocks( Count, Mode == AllocMode::CanAlloc, Got );
+        while ( Got < Count && ShouldWait( Mode, Count ) ) {
+            if ( First != nullptr ) {
+                ReturnBlocks( First );
+            }
+            std::this_thread::yield();
+            First = TakeBlocks( Count, Slabs.HasRoom(), Got );
+        }
+        return First;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void ReturnBlock( BlockType* InBlock ) {
+        HandedOut.Add( -1 );
+        List.Add( InBlock );
+    }
+    // relinks the chain through FreeListNext so it goes back to the free list with one CAS
+    HAKLE_CPP14_CONSTEXPR void ReturnBlocks( BlockType* InBlock ) {
+        std::ptrdiff_t Count = 0;
+        for ( BlockType* Current = InBlock; Current != nullptr; Current = Current->Next ) {
+            Current->FreeListNext.store( Current->Next, std::memory_order_relaxed );
+            ++Count;
+        }
+        HandedOut.Add( -Count );
+        List.AddChain( InBlock );
+    }
+
+    // Takes over the storage backing the blocks Other handed out, so they can be returned here and stay valid after
+    // Other is gone. Slabs whose blocks are all free stay with Other with their free blocks, and so does its pool unless
+    // one of those blocks came from it: then the pool storage becomes a slab here, released by Trim like any other once
+    // it is all free, and Other starts over with a new pool of the same size. Other keeps the capacity it was
+    // constructed with, so splicing back and forth does not wear it down.
+    // NOTE: not thread safe, neither manager may be in use
+    HAKLE_CPP20_CONSTEXPR void AdoptBlocks( HakleBlockManager& Other ) {
+        if ( this == &Other ) {
+            return;
+        }
+
+        // Other's free blocks, the ones of its pool apart
+        BlockType*  Free          = nullptr;
+        BlockType*  PoolFree      = nullptr;
+        std::size_t PoolFreeCount = 0;
+        BlockType*  PoolFirst     = Other.Pool.GetData();
+        BlockType*  PoolLast      = PoolFirst + ( Other.Pool.GetSize() - Other.Pool.GetRemaining() );
+        std::less<> Less;
+        for ( FREE_LIST_TYPE* From : { &Other.List, &Other.Parked } ) {
+            for ( BlockType* Block = From->TryGet(); Block != nullptr; Block = From->TryGet() ) {
+                bool        InPool = PoolFirst != nullptr && !Less( Block, PoolFirst ) && Less( Block, PoolLast );
+                BlockType*& To     = InPool ? PoolFree : Free;
+                Block->FreeListNext.store( To, std::memory_order_relaxed );
+                To = Block;
+                PoolFreeCount += InPool ? 1 : 0;
+            }
+        }
+
+        if ( PoolFreeCount < static_cast<std::size_t>( PoolLast - PoolFirst ) ) {
+            BlockType* Remaining = nullptr;
+            HAKLE_TRY { Remaining = Slabs.AdoptPool( Other.Pool ); }
+            HAKLE_CATCH( ... ) {
+                Other.List.AddChain( PoolFree );
+                Other.List.AddChain( Free );
+                HAKLE_RETHROW;
+            }
+            List.AddChain( PoolFree );
+            List.AddChain( Remaining );
+        }
+        else {
+            Other.List.AddChain( PoolFree );
+        }
+        List.AddChain( Slabs.Adopt( Other.Slabs, Free ) );
+        Other.List.AddChain( Free );
+
+        // blocks Other handed out come back here
+        HandedOut.Add( Other.HandedOut.Exchange() );
+    }
+
+    // Gives slabs whose blocks are all free back to the allocator until at most TargetBytes of slabs are kept,
+    // returns the bytes freed. The pool itself is never released. Safe next to requisitions and returns: free blocks
+    // are counted in batches of TrimBatch and parked on a second list requisitions take from too, then sorted out
+    // again in batches where only the blocks of slabs about to be released are kept. A requisition that finds no
+    // free block while a batch is out waits for it instead of failing or growing, and a slab a requisition may
+    // still touch is freed by a later call.
+    // NOTE: only one thread may trim or maintain at a time
+    HAKLE_CPP20_CONSTEXPR std::size_t Trim( std::size_t TargetBytes = 0 ) noexcept {
+        // with nothing left to release the call only frees what earlier calls released
+        if ( Slabs.BeginTrim( TargetBytes ) ) {
+            // blocks returned meanwhile are not waited for, so the count stops after as many blocks as there are
+            std::size_t Limit = Pool.GetSize() + Slabs.GetBytes() / sizeof( BlockType );
+            std::size_t Moved = 0;
+            std::size_t Count = 0;
+            for ( BlockType* Batch = TakeTrimBatch( List, Count ); Batch != nullptr; Batch = Moved < Limit ? TakeTrimBatch( List, Count ) : nullptr ) {
+                Parked.AddChain( Slabs.CountBlocks( Batch ) );
+                Slabs.EndTrimBatch( TrimBatch );
+                Moved += Count;
+            }
+            Slabs.PickReleasable();
+            for ( BlockType* Batch = TakeTrimBatch( Parked, Count ); Batch != nullptr; Batch = TakeTrimBatch( Parked, Count ) ) {
+                List.AddChain( Slabs.Collect( Batch ) );
+                Slabs.EndTrimBatch( TrimBatch );
+            }
+        }
+        BlockType*  Free     = nullptr;
+        std::size_t Released = Slabs.EndTrim( Free );
+        List.AddChain( Free );
+        return Released;
+    }
+
+    // Refill step for a low priority thread or an idle loop to call now and then, returns the free blocks it counted.
+    // Below LowWater free blocks, whole slabs are allocated, constructed and put on the free list here, so requisitions
+    // find blocks ready instead of allocating on their own path. Once more than HighWater blocks stayed free through
+    // StaleRounds calls in a row, the surplus slabs are released with Trim.
+    // Both steps are safe next to requisitions and returns, slabs released while one of them may still touch them are
+    // freed by a later call.
+    // NOTE: only one thread may trim or maintain at a time
+    HAKLE_CPP20_CONSTEXPR std::size_t Maintain( std::size_t LowWater, std::size_t HighWater = NoHighWater, std::size_t StaleRounds = 4 ) {
+        // without a HighWater counting stops at LowWater, otherwise the whole free list is walked to size the surplus
+        std::size_t Free = Refill( CountFree( HighWater == NoHighWater ? LowWater : NoHighWater ), LowWater );
+
+        // with no surplus Trim releases nothing and only frees what earlier rounds released
+        std::size_t TargetBytes = NoHighWater;
+        if ( HighWater == NoHighWater || Free <= HighWater ) {
+            HighRounds = 0;
+        }
+        else if ( ++HighRounds >= StaleRounds ) {
+            HighRounds            = 0;
+            std::size_t Surplus   = ( Free - HighWater ) * sizeof( BlockType );
+            std::size_t SlabBytes = Slabs.GetBytes() - Slabs.GetReleasedBytes();
+            TargetBytes           = SlabBytes > Surplus ? SlabBytes - Surplus : 0;
+        }
+        Trim( TargetBytes );
+        return Free;
+    }
+
+    // Grows slabs until about Count blocks are free, without taking any and without waiting on the budget, like the
+    // refill step of Maintain. Returns false when the budget or the allocator stopped it short.
+    HAKLE_CPP20_CONSTEXPR bool Reserve( std::size_t Count ) { return Refill( CountFree( Count ), Count ) >= Count; }
+
+private:
+    // free blocks Trim has off the free list at a time
+    static constexpr std::size_t TrimBatch = 64;
+
+    // blocks left in the pool and on the free lists, only a hint while other threads take or return blocks
+    HAKLE_CPP14_CONSTEXPR std::size_t CountFree( std::size_t Limit ) noexcept {
+        EpochPins::Guard Guard( Slabs.GetPins() );
+        std::size_t      Free = Pool.GetRemaining() + List.EstimateSize( Limit );
+        return Free < Limit ? Free + Parked.EstimateSize( Limit - Free ) : Free;
+    }
+
+    // a batch for Trim, counted as out from before it is taken until the caller ends it
+    HAKLE_CPP14_CONSTEXPR BlockType* TakeTrimBatch( FREE_LIST_TYPE& From, std::size_t& Count ) noexcept {
+        Slabs.BeginTrimBatch( TrimBatch );
+        BlockType* Batch = From.TryGetChain( TrimBatch, Count );
+        if ( Batch == nullptr ) {
+            Slabs.EndTrimBatch( TrimBatch );
+        }
+        return Batch;
+    }
+
+    // the newest slab's remainder is carved first, then new slabs until Free reaches LowWater or the budget is reached
+    HAKLE_CPP20_CONSTEXPR std::size_t Refill( std::size_t Free, std::size_t LowWater ) {
+        while ( Free < LowWater ) {
+            std::size_t Count = 0;
+            BlockType*  Range = CarveBlocks( Slabs.GetSlabSize(), Count, Slabs.HasRoom() );
+            if ( Range == nullptr ) {
+                break;
+            }
+            for ( std::size_t i = 0; i + 1 < Count; ++i ) {
+                Range[ i ].FreeListNext.store( Range + i + 1, std::memory_order_relaxed );
+            }
+            Range[ Count - 1 ].FreeListNext.store( nullptr, std::memory_order_relaxed );
+            List.AddChain( Range );
+            Free += Count;
+        }
+        return Free;
+    }
+
+    // Up to Count blocks linked through Next, Got is set to how many. Never waits, a new slab is only grown if CanGrow.
+    HAKLE_CPP14_CONSTEXPR BlockType* TakeBlocks( std::size_t Count, bool CanGrow, std::size_t& Got ) {
+        std::size_t Requested = Count;
+        BlockType*  First     = nullptr;
+        BlockType*  Last      = nullptr;
+        auto       Link  = [ &First, &Last ]( BlockType* Block ) {
+            if ( Last == nullptr ) {
+                First = Block;
+            }
+            else {
+                Last->Next = Block;
+            }
+            Last = Block;
+        };
+
+        BlockType* Range = Pool.GetBlocks( Count, Got );
+        for ( std::size_t i = 0; i < Got; ++i ) {
+            Link( Range + i );
+        }
+        Count -= Got;
+
+        if ( Count > 0 ) {
+            for ( BlockType* Block = TryGetFreeChain( Count, Got ); Block != nullptr; Block = Block->FreeListNext.load( std::memory_order_relaxed ) ) {
+                Link( Block );
+            }
+            Count -= Got;
+        }
+
+        HAKLE_TRY {
+            while ( Count > 0 && ( Range = CarveBlocks( Count, Got, CanGrow ) ) != nullptr ) {
+                for ( std::size_t i = 0; i < Got; ++i ) {
+                    Link( Range + i );
+                }
+                Count -= Got;
+            }
+        }
+        HAKLE_CATCH( ... ) {
+            if ( Last != nullptr ) {
+                Last->Next = nullptr;
+                HandedOut.Add( static_cast<std::ptrdiff_t>( Requested - Count ) );
+                ReturnBlocks( First );
+            }
+            HAKLE_RETHROW;
+        }
+
+        Got = Requested - Count;
+        if ( Last != nullptr ) {
+            Last->Next = nullptr;
+            HandedOut.Add( static_cast<std::ptrdiff_t>( Got ) );
+        }
+        return First;
+    }
+
+    // Free list walks and carving may touch blocks of slabs Trim is releasing, so they run under a guard of the slabs.
+    // The blocks Trim parked count as free, and while it has a batch out the free lists are only empty for a moment.
+    HAKLE_CPP14_CONSTEXPR BlockType* TryGetFree() noexcept {
+        EpochPins::Guard Guard( Slabs.GetPins() );
+        while ( true ) {
+            BlockType* Block = List.TryGet();
+            if ( Block == nullptr ) {
+                Block = Parked.TryGet();
+            }
+            if ( Block != nullptr || !Slabs.HasTrimBatch() ) {
+                return Block;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    HAKLE_CPP14_CONSTEXPR BlockType* TryGetFreeChain( std::size_t Count, std::size_t& Got ) noexcept {
+        EpochPins::Guard Guard( Slabs.GetPins() );
+        while ( true ) {
+            BlockType* First = List.TryGetChain( Count, Got );
+            if ( Got < Count ) {
+                std::size_t More = 0;
+                BlockType*  Rest = Parked.TryGetChain( Count - Got, More );
+                if ( First == nullptr ) {
+                    First = Rest;
+                }
+                else if ( Rest != nullptr ) {
+                    BlockType* Last = First;
+                    for ( BlockType* Next = Last->FreeListNext.load( std::memory_order_relaxed ); Next != nullptr; Next = Last->FreeListNext.load( std::memory_order_relaxed ) ) {
+                        Last = Next;
+                    }
+                    Last->FreeListNext.store( Rest, std::memory_order_relaxed );
+                }
+                Got += More;
+            }
+            if ( First != nullptr || !Slabs.HasTrimBatch() ) {
+                return First;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR BlockType* CarveBlocks( std::size_t Count, std::size_t& Got, bool CanGrow ) {
+        EpochPins::Guard Guard( Slabs.GetPins() );
+        return Slabs.GetBlocks( Count, Got, CanGrow );
+    }
+
+    // waiting only makes sense for requests the budget can ever satisfy
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR bool ShouldWait( AllocMode Mode, std::size_t Count ) const noexcept {
+        return Mode == AllocMode::CanAlloc && Policy == BudgetPolicy::Wait && ( Count <= Pool.GetSize() || Count - Pool.GetSize() <= Slabs.GetBlockLimit() );
+    }
+
+    BlockPool<BlockType, AllocatorType>  Pool;
+    BlockSlabs<BlockType, AllocatorType> Slabs;
+    // declared last, they still walk pool and slab blocks when they are destroyed
+    FREE_LIST_TYPE List;
+    // free blocks Trim counted and has not sorted out yet, requisitions take from it too
+    FREE_LIST_TYPE Parked;
+    BudgetPolicy   Policy{ BudgetPolicy::Refuse };
+    // Maintain calls in a row that found more than HighWater free blocks
+    std::size_t HighRounds{ 0 };
+    // blocks requisitioned and not returned yet, bumped by every requisition and return so it is sharded
+    ShardedCounter HandedOut;
+};
+
+// Per-thread magazines of free blocks in front of a HakleBlockManager.
+// A thread takes and returns blocks through its own magazine and only touches the shared free list when the magazine
+// runs empty or full, then half a magazine is moved at once as a chain. A magazine that is busy (two threads mapped to
+// it at the same time) is bypassed, never waited for.
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>, std::size_t MAGAZINE_SIZE = 32>
+class MagazineBlockManager : public BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE> {
+public:
+    using BaseManager   = BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE>;
+    using AllocatorType = typename BaseManager::AllocatorType;
+
+    using typename BaseManager::BlockAllocatorTraits;
+    using typename BaseManager::BlockType;
+    using typename BaseManager::ValueType;
+
+    using AllocMode = typename BaseManager::AllocMode;
+
+    static_assert( MAGAZINE_SIZE >= 2, "MagazineSize must be at least 2" );
+    static constexpr std::size_t MagazineSize = MAGAZINE_SIZE;
+
+    // InMagazineCount of 0 means two magazines per hardware thread
+    HAKLE_CPP20_CONSTEXPR explicit MagazineBlockManager( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{}, std::size_t InMagazineCount = 0 )
+        : BaseManager( InAllocator ), Inner( InSize, InAllocator ), MagazineAllocatorPair( InMagazineCount != 0 ? InMagazineCount : 2 * std::max<std::size_t>( std::thread::hardware_concurrency(), 1 ), MagazineAllocatorType( InAllocator ) ) {
+        Magazines = MagazineAllocatorTraits::Allocate( MagazineAllocator(), MagazineCount() );
+        for ( std::size_t i = 0; i < MagazineCount(); ++i ) {
+            MagazineAllocatorTraits::Construct( MagazineAllocator(), Magazines + i );
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR ~MagazineBlockManager() { Clear(); }
+
+    HAKLE_CPP14_CONSTEXPR MagazineBlockManager( MagazineBlockManager&& Other ) noexcept
+        : BaseManager( std::move( Other ) ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, Inner, MagazineAllocatorPair, Magazines ) {
+        Other.Reset();
+    }
+
+    HAKLE_CPP14_CONSTEXPR MagazineBlockManager& operator=( MagazineBlockManager&& Other ) noexcept {
+        if ( this != &Other ) {
+            Clear();
+            BaseManager::operator=( std::move( Other ) );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, Inner, MagazineAllocatorPair, Magazines );
+            Other.Reset();
+        }
+        return *this;
+    }
+
+    MagazineBlockManager( const MagazineBlockManager& Other )            = delete;
+    MagazineBlockManager& operator=( const MagazineBlockManager& Other ) = delete;
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( MagazineBlockManager& Other ) noexcept
+        HAKLE_REQUIRES( std::swappable<HakleBlockManager<BlockType, AllocatorType>>&& std::swappable<AllocatorType> ) {
+        BaseManager::swap( Other );
+        using std::swap;
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, Inner, MagazineAllocatorPair, Magazines );
+    }
+#endif
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetBlockPoolSize() const noexcept { return Inner.GetBlockPoolSize(); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetSlabBytes() const noexcept { return Inner.GetSlabBytes(); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR BlockCounters GetCounters() const noexcept { return Inner.GetCounters(); }
+    // blocks cached in the magazines are counted as producer blocks until Drain
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept { return Inner.GetMemoryStats(); }
+
+    // Same as HakleBlockManager::SetBlockBudget, blocks cached in the magazines count as held
+    HAKLE_CPP14_CONSTEXPR void SetBlockBudget( std::size_t MaxBlocks, BudgetPolicy InPolicy = BudgetPolicy::Refuse ) noexcept { Inner.SetBlockBudget( MaxBlocks, InPolicy ); }
+    HAKLE_CPP14_CONSTEXPR void SetMemoryBudget( std::size_t MaxBytes, BudgetPolicy InPolicy = BudgetPolicy::Refuse ) noexcept { Inner.SetMemoryBudget( MaxBytes, InPolicy ); }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetMagazineCount() const noexcept { return MagazineCount(); }
+
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) {
+        Magazine* Current = TryLockMagazine();
+        if ( Current == nullptr ) {
+            return Inner.RequisitionBlock( Mode );
+        }
+
+        MagazineGuard Guard{ Current };
+        if ( Current->Count == 0 ) {
+            Refill( *Current );
+        }
+        if ( Current->Count > 0 ) {
+            return Current->Blocks[ --Current->Count ];
+        }
+        return Inner.RequisitionBlock( Mode );
+    }
+
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode Mode ) {
+        BlockType* First   = nullptr;
+        Magazine*  Current = TryLockMagazine();
+        if ( Current != nullptr ) {
+            MagazineGuard Guard{ Current };
+            for ( ; Count > 0 && Current->Count > 0; --Count ) {
+                BlockType* Block = Current->Blocks[ --Current->Count ];
+                Block->Next      = First;
+                First            = Block;
+            }
+        }
+        if ( Count == 0 ) {
+            return First;
+        }
+
+        BlockType* Rest = nullptr;
+        HAKLE_TRY { Rest = Inner.RequisitionBlocks( Count, Mode ); }
+        HAKLE_CATCH( ... ) {
+            if ( First != nullptr ) {
+                ReturnBlocks( First );
+            }
+            HAKLE_RETHROW;
+        }
+        if ( First == nullptr ) {
+            return Rest;
+        }
+        BlockType* Last = First;
+        while ( Last->Next != nullptr ) {
+            Last = Last->Next;
+        }
+        Last->Next = Rest;
+        return First;
+    }
+
+    HAKLE_CPP20_CONSTEXPR void ReturnBlock( BlockType* InBlock ) {
+        Magazine* Current = TryLockMagazine();
+        if ( Current == nullptr ) {
+            Inner.ReturnBlock( InBlock );
+            return;
+        }
+
+        MagazineGuard Guard{ Current };
+        if ( Current->Count == MagazineSize ) {
+            Flush( *Current );
+        }
+        Current->Blocks[ Current->Count++ ] = InBlock;
+    }
+
+    HAKLE_CPP20_CONSTEXPR void ReturnBlocks( BlockType* InBlock ) {
+        Magazine* Current = TryLockMagazine();
+        if ( Current != nullptr ) {
+            MagazineGuard Guard{ Current };
+            for ( ; InBlock != nullptr && Current->Count < MagazineSize; InBlock = InBlock->Next ) {
+                Current->Blocks[ Current->Count++ ] = InBlock;
+            }
+        }
+        if ( InBlock != nullptr ) {
+            Inner.ReturnBlocks( InBlock );
+        }
+    }
+
+    // Same as HakleBlockManager::AdoptBlocks, Other's magazines are emptied first
+    // NOTE: not thread safe, neither manager may be in use
+    HAKLE_CPP20_CONSTEXPR void AdoptBlocks( MagazineBlockManager& Other ) {
+        if ( this != &Other ) {
+            Other.Drain();
+            Inner.AdoptBlocks( Other.Inner );
+        }
+    }
+
+    // Same as HakleBlockManager::Trim, the magazines are emptied first so their blocks count as free
+    HAKLE_CPP20_CONSTEXPR std::size_t Trim( std::size_t TargetBytes = 0 ) {
+        Drain();
+        return Inner.Trim( TargetBytes );
+    }
+
+    // Same as HakleBlockManager::Maintain, blocks cached in the magazines are not counted
+    HAKLE_CPP20_CONSTEXPR std::size_t Maintain( std::size_t LowWater, std::size_t HighWater = HakleBlockManager<BlockType, AllocatorType>::NoHighWater, std::size_t StaleRounds = 4 ) {
+        return Inner.Maintain( LowWater, HighWater, StaleRounds );
+    }
+
+    HAKLE_CPP20_CONSTEXPR bool Reserve( std::size_t Count ) { return Inner.Reserve( Count ); }
+
+    // Hands every block cached in the magazines back to the shared free list, a magazine in use is skipped
+    HAKLE_CPP20_CONSTEXPR void Drain() {
+        for ( std::size_t i = 0; i < MagazineCount(); ++i ) {
+            Magazine& Current = Magazines[ i ];
+            if ( Current.Busy.load( std::memory_order_relaxed ) || Current.Busy.exchange( true, std::memory_order_acquire ) ) {
+                continue;
+            }
+            MagazineGuard Guard{ &Current };
+            while ( Current.Count > 0 ) {
+                Inner.ReturnBlock( Current.Blocks[ --Current.Count ] );
+            }
+        }
+    }
+
+private:
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) Magazine {
+        std::atomic<bool> Busy{ false };
+        std::size_t       Count{ 0 };
+        BlockType*        Blocks[ MagazineSize ]{};
+    };
+
+    struct MagazineGuard {
+        Magazine* Current;
+        HAKLE_CPP20_CONSTEXPR ~MagazineGuard() noexcept { Current->Busy.store( false, std::memory_order_release ); }
+    };
+
+    using MagazineAllocatorType   = typename BlockAllocatorTraits::template RebindAlloc<Magazine>;
+    using MagazineAllocatorTraits = typename BlockAllocatorTraits::template RebindTraits<Magazine>;
+
+    HAKLE_CPP20_CONSTEXPR Magazine* TryLockMagazine() noexcept {
+        if ( Magazines == nullptr ) {
             return nullptr;
         }
-        else {
-            // When alloc mode is CanAlloc, we allocate a new block
-            // If user finishes using the block, it must be returned to the free list
-            BlockType* NewBlock = BlockAllocatorTraits::Allocate( this->Allocator() );
-            BlockAllocatorTraits::Construct( this->Allocator(), NewBlock );
-            return NewBlock;
+        Magazine* Current = Magazines + CurrentThreadIndex() % MagazineCount();
+        if ( Current->Busy.load( std::memory_order_relaxed ) || Current->Busy.exchange( true, std::memory_order_acquire ) ) {
+            return nullptr;
+        }
+        return Current;
+    }
+
+    // Half a magazine from the shared free list in one chain, without allocating
+    HAKLE_CPP20_CONSTEXPR void Refill( Magazine& Current ) {
+        for ( BlockType* Block = Inner.RequisitionBlocks( MagazineSize / 2, AllocMode::CannotAlloc ); Block != nullptr; Block = Block->Next ) {
+            Current.Blocks[ Current.Count++ ] = Block;
+        }
+    }
+
+    // The older half of a full magazine goes back to the shared free list in one chain
+    HAKLE_CPP20_CONSTEXPR void Flush( Magazine& Current ) {
+        constexpr std::size_t Half = MagazineSize / 2;
+        for ( std::size_t i = 0; i + 1 < Half; ++i ) {
+            Current.Blocks[ i ]->Next = Current.Blocks[ i + 1 ];
+        }
+        Current.Blocks[ Half - 1 ]->Next = nullptr;
+        Inner.ReturnBlocks( Current.Blocks[ 0 ] );
+
+        std::move( Current.Blocks + Half, Current.Blocks + Current.Count, Current.Blocks );
+        Current.Count -= Half;
+    }
+
+    HAKLE_CPP20_CONSTEXPR void Clear() noexcept {
+        if ( Magazines == nullptr ) {
+            return;
+        }
+        Drain();
+        MagazineAllocatorTraits::Destroy( MagazineAllocator(), Magazines, MagazineCount() );
+        MagazineAllocatorTraits::Deallocate( MagazineAllocator(), Magazines, MagazineCount() );
+        Magazines = nullptr;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
+        MagazineCount() = 0;
+        Magazines       = nullptr;
+    }
+
+    HAKLE_CPP14_CONSTEXPR std::size_t&            MagazineCount() noexcept { return MagazineAllocatorPair.First(); }
+    HAKLE_NODISCARD constexpr const std::size_t&  MagazineCount() const noexcept { return MagazineAllocatorPair.First(); }
+    HAKLE_CPP14_CONSTEXPR MagazineAllocatorType&  MagazineAllocator() noexcept { return MagazineAllocatorPair.Second(); }
+
+    HakleBlockManager<BlockType, AllocatorType> Inner;
+    // compressed allocator
+    CompressPair<std::size_t, MagazineAllocatorType> MagazineAllocatorPair{};
+    Magazine*                                        Magazines{ nullptr };
+};
+
+namespace details {
+// <linux/mempolicy.h> values, spelled out so no kernel or libnuma header is needed
+constexpr int         NumaPreferred    = 1;
+constexpr int         NumaMemsAllowed  = 1 << 2;
+constexpr unsigned    NumaMoveFlag     = 1 << 1;
+constexpr std::size_t NumaMaxNodes     = 1024;
+constexpr std::size_t NumaMaskWordBits = 8 * sizeof( unsigned long );
+}  // namespace details
+
+// Number of NUMA nodes the process may allocate on, 1 when the kernel has no NUMA support or the syscall is refused
+inline std::size_t NumaNodeCount() noexcept {
+    static const std::size_t Count = [] {
+#if defined( __linux__ ) && defined( SYS_get_mempolicy )
+        unsigned long Mask[ details::NumaMaxNodes / details::NumaMaskWordBits ]{};
+        int           Mode = 0;
+        if ( ::syscall( SYS_get_mempolicy, &Mode, Mask, details::NumaMaxNodes, nullptr, details::NumaMemsAllowed ) == 0 ) {
+            for ( std::size_t Node = details::NumaMaxNodes; Node > 0; --Node ) {
+                if ( Mask[ ( Node - 1 ) / details::NumaMaskWordBits ] & ( 1UL << ( ( Node - 1 ) % details::NumaMaskWordBits ) ) ) {
+                    return Node;
+                }
+            }
+        }
+#endif
+        return static_cast<std::size_t>( 1 );
+    }();
+    return Count;
+}
+
+// NUMA node of the CPU the calling thread runs on, 0 when unknown.
+// Cached per thread and refreshed every RefreshInterval calls, a migrated thread is noticed late, never wrongly served.
+inline std::size_t CurrentNumaNode() noexcept {
+#if defined( __linux__ ) && defined( SYS_getcpu )
+    constexpr unsigned RefreshInterval = 64;
+    struct NodeCache {
+        unsigned Node{ 0 };
+        unsigned Calls{ 0 };
+    };
+    thread_local NodeCache Cache;
+    if ( Cache.Calls++ % RefreshInterval == 0 ) {
+        unsigned Cpu  = 0;
+        unsigned Node = 0;
+        Cache.Node    = ::syscall( SYS_getcpu, &Cpu, &Node, nullptr ) == 0 ? Node : 0;
+    }
+    return Cache.Node;
+#else
+    return 0;
+#endif
+}
+
+// Asks the kernel to keep the whole pages inside [Ptr, Ptr + Bytes) on Node, moving pages already touched elsewhere.
+// Only a preference, so memory pressure spills to other nodes instead of failing. Returns false when nothing was bound.
+inline bool NumaBindMemory( void* Ptr, std::size_t Bytes, std::size_t Node ) noexcept {
+#if defined( __linux__ ) && defined( SYS_mbind )
+    if ( Ptr == nullptr || Node >= details::NumaMaxNodes || NumaNodeCount() < 2 ) {
+        return false;
+    }
+    const std::uintptr_t PageSize = static_cast<std::uintptr_t>( ::sysconf( _SC_PAGESIZE ) );
+    const std::uintptr_t Begin    = ( reinterpret_cast<std::uintptr_t>( Ptr ) + PageSize - 1 ) & ~( PageSize - 1 );
+    const std::uintptr_t End      = ( reinterpret_cast<std::uintptr_t>( Ptr ) + Bytes ) & ~( PageSize - 1 );
+    if ( Begin >= End ) {
+        return false;
+    }
+    unsigned long Mask[ details::NumaMaxNodes / details::NumaMaskWordBits ]{};
+    Mask[ Node / details::NumaMaskWordBits ] = 1UL << ( Node % details::NumaMaskWordBits );
+    return ::syscall( SYS_mbind, Begin, End - Begin, details::NumaPreferred, Mask, details::NumaMaxNodes, details::NumaMoveFlag ) == 0;
+#else
+    ( void )Ptr, ( void )Bytes, ( void )Node;
+    return false;
+#endif
+}
+
+// One HakleBlockManager per NUMA node. A thread requisitions from its own node's manager, takes free blocks from other
+// nodes only when its own node has none left, and allocates new storage on its own node only after that.
+// Returned blocks go back to the manager they came from, not to the returning thread's node, so a node's free list
+// never fills up with remote memory. Each node's pool is bound to its node; slabs rely on first touch by the requesting
+// thread. With one node (or no NUMA support) it behaves like a single HakleBlockManager.
+template <HAKLE_CONCEPT( IsBlock ) BLOCK_TYPE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<BLOCK_TYPE>>
+class NumaBlockManager : public BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE> {
+public:
+    using BaseManager   = BlockManagerBase<BLOCK_TYPE, ALLOCATOR_TYPE>;
+    using AllocatorType = typename BaseManager::AllocatorType;
+
+    using typename BaseManager::BlockAllocatorTraits;
+    using typename BaseManager::BlockType;
+    using typename BaseManager::ValueType;
+
+    using AllocMode = typename BaseManager::AllocMode;
+
+    // every node gets a pool of InSize blocks, InNodeCount of 0 means one manager per NUMA node of the machine
+    HAKLE_CPP20_CONSTEXPR explicit NumaBlockManager( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{}, std::size_t InNodeCount = 0 )
+        : BaseManager( InAllocator ), NodeAllocatorPair( InNodeCount != 0 ? InNodeCount : NumaNodeCount(), NodeAllocatorType( InAllocator ) ) {
+        Nodes                   = NodeAllocatorTraits::Allocate( NodeAllocator(), NodeCount() );
+        std::size_t Constructed = 0;
+        HAKLE_TRY {
+            for ( ; Constructed < NodeCount(); ++Constructed ) {
+                NodeAllocatorTraits::Construct( NodeAllocator(), Nodes + Constructed, InSize, InAllocator );
+                NumaBindMemory( Nodes[ Constructed ].Manager.GetBlockPoolData(), InSize * sizeof( BlockType ), Constructed );
+            }
+        }
+        HAKLE_CATCH( ... ) {
+            NodeAllocatorTraits::Destroy( NodeAllocator(), Nodes, Constructed );
+            NodeAllocatorTraits::Deallocate( NodeAllocator(), Nodes, NodeCount() );
+            HAKLE_RETHROW;
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR ~NumaBlockManager() { Clear(); }
+
+    HAKLE_CPP14_CONSTEXPR NumaBlockManager( NumaBlockManager&& Other ) noexcept : BaseManager( std::move( Other ) ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, NodeAllocatorPair, Nodes ) {
+        Other.Reset();
+    }
+
+    HAKLE_CPP14_CONSTEXPR NumaBlockManager& operator=( NumaBlockManager&& Other ) noexcept {
+        if ( this != &Other ) {
+            Clear();
+            BaseManager::operator=( std::move( Other ) );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, NodeAllocatorPair, Nodes );
+            Other.Reset();
+        }
+        return *this;
+    }
+
+    NumaBlockManager( const NumaBlockManager& Other )            = delete;
+    NumaBlockManager& operator=( const NumaBlockManager& Other ) = delete;
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( NumaBlockManager& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
+        BaseManager::swap( Other );
+        using std::swap;
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, NodeAllocatorPair, Nodes );
+    }
+#endif
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetNodeCount() const noexcept { return NodeCount(); }
+    // the manager blocks handed out by the calling thread come from first
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetLocalNode() const noexcept { return CurrentNumaNode() % NodeCount(); }
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetBlockPoolSize() const noexcept {
+        std::size_t Size = 0;
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            Size += Nodes[ i ].Manager.GetBlockPoolSize();
+        }
+        return Size;
+    }
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t GetSlabBytes() const noexcept {
+        std::size_t Bytes = 0;
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            Bytes += Nodes[ i ].Manager.GetSlabBytes();
+        }
+        return Bytes;
+    }
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR BlockCounters GetCounters() const noexcept {
+        BlockCounters Counters{};
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            BlockCounters NodeCounters = Nodes[ i ].Manager.GetCounters();
+            Counters.CurrentBytes += NodeCounters.CurrentBytes;
+            Counters.PeakBytes += NodeCounters.PeakBytes;
+            Counters.OverflowAllocations += NodeCounters.OverflowAllocations;
+            Counters.RefusedAllocations += NodeCounters.RefusedAllocations;
+        }
+        return Counters;
+    }
+
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept {
+        MemoryStats Stats;
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            Stats += Nodes[ i ].Manager.GetMemoryStats();
+        }
+        return Stats;
+    }
+
+    // Same as HakleBlockManager::SetBlockBudget, split evenly between the nodes
+    HAKLE_CPP14_CONSTEXPR void SetBlockBudget( std::size_t MaxBlocks, BudgetPolicy InPolicy = BudgetPolicy::Refuse ) noexcept {
+        using NodeManager = HakleBlockManager<BlockType, AllocatorType>;
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            Nodes[ i ].Manager.SetBlockBudget( MaxBlocks == NodeManager::NoBudget ? NodeManager::NoBudget : MaxBlocks / NodeCount(), InPolicy );
+        }
+    }
+    HAKLE_CPP14_CONSTEXPR void SetMemoryBudget( std::size_t MaxBytes, BudgetPolicy InPolicy = BudgetPolicy::Refuse ) noexcept {
+        using NodeManager = HakleBlockManager<BlockType, AllocatorType>;
+        SetBlockBudget( MaxBytes == NodeManager::NoBudget ? NodeManager::NoBudget : MaxBytes / sizeof( BlockType ), InPolicy );
+    }
+
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) {
+        const std::size_t Local = GetLocalNode();
+        BlockType*        Block = Nodes[ Local ].Manager.RequisitionBlock( AllocMode::CannotAlloc );
+        std::size_t       From  = Local;
+        for ( std::size_t i = 1; Block == nullptr && i < NodeCount(); ++i ) {
+            From  = ( Local + i ) % NodeCount();
+            Block = Nodes[ From ].Manager.RequisitionBlock( AllocMode::CannotAlloc );
+        }
+        if ( Block == nullptr && Mode == AllocMode::CanAlloc ) {
+            From  = Local;
+            Block = Nodes[ Local ].Manager.RequisitionBlock( AllocMode::CanAlloc );
+        }
+        if ( Block != nullptr ) {
+            Block->HomeNode = static_cast<std::uint16_t>( From );
+        }
+        return Block;
+    }
+
+    // free blocks of the local node, then of the other nodes, then new local storage when CanAlloc
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode Mode ) {
+        const std::size_t Local = GetLocalNode();
+        BlockType*        First = nullptr;
+        BlockType*        Last  = nullptr;
+        HAKLE_TRY {
+            for ( std::size_t i = 0; Count > 0 && i < NodeCount(); ++i ) {
+                const std::size_t From = ( Local + i ) % NodeCount();
+                Count -= Append( First, Last, Nodes[ From ].Manager.RequisitionBlocks( Count, AllocMode::CannotAlloc ), From );
+            }
+            if ( Count > 0 && Mode == AllocMode::CanAlloc ) {
+                Append( First, Last, Nodes[ Local ].Manager.RequisitionBlocks( Count, AllocMode::CanAlloc ), Local );
+            }
+        }
+        HAKLE_CATCH( ... ) {
+            if ( First != nullptr ) {
+                ReturnBlocks( First );
+            }
+            HAKLE_RETHROW;
         }
+        return First;
     }
 
-    HAKLE_CPP14_CONSTEXPR void ReturnBlock( BlockType* InBlock ) override { List.Add( InBlock ); }
-    HAKLE_CPP14_CONSTEXPR void ReturnBlocks( BlockType* InBlock ) override {
+    HAKLE_CPP20_CONSTEXPR void ReturnBlock( BlockType* InBlock ) { Nodes[ InBlock->HomeNode % NodeCount() ].Manager.ReturnBlock( InBlock ); }
+
+    // the chain is cut into runs of blocks from the same node, each run goes back with one ReturnBlocks
+    HAKLE_CPP20_CONSTEXPR void ReturnBlocks( BlockType* InBlock ) {
         while ( InBlock != nullptr ) {
-            BlockType* Next = InBlock->Next;
-            List.Add( InBlock );
-            InBlock = Next;
+            BlockType* Last = InBlock;
+            while ( Last->Next != nullptr && Last->Next->HomeNode == InBlock->HomeNode ) {
+                Last = Last->Next;
+            }
+            BlockType* Rest = Last->Next;
+            Last->Next      = nullptr;
+            Nodes[ InBlock->HomeNode % NodeCount() ].Manager.ReturnBlocks( InBlock );
+            InBlock = Rest;
+        }
+    }
+
+    // Node i of Other is adopted by node i % GetNodeCount(), which is where blocks Other handed out are returned
+    // NOTE: not thread safe, neither manager may be in use
+    HAKLE_CPP20_CONSTEXPR void AdoptBlocks( NumaBlockManager& Other ) {
+        if ( this == &Other ) {
+            return;
+        }
+        for ( std::size_t i = 0; i < Other.NodeCount(); ++i ) {
+            Nodes[ i % NodeCount() ].Manager.AdoptBlocks( Other.Nodes[ i ].Manager );
+        }
+    }
+
+    // Same as HakleBlockManager::Trim, TargetBytes is split evenly between the nodes
+    HAKLE_CPP20_CONSTEXPR std::size_t Trim( std::size_t TargetBytes = 0 ) noexcept {
+        std::size_t Released = 0;
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            Released += Nodes[ i ].Manager.Trim( TargetBytes / NodeCount() );
+        }
+        return Released;
+    }
+
+    // Same as HakleBlockManager::Maintain, the water marks are split evenly between the nodes.
+    // Slabs are allocated by the maintaining thread, so memory is only node local where first touch is not the policy.
+    HAKLE_CPP20_CONSTEXPR std::size_t Maintain( std::size_t LowWater, std::size_t HighWater = HakleBlockManager<BlockType, AllocatorType>::NoHighWater, std::size_t StaleRounds = 4 ) {
+        std::size_t Free = 0;
+        for ( std::size_t i = 0; i < NodeCount(); ++i ) {
+            Free += Nodes[ i ].Manager.Maintain( LowWater / NodeCount(), HighWater == HakleBlockManager<BlockType, AllocatorType>::NoHighWater ? HighWater : HighWater / NodeCount(), StaleRounds );
+        }
+        return Free;
+    }
+
+    // Reserves on the local node, that is where the calling thread requisitions first
+    HAKLE_CPP20_CONSTEXPR bool Reserve( std::size_t Count ) { return Nodes[ GetLocalNode() ].Manager.Reserve( Count ); }
+
+private:
+    // node managers sit on their own cache lines, threads of different nodes never share one
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) Node {
+        HAKLE_CPP20_CONSTEXPR Node( std::size_t InSize, const AllocatorType& InAllocator ) : Manager( InSize, InAllocator ) {}
+
+        HakleBlockManager<BlockType, AllocatorType> Manager;
+    };
+
+    using NodeAllocatorType   = typename BlockAllocatorTraits::template RebindAlloc<Node>;
+    using NodeAllocatorTraits = typename BlockAllocatorTraits::template RebindTraits<Node>;
+
+    // tags the chain with its node and links it after Last, returns its length
+    static HAKLE_CPP14_CONSTEXPR std::size_t Append( BlockType*& First, BlockType*& Last, BlockType* Chain, std::size_t From ) noexcept {
+        if ( Chain == nullptr ) {
+            return 0;
+        }
+        if ( Last == nullptr ) {
+            First = Chain;
+        }
+        else {
+            Last->Next = Chain;
+        }
+        std::size_t Count = 0;
+        for ( ; Chain != nullptr; Chain = Chain->Next ) {
+            Chain->HomeNode = static_cast<std::uint16_t>( From );
+            Last            = Chain;
+            ++Count;
+        }
+        return Count;
+    }
+
+    HAKLE_CPP20_CONSTEXPR void Clear() noexcept {
+        if ( Nodes == nullptr ) {
+            return;
+        }
+        NodeAllocatorTraits::Destroy( NodeAllocator(), Nodes, NodeCount() );
+        NodeAllocatorTraits::Deallocate( NodeAllocator(), Nodes, NodeCount() );
+        Nodes = nullptr;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
+        NodeCount() = 0;
+        Nodes       = nullptr;
+    }
+
+    HAKLE_CPP14_CONSTEXPR std::size_t&           NodeCount() noexcept { return NodeAllocatorPair.First(); }
+    HAKLE_NODISCARD constexpr const std::size_t& NodeCount() const noexcept { return NodeAllocatorPair.First(); }
+    HAKLE_CPP14_CONSTEXPR NodeAllocatorType&     NodeAllocator() noexcept { return NodeAllocatorPair.Second(); }
+
+    // compressed allocator
+    CompressPair<std::size_t, NodeAllocatorType> NodeAllocatorPair{};
+    Node*                                        Nodes{ nullptr };
+};
+
+// Handle to a block manager shared by many queues, so one pool serves all of them instead of one pool per queue.
+// Handles are reference counted: the constructor creates the manager, Share() hands out more handles to it and the last
+// handle to go destroys it. A queue returns the blocks it holds through its handle when it is destroyed, so the manager
+// always outlives them. Budgets and Trim are set through Get() and apply to every queue sharing the manager.
+template <HAKLE_CONCEPT( IsBlockManager ) INNER_MANAGER_TYPE>
+class SharedBlockManager : public BlockManagerBase<typename INNER_MANAGER_TYPE::BlockType, typename INNER_MANAGER_TYPE::AllocatorType> {
+public:
+    using InnerManagerType = INNER_MANAGER_TYPE;
+    using BaseManager      = BlockManagerBase<typename InnerManagerType::BlockType, typename InnerManagerType::AllocatorType>;
+    using AllocatorType    = typename BaseManager::AllocatorType;
+
+    using typename BaseManager::BlockAllocatorTraits;
+    using typename BaseManager::BlockType;
+    using typename BaseManager::ValueType;
+
+    using AllocMode = typename BaseManager::AllocMode;
+
+    // Creates a new shared manager, the arguments are those of InnerManagerType's constructor
+    template <class... Args>
+    HAKLE_CPP20_CONSTEXPR explicit SharedBlockManager( std::size_t InSize, const AllocatorType& InAllocator = AllocatorType{}, Args&&... InArgs ) : BaseManager( InAllocator ) {
+        SharedAllocatorType SharedAllocator( InAllocator );
+        State = SharedAllocatorTraits::Allocate( SharedAllocator );
+        HAKLE_TRY { SharedAllocatorTraits::Construct( SharedAllocator, State, InSize, InAllocator, std::forward<Args>( InArgs )... ); }
+        HAKLE_CATCH( ... ) {
+            SharedAllocatorTraits::Deallocate( SharedAllocator, State );
+            HAKLE_RETHROW;
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR ~SharedBlockManager() { Release(); }
+
+    HAKLE_CPP14_CONSTEXPR SharedBlockManager( SharedBlockManager&& Other ) noexcept : BaseManager( std::move( Other ) ), HAKLE_MOVE( State ) { Other.State = nullptr; }
+
+    HAKLE_CPP14_CONSTEXPR SharedBlockManager& operator=( SharedBlockManager&& Other ) noexcept {
+        if ( this != &Other ) {
+            Release();
+            BaseManager::operator=( std::move( Other ) );
+            HAKLE_OP_MOVE( State );
+            Other.State = nullptr;
         }
+        return *this;
+    }
+
+    SharedBlockManager( const SharedBlockManager& Other )            = delete;
+    SharedBlockManager& operator=( const SharedBlockManager& Other ) = delete;
+
+#if HAKLE_CPP_VERSION >= 20
+    HAKLE_CPP14_CONSTEXPR void swap( SharedBlockManager& Other ) noexcept HAKLE_REQUIRES( std::swappable<AllocatorType> ) {
+        BaseManager::swap( Other );
+        using std::swap;
+        HAKLE_SWAP( State );
     }
+#endif
+
+    // another handle to the same manager
+    HAKLE_NODISCARD HAKLE_CPP20_CONSTEXPR SharedBlockManager Share() const noexcept { return SharedBlockManager( State, this->Allocator() ); }
+
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR InnerManagerType&       Get() noexcept { return State->Manager; }
+    HAKLE_NODISCARD constexpr const InnerManagerType&             Get() const noexcept { return State->Manager; }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR bool                    IsSharedWith( const SharedBlockManager& Other ) const noexcept { return State == Other.State; }
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR std::size_t             GetUseCount() const noexcept { return State != nullptr ? State->Refs.load( std::memory_order_relaxed ) : 0; }
+    // storage of the shared manager, so every queue sharing it reports the same numbers
+    HAKLE_NODISCARD HAKLE_CPP14_CONSTEXPR BlockCounters GetCounters() const noexcept { return State->Manager.GetCounters(); }
+    HAKLE_NODISCARD MemoryStats                         GetMemoryStats() const noexcept { return State->Manager.GetMemoryStats(); }
+
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) { return State->Manager.RequisitionBlock( Mode ); }
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode Mode ) { return hakle::RequisitionBlocks( State->Manager, Count, Mode ); }
+    HAKLE_CPP20_CONSTEXPR void       ReturnBlock( BlockType* InBlock ) { State->Manager.ReturnBlock( InBlock ); }
+    HAKLE_CPP20_CONSTEXPR void       ReturnBlocks( BlockType* InBlock ) { State->Manager.ReturnBlocks( InBlock ); }
+    HAKLE_CPP20_CONSTEXPR bool       Reserve( std::size_t Count ) { return hakle::ReserveBlocks( State->Manager, Count ); }
+
+    // Blocks can only move between queues that share the manager, so there is nothing to adopt.
+    // Returns false for a different manager, which other queues may still be using.
+    HAKLE_CPP14_CONSTEXPR bool AdoptBlocks( SharedBlockManager& Other ) const noexcept { return IsSharedWith( Other ); }
 
 private:
-    BlockPool<BlockType, AllocatorType> Pool;
-    FreeList<BlockType, AllocatorType>  List;
+    struct SharedState {
+        template <class... Args>
+        HAKLE_CPP20_CONSTEXPR explicit SharedState( Args&&... InArgs ) : Manager( std::forward<Args>( InArgs )... ) {}
+
+        std::atomic<std::size_t> Refs{ 1 };
+        InnerManagerType         Manager;
+    };
+
+    using SharedAllocatorType   = typename BlockAllocatorTraits::template RebindAlloc<SharedState>;
+    using SharedAllocatorTraits = typename BlockAllocatorTraits::template RebindTraits<SharedState>;
+
+    HAKLE_CPP20_CONSTEXPR SharedBlockManager( SharedState* InState, const AllocatorType& InAllocator ) noexcept : BaseManager( InAllocator ), State( InState ) {
+        State->Refs.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    HAKLE_CPP20_CONSTEXPR void Release() noexcept {
+        if ( State != nullptr && State->Refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+            SharedAllocatorType SharedAllocator( this->Allocator() );
+            SharedAllocatorTraits::Destroy( SharedAllocator, State );
+            SharedAllocatorTraits::Deallocate( SharedAllocator, State );
+        }
+        State = nullptr;
+    }
+
+    SharedState* State{ nullptr };
 };
 
 #if HAKLE_CPP_VERSION >= 20
@@ -495,13 +2962,28 @@ inline HAKLE_CPP14_CONSTEXPR void swap( HakleBlockManager<BLOCK_TYPE, ALLOCATOR_
     lhs.swap( rhs );
 }
 
+template <class BLOCK_TYPE, HAKLE_CONCEPT( std::swappable ) ALLOCATOR_TYPE, std::size_t MAGAZINE_SIZE>
+inline HAKLE_CPP14_CONSTEXPR void swap( MagazineBlockManager<BLOCK_TYPE, ALLOCATOR_TYPE, MAGAZINE_SIZE>& lhs, MagazineBlockManager<BLOCK_TYPE, ALLOCATOR_TYPE, MAGAZINE_SIZE>& rhs ) noexcept HAKLE_SWAP_REQUIES {
+    lhs.swap( rhs );
+}
+
+template <class BLOCK_TYPE, HAKLE_CONCEPT( std::swappable ) ALLOCATOR_TYPE>
+inline HAKLE_CPP14_CONSTEXPR void swap( NumaBlockManager<BLOCK_TYPE, ALLOCATOR_TYPE>& lhs, NumaBlockManager<BLOCK_TYPE, ALLOCATOR_TYPE>& rhs ) noexcept HAKLE_SWAP_REQUIES {
+    lhs.swap( rhs );
+}
+
+template <class INNER_MANAGER_TYPE>
+inline HAKLE_CPP14_CONSTEXPR void swap( SharedBlockManager<INNER_MANAGER_TYPE>& lhs, SharedBlockManager<INNER_MANAGER_TYPE>& rhs ) noexcept {
+    lhs.swap( rhs );
+}
+
 #endif
 
 template <class T, std::size_t BLOCK_SIZE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<HakleFlagsBlock<T, BLOCK_SIZE>>>
-using HakleFlagsBlockManager = HakleBlockManager<HakleFlagsBlock<T, BLOCK_SIZE>>;
+using HakleFlagsBlockManager = HakleBlockManager<HakleFlagsBlock<T, BLOCK_SIZE>, ALLOCATOR_TYPE>;
 
 template <class T, std::size_t BLOCK_SIZE, HAKLE_CONCEPT( IsAllocator ) ALLOCATOR_TYPE = HakleAllocator<HakleCounterBlock<T, BLOCK_SIZE>>>
-using HakleCounterBlockManager = HakleBlockManager<HakleCounterBlock<T, BLOCK_SIZE>>;
+using HakleCounterBlockManager = HakleBlockManager<HakleCounterBlock<T, BLOCK_SIZE>, ALLOCATOR_TYPE>;
 
 inline constexpr std::size_t HAKLE_DEFAULT_POOL_SIZE = 1024;
 
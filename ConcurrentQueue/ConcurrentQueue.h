@@ -18,6 +18,20 @@
 #include <concepts>
 #endif
 
+#if defined( __linux__ )
+#include <sched.h>
+#if defined( __has_include )
+#if __has_include( <sys/rseq.h> )
+#include <sys/rseq.h>
+#endif
+#endif
+#if defined( RSEQ_SIG ) && defined( __has_builtin )
+#if __has_builtin( __builtin_thread_pointer )
+#define HAKLE_HAS_RSEQ 1
+#endif
+#endif
+#endif
+
 #include "BlockManager.h"
 #include "ConcurrentQueue/Block.h"
 #include "ConcurrentQueue/HashTable.h"
@@ -33,6 +47,33 @@ namespace details {
     static const thread_id_t invalid_thread_id;
     inline thread_id_t       thread_id() noexcept { return std::this_thread::get_id(); }
     using thread_hash = std::hash<std::thread::id>;
+
+    // Number of CPUs the per-CPU producers are spread over, fixed for the lifetime of the process
+    inline std::size_t cpu_count() noexcept {
+        static const std::size_t count = std::max<std::size_t>( std::thread::hardware_concurrency(), 1 );
+        return count;
+    }
+
+    // CPU the calling thread is running on; only a hint, the thread may migrate right after
+    inline std::size_t current_cpu() noexcept {
+#ifdef HAKLE_HAS_RSEQ
+        // glibc registers rseq for every thread, the kernel keeps cpu_id up to date on each migration
+        if ( __rseq_size > 0 ) {
+            const volatile struct rseq* area = reinterpret_cast<const volatile struct rseq*>( static_cast<char*>( __builtin_thread_pointer() ) + __rseq_offset );
+            std::int32_t                cpu  = static_cast<std::int32_t>( area->cpu_id );
+            if ( cpu >= 0 ) {
+                return static_cast<std::size_t>( cpu );
+            }
+        }
+#endif
+#if defined( __linux__ )
+        int cpu = sched_getcpu();
+        if ( cpu >= 0 ) {
+            return static_cast<std::size_t>( cpu );
+        }
+#endif
+        return thread_hash{}( thread_id() );
+    }
 }  // namespace details
 
 #ifdef HAKLE_USE_CONCEPT
@@ -73,6 +114,36 @@ concept HasMakeImplicitBlockManager = HasMakeImplicitBlockManagerHelper<Traits>:
 
 #endif
 
+template <class Traits, class = void>
+struct SingleAllocationProducersHelper : std::false_type {};
+
+template <class Traits>
+struct SingleAllocationProducersHelper<Traits, std::void_t<decltype( Traits::SingleAllocationProducers )>> : std::bool_constant<Traits::SingleAllocationProducers> {};
+
+template <class Traits, class = void>
+struct PerCpuProducersHelper : std::false_type {};
+
+template <class Traits>
+struct PerCpuProducersHelper<Traits, std::void_t<decltype( Traits::PerCpuProducers )>> : std::bool_constant<Traits::PerCpuProducers> {};
+
+template <class Traits, class = void>
+struct NoRuntimeAllocationHelper : std::false_type {};
+
+template <class Traits>
+struct NoRuntimeAllocationHelper<Traits, std::void_t<decltype( Traits::NoRuntimeAllocation )>> : std::bool_constant<Traits::NoRuntimeAllocation> {};
+
+template <class Traits, class = void>
+struct MaxBlocksPerProducerHelper : std::integral_constant<std::size_t, 0> {};
+
+template <class Traits>
+struct MaxBlocksPerProducerHelper<Traits, std::void_t<decltype( Traits::MaxBlocksPerProducer )>> : std::integral_constant<std::size_t, Traits::MaxBlocksPerProducer> {};
+
+template <class Traits, class = void>
+struct MaxIdleBlocksPerProducerHelper : std::integral_constant<std::size_t, 0> {};
+
+template <class Traits>
+struct MaxIdleBlocksPerProducerHelper<Traits, std::void_t<decltype( Traits::MaxIdleBlocksPerProducer )>> : std::integral_constant<std::size_t, Traits::MaxIdleBlocksPerProducer> {};
+
 struct _QueueTypelessBase {};
 
 // TODO: manager traits
@@ -94,12 +165,14 @@ public:
     constexpr explicit _QueueBase( const ValueAllocatorType& InAllocator = ValueAllocatorType{} ) noexcept : ValueAllocatorPair( nullptr, InAllocator ) {}
     HAKLE_CPP20_CONSTEXPR ~_QueueBase() = default;
 
-    HAKLE_CPP14_CONSTEXPR _QueueBase( _QueueBase&& Other ) noexcept : HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_ATOMIC, HeadIndex, TailIndex, DequeueAttemptsCount, DequeueFailedCount ), HAKLE_MOVE( ValueAllocatorPair ) {}
+    HAKLE_CPP14_CONSTEXPR _QueueBase( _QueueBase&& Other ) noexcept
+        : HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_ATOMIC, HeadIndex, TailIndex, DequeueAttemptsCount, DequeueFailedCount ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, ValueAllocatorPair, BlockQuota ),
+          HAKLE_MOVE_ATOMIC( IndexBytes ) {}
 
     HAKLE_CPP14_CONSTEXPR _QueueBase& operator=( _QueueBase&& Other ) noexcept {
         if ( this != &Other ) {
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, HeadIndex, TailIndex, DequeueAttemptsCount, DequeueFailedCount );
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, ValueAllocatorPair );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, HeadIndex, TailIndex, DequeueAttemptsCount, DequeueFailedCount, IndexBytes );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, ValueAllocatorPair, BlockQuota );
         }
         return *this;
     }
@@ -109,14 +182,15 @@ public:
         TailIndex.store( 0, std::memory_order_relaxed );
         DequeueAttemptsCount.store( 0, std::memory_order_relaxed );
         DequeueFailedCount.store( 0, std::memory_order_relaxed );
+        IndexBytes.store( 0, std::memory_order_relaxed );
         TailBlock() = nullptr;
     }
 
 #if HAKLE_CPP_VERSION >= 20
     HAKLE_CPP14_CONSTEXPR void swap( _QueueBase& Other ) noexcept HAKLE_REQUIRES( std::swappable<ValueAllocatorType> ) {
-        HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, HeadIndex, TailIndex, DequeueAttemptsCount, DequeueFailedCount );
+        HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, HeadIndex, TailIndex, DequeueAttemptsCount, DequeueFailedCount, IndexBytes );
         using std::swap;
-        HAKLE_SWAP( ValueAllocatorPair );
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, ValueAllocatorPair, BlockQuota );
     }
 #endif
 
@@ -131,12 +205,44 @@ public:
 
     HAKLE_NODISCARD constexpr std::size_t GetTail() const noexcept { return TailIndex.load( std::memory_order_relaxed ); }
 
+    static constexpr std::size_t NoBlockQuota = static_cast<std::size_t>( -1 );
+
+    // Most blocks the producer may hold from its block manager at once, so one runaway producer cannot drain a manager
+    // shared with the others. Enqueues that would need more fail like CannotAlloc ones.
+    // NOTE: producer only, like Enqueue
+    HAKLE_CPP14_CONSTEXPR void            SetBlockQuota( std::size_t InQuota ) noexcept { BlockQuota = InQuota; }
+    HAKLE_NODISCARD constexpr std::size_t GetBlockQuota() const noexcept { return BlockQuota; }
+
 protected:
+    // Consumers pin an epoch while they look a block up in the index arrays. The producer stamps a superseded array
+    // with the epoch after it published the new one and frees it once the epoch moved two steps past that. Pins are
+    // sharded by thread, so the consumers of a producer do not bounce one counter, and an epoch only waits for guards
+    // taken before it, so arrays are freed while consumers keep running. All producers of one queue type share the epochs.
+    using IndexReadGuard = EpochPins::Guard;
+
+    static EpochPins& IndexEpochs() noexcept {
+        static EpochPins Pins;
+        return Pins;
+    }
+
+    // Producer only: whether arrays superseded at RetireEpoch can be freed, moving the epoch on if needed
+    HAKLE_NODISCARD static bool CanFreeIndex( std::uint64_t RetireEpoch ) noexcept {
+        EpochPins&    Pins  = IndexEpochs();
+        std::uint64_t Epoch = Pins.GetEpoch();
+        for ( int i = 0; i < 2 && !EpochPins::CanFree( RetireEpoch, Epoch ); ++i ) {
+            Epoch = Pins.TryAdvance();
+        }
+        return EpochPins::CanFree( RetireEpoch, Epoch );
+    }
+
     std::atomic<std::size_t>                     HeadIndex{};
     std::atomic<std::size_t>                     TailIndex{};
     std::atomic<std::size_t>                     DequeueAttemptsCount{};
     std::atomic<std::size_t>                     DequeueFailedCount{};
     CompressPair<BlockType*, ValueAllocatorType> ValueAllocatorPair{};
+    std::size_t                                  BlockQuota{ NoBlockQuota };
+    // bytes of the block index arrays allocated by the producer, not counting inline storage
+    std::atomic<std::size_t> IndexBytes{};
 
     HAKLE_CPP14_CONSTEXPR ValueAllocatorType& ValueAllocator() noexcept { return ValueAllocatorPair.Second(); }
     constexpr const ValueAllocatorType&       ValueAllocator() const noexcept { return ValueAllocatorPair.Second(); }
@@ -174,6 +280,17 @@ private:
     using IndexEntryArrayAllocatorTraits = typename ValueAllocatorTraits::template RebindTraits<IndexEntryArray>;
 
 public:
+    // First index array and first block, to be placed in the same allocation as the queue itself.
+    // InitialSize is the InSize the queue would otherwise be constructed with.
+    template <std::size_t InitialSize>
+    struct InlineStorage {
+        static constexpr std::size_t EntryCount = CeilToPow2( InitialSize ) < 4 ? 4 : CeilToPow2( InitialSize );
+
+        IndexEntryArray Array{};
+        IndexEntry      Entries[ EntryCount ]{};
+        BlockType       Block{};
+    };
+
     explicit HAKLE_CPP14_CONSTEXPR FastQueue( std::size_t InSize, BlockManagerType* InBlockManager = &GetBlockManager<BlockManagerType>(), const ValueAllocatorType& InAllocator = ValueAllocatorType{} ) noexcept
         : Base( InAllocator ), BlockManager( InBlockManager ), IndexEntryAllocatorPair( 0, IndexEntryAllocatorType( InAllocator ) ), IndexEntryArrayAllocatorPair( 0, IndexEntryArrayAllocatorType( InAllocator ) ) {
         std::size_t InitialSize = CeilToPow2( InSize ) >> 1;
@@ -185,10 +302,31 @@ public:
         CreateNewBlockIndexArray( 0 );
     }
 
+    // Uses Storage instead of allocating the first index array and requisitioning the first block.
+    // Storage must outlive the queue, the inline block is never handed to the block manager.
+    template <std::size_t InitialSize>
+    HAKLE_CPP14_CONSTEXPR FastQueue( InlineStorage<InitialSize>& Storage, BlockManagerType* InBlockManager, const ValueAllocatorType& InAllocator = ValueAllocatorType{} ) noexcept
+        : Base( InAllocator ), BlockManager( InBlockManager ), PO_PrevEntries( Storage.Entries ), IndexEntryAllocatorPair( 1, IndexEntryAllocatorType( InAllocator ) ),
+          IndexEntryArrayAllocatorPair( InlineStorage<InitialSize>::EntryCount, IndexEntryArrayAllocatorType( InAllocator ) ), InlineBlock( &Storage.Block ), InlineIndexEntryArray( &Storage.Array ) {
+        // same state as CreateNewBlockIndexArray( 0 ) leaves behind
+        Storage.Array.Size    = PO_IndexEntriesSize();
+        Storage.Array.Entries = Storage.Entries;
+        Storage.Array.Tail.store( static_cast<std::size_t>( -1 ), std::memory_order_relaxed );
+        CurrentIndexEntryArray.store( &Storage.Array, std::memory_order_relaxed );
+
+        // the inline block waits in the ring like a reserved one
+        Storage.Block.SetAllEmpty();
+        Storage.Block.Next = &Storage.Block;
+        this->TailBlock()  = &Storage.Block;
+    }
+
     HAKLE_CPP20_CONSTEXPR ~FastQueue() noexcept { Clear(); }
 
     HAKLE_CPP14_CONSTEXPR FastQueue( FastQueue&& Other ) noexcept
-        : Base( std::move( Other ) ), HAKLE_MOVE_ATOMIC( CurrentIndexEntryArray ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, BlockManager, PO_NextIndexEntry, PO_PrevEntries, IndexEntryAllocatorPair, IndexEntryArrayAllocatorPair ) {
+        : Base( std::move( Other ) ), HAKLE_MOVE_ATOMIC( CurrentIndexEntryArray ),
+          HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, BlockManager, PO_NextIndexEntry, PO_PrevEntries, IndexEntryAllocatorPair, IndexEntryArrayAllocatorPair, InlineBlock, InlineIndexEntryArray, ShrinkHighWater,
+                                ShrinkLowWater ),
+          HAKLE_MOVE_ATOMIC( HeldBlocks ) {
         Other.Reset();
     }
 
@@ -197,7 +335,9 @@ public:
             Clear();
             Base::operator=( std::move( Other ) );
             HAKLE_OP_MOVE_ATOMIC( CurrentIndexEntryArray );
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, BlockManager, PO_NextIndexEntry, PO_PrevEntries, IndexEntryAllocatorPair, IndexEntryArrayAllocatorPair );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, BlockManager, PO_NextIndexEntry, PO_PrevEntries, IndexEntryAllocatorPair, IndexEntryArrayAllocatorPair, InlineBlock, InlineIndexEntryArray, ShrinkHighWater,
+                            ShrinkLowWater );
+            HAKLE_OP_MOVE_ATOMIC( HeldBlocks );
             Other.Reset();
         }
         return *this;
@@ -238,25 +378,25 @@ public:
             } while ( Block != this->TailBlock() );
         }
 
-        // let's return block to manager
+        // let's return block to manager, the ring is relinked into one chain so it goes back in a single call
         if ( this->TailBlock() != nullptr ) {
-            BlockType* Block = this->TailBlock();
+            BlockType* Block    = this->TailBlock();
+            BlockType* Returned = nullptr;
             do {
                 BlockType* NextBlock = Block->Next;
-                BlockManager->ReturnBlock( Block );
+                if ( Block != InlineBlock ) {
+                    Block->Next = Returned;
+                    Returned    = Block;
+                }
                 Block = NextBlock;
             } while ( Block != this->TailBlock() );
+            if ( Returned != nullptr ) {
+                BlockManager->ReturnBlocks( Returned );
+            }
         }
 
         // delete index entry arrays
-        IndexEntryArray* Current = CurrentIndexEntryArray.load( std::memory_order_relaxed );
-        while ( Current != nullptr ) {
-            IndexEntryArray* Prev = Current->Prev;
-            IndexEntryAllocatorTraits::Deallocate( IndexEntryAllocator(), Current->Entries, Current->Size );
-            IndexEntryArrayAllocatorTraits::Destroy( IndexEntryArrayAllocator(), Current );
-            IndexEntryArrayAllocatorTraits::Deallocate( IndexEntryArrayAllocator(), Current );
-            Current = Prev;
-        }
+        FreeIndexEntryArrays( CurrentIndexEntryArray.load( std::memory_order_relaxed ) );
     }
 
     HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
@@ -267,17 +407,118 @@ public:
         PO_PrevEntries        = nullptr;
         PO_IndexEntriesUsed() = 0;
         PO_IndexEntriesSize() = 0;
+        InlineBlock           = nullptr;
+        InlineIndexEntryArray = nullptr;
+        ShrinkHighWater       = NoShrink;
+        ShrinkLowWater        = 0;
+        HeldBlocks.store( 0, std::memory_order_relaxed );
     }
 
 #if HAKLE_CPP_VERSION >= 20
     HAKLE_CPP14_CONSTEXPR void swap( FastQueue& Other ) noexcept HAKLE_REQUIRES( std::swappable<IndexEntryAllocatorType>&& std::swappable<IndexEntryArrayAllocatorType> ) {
         Base::swap( Other );
         HAKLE_SWAP_ATOMIC( CurrentIndexEntryArray );
+        HAKLE_SWAP_ATOMIC( HeldBlocks );
         using std::swap;
-        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, BlockManager, PO_NextIndexEntry, PO_PrevEntries, IndexEntryAllocatorPair, IndexEntryArrayAllocatorPair );
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, BlockManager, PO_NextIndexEntry, PO_PrevEntries, IndexEntryAllocatorPair, IndexEntryArrayAllocatorPair, InlineBlock, InlineIndexEntryArray, ShrinkHighWater,
+                        ShrinkLowWater );
     }
 #endif
 
+    // Blocks the ring took from the block manager, the index arrays and the queue object. Inline storage is counted by
+    // whoever holds it. Any thread may ask, the numbers can lag behind a producer running at the same time.
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept {
+        MemoryStats Stats;
+        Stats.ProducerBlockBytes = HeldBlocks.load( std::memory_order_relaxed ) * sizeof( BlockType );
+        Stats.IndexBytes         = this->IndexBytes.load( std::memory_order_relaxed );
+        Stats.ProducerBytes      = sizeof( FastQueue );
+        return Stats;
+    }
+
+    // NOTE: This is intentionally not thread safe; only used when the owner of the block manager is moved.
+    HAKLE_CPP14_CONSTEXPR void SetBlockManager( BlockManagerType* InBlockManager ) noexcept { BlockManager = InBlockManager; }
+
+    static constexpr std::size_t NoShrink = static_cast<std::size_t>( -1 );
+
+    // Returns the empty blocks waiting after the tail block to the block manager, except KeepBlocks of them (the inline
+    // block counts as kept) for the next enqueues. Returns the number of blocks released.
+    // Those blocks are the oldest of the ring and every element in them has been dequeued, so no index entry a consumer
+    // can still look up points at them; dropping them only shrinks the window of entries the producer keeps.
+    // NOTE: producer only, like Enqueue
+    HAKLE_CPP20_CONSTEXPR std::size_t ShrinkToFit( std::size_t KeepBlocks = 0 ) {
+        if ( this->TailBlock() == nullptr ) {
+            return 0;
+        }
+
+        BlockType*  Prev     = this->TailBlock();
+        BlockType*  Released = nullptr;
+        std::size_t Kept     = 0;
+        std::size_t Count    = 0;
+        while ( Prev->Next != this->TailBlock() && Prev->Next->IsEmpty() ) {
+            BlockType* Block = Prev->Next;
+            if ( Block == InlineBlock || Kept < KeepBlocks ) {
+                ++Kept;
+                Prev = Block;
+                continue;
+            }
+            Prev->Next  = Block->Next;
+            Block->Next = Released;
+            Released    = Block;
+            ++Count;
+        }
+
+        if ( Released != nullptr ) {
+            PO_IndexEntriesUsed() -= Count;
+            HeldBlocks.fetch_sub( Count, std::memory_order_relaxed );
+            BlockManager->ReturnBlocks( Released );
+        }
+        return Count;
+    }
+
+    // Hysteresis for ShrinkToFit: when an enqueue crosses a block boundary while more than HighWater blocks sit idle
+    // in the ring, the ring is shrunk back to LowWater idle blocks. NoShrink turns it off.
+    // NOTE: producer only, like Enqueue
+    HAKLE_CPP14_CONSTEXPR void SetShrinkPolicy( std::size_t HighWater, std::size_t LowWater ) noexcept {
+        ShrinkHighWater = HighWater;
+        ShrinkLowWater  = std::min( LowWater, HighWater );
+    }
+    HAKLE_NODISCARD constexpr std::size_t GetShrinkHighWater() const noexcept { return ShrinkHighWater; }
+    HAKLE_NODISCARD constexpr std::size_t GetShrinkLowWater() const noexcept { return ShrinkLowWater; }
+
+    // Links enough empty blocks into the ring (and grows the index) to hold Count elements without allocating.
+    // NOTE: producer only, like Enqueue
+    HAKLE_CPP20_CONSTEXPR bool Reserve( std::size_t Count ) {
+        // one more block for the partially dequeued head block
+        std::size_t BlockCount = ( ( Count + BlockSize - 1 ) >> BlockSizeLog2 ) + 1;
+        while ( PO_IndexEntriesUsed() < BlockCount ) {
+            if ( PO_IndexEntriesUsed() == PO_IndexEntriesSize() && !CreateNewBlockIndexArray( PO_IndexEntriesUsed() ) ) {
+                return false;
+            }
+
+            if HAKLE_UNLIKELY ( PO_IndexEntriesUsed() >= this->BlockQuota ) {
+                return false;
+            }
+            BlockType* NewBlock = BlockManager->RequisitionBlock( AllocMode::CanAlloc );
+            if HAKLE_UNLIKELY ( NewBlock == nullptr ) {
+                return false;
+            }
+
+            // empty blocks right after the tail block are picked up by Enqueue without touching the block manager
+            NewBlock->SetAllEmpty();
+            if ( this->TailBlock() == nullptr ) {
+                NewBlock->Next    = NewBlock;
+                this->TailBlock() = NewBlock;
+            }
+            else {
+                NewBlock->Next          = this->TailBlock()->Next;
+                this->TailBlock()->Next = NewBlock;
+            }
+            ++PO_IndexEntriesUsed();
+            HeldBlocks.fetch_add( 1, std::memory_order_relaxed );
+        }
+        return true;
+    }
+
     // Enqueue, SPMC queue only supports one producer
     template <AllocMode Mode, class... Args>
     HAKLE_REQUIRES( std::is_constructible_v<ValueType, Args&&...> )
@@ -286,6 +527,11 @@ public:
         std::size_t NewTailIndex     = CurrentTailIndex + 1;
         std::size_t InnerIndex       = CurrentTailIndex & ( BlockSize - 1 );
         if HAKLE_UNLIKELY ( InnerIndex == 0 ) {
+            ReclaimIndexEntryArrays();
+            if HAKLE_UNLIKELY ( ShrinkHighWater != NoShrink ) {
+                MaybeShrink( CurrentTailIndex );
+            }
+
             BlockType* OldTailBlock = this->TailBlock();
             // zero, in fact
             // we must find a new block
@@ -309,6 +555,10 @@ public:
                     }
                 }
 
+                // the ring only grows, its size is the number of blocks held
+                if HAKLE_UNLIKELY ( PO_IndexEntriesUsed() >= this->BlockQuota ) {
+                    return false;
+                }
                 BlockType* NewBlock = BlockManager->RequisitionBlock( Mode );
                 if HAKLE_UNLIKELY ( NewBlock == nullptr ) {
                     return false;
@@ -325,6 +575,7 @@ public:
                 this->TailBlock() = NewBlock;
                 // get a new block
                 ++PO_IndexEntriesUsed();
+                HeldBlocks.fetch_add( 1, std::memory_order_relaxed );
             }
 
             IndexEntry& Entry = this->CurrentIndexEntryArray.load( std::memory_order_relaxed )->Entries[ PO_NextIndexEntry ];
@@ -361,6 +612,11 @@ public:
     template <AllocMode Mode, HAKLE_CONCEPT( std::input_iterator ) Iterator>
     HAKLE_REQUIRES( requires( Iterator Item ) { ValueType( *Item ); } )
     HAKLE_CPP20_CONSTEXPR bool EnqueueBulk( Iterator ItemFirst, std::size_t Count ) {
+        ReclaimIndexEntryArrays();
+        if HAKLE_UNLIKELY ( ShrinkHighWater != NoShrink ) {
+            MaybeShrink( this->TailIndex.load( std::memory_order_relaxed ) );
+        }
+
         // set original state
         std::size_t OriginIndexEntriesUsed = PO_IndexEntriesUsed();
         std::size_t OriginNextIndexEntry   = PO_NextIndexEntry;
@@ -398,6 +654,15 @@ public:
                 PO_NextIndexEntry = ( PO_NextIndexEntry + 1 ) & ( PO_IndexEntriesSize() - 1 );
             }
 
+            // the remaining blocks are requisitioned in one go, whatever is left over goes back on failure
+            BlockType* SpareBlocks   = nullptr;
+            auto       RollBackSpare = [ this, &SpareBlocks, &RollBack ]() -> void {
+                if ( SpareBlocks != nullptr ) {
+                    BlockManager->ReturnBlocks( SpareBlocks );
+                }
+                RollBack();
+            };
+
             while ( BlockCountNeed > 0 ) {
                 // we must get a new block
                 --BlockCountNeed;
@@ -405,29 +670,37 @@ public:
 
                 // TODO: add MAX_SIZE check
                 if HAKLE_UNLIKELY ( !CircularLessThan( this->HeadIndex.load( std::memory_order_relaxed ), CurrentTailIndex + BlockSize ) ) {
-                    RollBack();
+                    RollBackSpare();
                     return false;
                 }
 
                 if HAKLE_UNLIKELY ( CurrentIndexEntryArray.load( std::memory_order_relaxed ) == nullptr || PO_IndexEntriesUsed() == PO_IndexEntriesSize() ) {
                     // need to create a new index entry array
                     HAKLE_CONSTEXPR_IF( Mode == AllocMode::CannotAlloc ) {
-                        RollBack();
+                        RollBackSpare();
                         return false;
                     }
                     else if ( !CreateNewBlockIndexArray( OriginIndexEntriesUsed ) ) {
-                        RollBack();
+                        RollBackSpare();
                         return false;
                     }
 
                     OriginNextIndexEntry = OriginIndexEntriesUsed;
                 }
 
-                BlockType* NewBlock = BlockManager->RequisitionBlock( Mode );
+                if HAKLE_UNLIKELY ( PO_IndexEntriesUsed() >= this->BlockQuota ) {
+                    RollBackSpare();
+                    return false;
+                }
+                if ( SpareBlocks == nullptr ) {
+                    SpareBlocks = RequisitionBlocks( *BlockManager, std::min( BlockCountNeed + 1, this->BlockQuota - PO_IndexEntriesUsed() ), Mode );
+                }
+                BlockType* NewBlock = SpareBlocks;
                 if HAKLE_UNLIKELY ( NewBlock == nullptr ) {
                     RollBack();
                     return false;
                 }
+                SpareBlocks = NewBlock->Next;
 
                 NewBlock->Reset();
                 if ( this->TailBlock() == nullptr ) {
@@ -441,6 +714,7 @@ public:
                 FirstAllocatedBlock = FirstAllocatedBlock == nullptr ? this->TailBlock() : FirstAllocatedBlock;
                 // get a new block
                 ++PO_IndexEntriesUsed();
+                HeldBlocks.fetch_add( 1, std::memory_order_relaxed );
 
                 auto& Entry       = this->CurrentIndexEntryArray.load( std::memory_order_relaxed )->Entries[ PO_NextIndexEntry ];
                 Entry.Base        = CurrentTailIndex;
@@ -539,14 +813,8 @@ public:
                 std::size_t InnerIndex = Index & ( BlockSize - 1 );
 
                 // we can dequeue
-                IndexEntryArray* LocalIndexEntryArray = this->CurrentIndexEntryArray.load( std::memory_order_acquire );
-                std::size_t      LocalIndexEntryIndex = LocalIndexEntryArray->Tail.load( std::memory_order_acquire );
-
-                std::size_t IndexEntryTailBase  = LocalIndexEntryArray->Entries[ LocalIndexEntryIndex ].Base;
-                std::size_t FirstBlockIndexBase = Index & ~( BlockSize - 1 );
-                std::size_t Offset              = ( FirstBlockIndexBase - IndexEntryTailBase ) >> BlockSizeLog2;
-                BlockType*  DequeueBlock        = LocalIndexEntryArray->Entries[ ( LocalIndexEntryIndex + Offset ) & ( LocalIndexEntryArray->Size - 1 ) ].InnerBlock;
-                ValueType&  Value               = *( *DequeueBlock )[ InnerIndex ];
+                BlockType* DequeueBlock = GetBlockForIndex( Index );
+                ValueType& Value        = *( *DequeueBlock )[ InnerIndex ];
 
                 HAKLE_CONSTEXPR_IF( !std::is_nothrow_assignable<U&, ValueType&&>::value ) {
                     struct Guard {
@@ -597,15 +865,8 @@ public:
                 std::size_t FirstIndex = this->HeadIndex.fetch_add( ActualCount, std::memory_order_relaxed );
                 std::size_t InnerIndex = FirstIndex & ( BlockSize - 1 );
 
-                IndexEntryArray* LocalIndexEntriesArray = this->CurrentIndexEntryArray.load( std::memory_order_acquire );
-                std::size_t      LocalIndexEntryIndex   = LocalIndexEntriesArray->Tail.load( std::memory_order_acquire );
-
-                std::size_t IndexEntryTailBase  = LocalIndexEntriesArray->Entries[ LocalIndexEntryIndex ].Base;
-                std::size_t FirstBlockIndexBase = FirstIndex & ~( BlockSize - 1 );
-                std::size_t Offset              = ( FirstBlockIndexBase - IndexEntryTailBase ) >> BlockSizeLog2;
-                BlockType*  FirstDequeueBlock   = LocalIndexEntriesArray->Entries[ ( LocalIndexEntryIndex + Offset ) & ( LocalIndexEntriesArray->Size - 1 ) ].InnerBlock;
-
-                BlockType*  DequeueBlock = FirstDequeueBlock;
+                // later blocks are reached through the ring
+                BlockType*  DequeueBlock = GetBlockForIndex( FirstIndex );
                 std::size_t StartIndex   = InnerIndex;
                 std::size_t NeedCount    = ActualCount;
                 while ( NeedCount != 0 ) {
@@ -676,8 +937,55 @@ private:
         std::atomic<std::size_t> Tail{};
         IndexEntry*              Entries{ nullptr };
         IndexEntryArray*         Prev{ nullptr };
+        // epoch at which the next array superseded this one
+        std::uint64_t RetireEpoch{ 0 };
     };
 
+    // NOTE: getting HeadIndex must be front of this, see Dequeue
+    HAKLE_CPP20_CONSTEXPR BlockType* GetBlockForIndex( std::size_t Index ) const noexcept {
+        typename Base::IndexReadGuard Guard( Base::IndexEpochs() );
+
+        IndexEntryArray* LocalIndexEntryArray = this->CurrentIndexEntryArray.load( std::memory_order_seq_cst );
+        std::size_t      LocalIndexEntryIndex = LocalIndexEntryArray->Tail.load( std::memory_order_acquire );
+
+        std::size_t IndexEntryTailBase  = LocalIndexEntryArray->Entries[ LocalIndexEntryIndex ].Base;
+        std::size_t FirstBlockIndexBase = Index & ~( BlockSize - 1 );
+        std::size_t Offset              = ( FirstBlockIndexBase - IndexEntryTailBase ) >> BlockSizeLog2;
+        return LocalIndexEntryArray->Entries[ ( LocalIndexEntryIndex + Offset ) & ( LocalIndexEntryArray->Size - 1 ) ].InnerBlock;
+    }
+
+    // Frees the arrays superseded by the current one once no consumer can still be reading them, the newest of them
+    // was retired last
+    HAKLE_CPP20_CONSTEXPR void ReclaimIndexEntryArrays() noexcept {
+        IndexEntryArray* Current = CurrentIndexEntryArray.load( std::memory_order_relaxed );
+        if ( Current != nullptr && Current->Prev != nullptr && Base::CanFreeIndex( Current->Prev->RetireEpoch ) ) {
+            FreeIndexEntryArrays( Current->Prev );
+            Current->Prev = nullptr;
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR void FreeIndexEntryArrays( IndexEntryArray* Current ) noexcept {
+        while ( Current != nullptr ) {
+            IndexEntryArray* Prev = Current->Prev;
+            if ( Current != InlineIndexEntryArray ) {
+                this->IndexBytes.fetch_sub( sizeof( IndexEntryArray ) + Current->Size * sizeof( IndexEntry ), std::memory_order_relaxed );
+                IndexEntryAllocatorTraits::Deallocate( IndexEntryAllocator(), Current->Entries, Current->Size );
+                IndexEntryArrayAllocatorTraits::Destroy( IndexEntryArrayAllocator(), Current );
+                IndexEntryArrayAllocatorTraits::Deallocate( IndexEntryArrayAllocator(), Current );
+            }
+            Current = Prev;
+        }
+    }
+
+    // idle blocks are estimated from the indices, ShrinkToFit itself only releases blocks that are really empty
+    HAKLE_CPP20_CONSTEXPR void MaybeShrink( std::size_t CurrentTailIndex ) {
+        std::size_t Head  = this->HeadIndex.load( std::memory_order_relaxed );
+        std::size_t InUse = CircularLessThan( Head, CurrentTailIndex ) ? ( ( CurrentTailIndex - Head + BlockSize - 1 ) >> BlockSizeLog2 ) + 1 : 1;
+        if ( PO_IndexEntriesUsed() > InUse + ShrinkHighWater ) {
+            ShrinkToFit( ShrinkLowWater );
+        }
+    }
+
     HAKLE_CPP20_CONSTEXPR bool CreateNewBlockIndexArray( std::size_t FilledSlot ) noexcept {
         std::size_t SizeMask = PO_IndexEntriesSize() - 1;
 
@@ -717,7 +1025,12 @@ private:
 
         PO_NextIndexEntry = j;
         PO_PrevEntries    = NewEntries;
-        CurrentIndexEntryArray.store( NewIndexEntryArray, std::memory_order_release );
+        this->IndexBytes.fetch_add( sizeof( IndexEntryArray ) + PO_IndexEntriesSize() * sizeof( IndexEntry ), std::memory_order_relaxed );
+        CurrentIndexEntryArray.store( NewIndexEntryArray, std::memory_order_seq_cst );
+        if ( NewIndexEntryArray->Prev != nullptr ) {
+            NewIndexEntryArray->Prev->RetireEpoch = Base::IndexEpochs().GetEpoch();
+        }
+        ReclaimIndexEntryArrays();
         return true;
     }
 
@@ -733,6 +1046,16 @@ private:
     CompressPair<std::size_t, IndexEntryAllocatorType>      IndexEntryAllocatorPair{};
     CompressPair<std::size_t, IndexEntryArrayAllocatorType> IndexEntryArrayAllocatorPair{};
 
+    // from InlineStorage, not owned
+    BlockType*       InlineBlock{ nullptr };
+    IndexEntryArray* InlineIndexEntryArray{ nullptr };
+
+    std::size_t ShrinkHighWater{ NoShrink };
+    std::size_t ShrinkLowWater{ 0 };
+
+    // blocks from the block manager linked into the ring, kept for GetMemoryStats, the producer uses PO_IndexEntriesUsed
+    std::atomic<std::size_t> HeldBlocks{ 0 };
+
     HAKLE_CPP14_CONSTEXPR IndexEntryAllocatorType&      IndexEntryAllocator() noexcept { return IndexEntryAllocatorPair.Second(); }
     HAKLE_CPP14_CONSTEXPR IndexEntryArrayAllocatorType& IndexEntryArrayAllocator() noexcept { return IndexEntryArrayAllocatorPair.Second(); }
 
@@ -780,6 +1103,18 @@ private:
     using IndexEntryPointerAllocatorTraits = typename ValueAllocatorTraits::template RebindTraits<IndexEntry*>;
 
 public:
+    // First index array and first block, to be placed in the same allocation as the queue itself.
+    // InitialSize is the InSize the queue would otherwise be constructed with.
+    template <std::size_t InitialSize>
+    struct InlineStorage {
+        static constexpr std::size_t EntryCount = ( CeilToPow2( InitialSize ) >> 1 ) < 2 ? 2 : ( CeilToPow2( InitialSize ) >> 1 );
+
+        IndexEntryArray Array{};
+        IndexEntry      Entries[ EntryCount ]{};
+        IndexEntry*     Index[ EntryCount ]{};
+        BlockType       Block{};
+    };
+
     HAKLE_CPP14_CONSTEXPR SlowQueue( std::size_t InSize, BlockManagerType* InBlockManager = &GetBlockManager<BlockManagerType>(), const ValueAllocatorType& InAllocator = ValueAllocatorType{} )
         : Base( InAllocator ), IndexEntryAllocatorPair( ValueInitTag{}, IndexEntryAllocatorType( InAllocator ) ), IndexEntryArrayAllocatorPair( InBlockManager, IndexEntryArrayAllocatorType( InAllocator ) ),
           IndexEntryPointerAllocatorPair( 0, IndexEntryPointerAllocatorType( InAllocator ) ) {
@@ -792,9 +1127,20 @@ public:
         CreateNewBlockIndexArray();
     }
 
+    // Uses Storage instead of allocating the first index array, and the inline block before asking the block manager.
+    // Storage must outlive the queue, the inline block is never handed to the block manager.
+    template <std::size_t InitialSize>
+    HAKLE_CPP14_CONSTEXPR SlowQueue( InlineStorage<InitialSize>& Storage, BlockManagerType* InBlockManager, const ValueAllocatorType& InAllocator = ValueAllocatorType{} )
+        : Base( InAllocator ), IndexEntryAllocatorPair( ValueInitTag{}, IndexEntryAllocatorType( InAllocator ) ), IndexEntryArrayAllocatorPair( InBlockManager, IndexEntryArrayAllocatorType( InAllocator ) ),
+          IndexEntryPointerAllocatorPair( InlineStorage<InitialSize>::EntryCount, IndexEntryPointerAllocatorType( InAllocator ) ), InlineBlock( &Storage.Block ), InlineIndexEntryArray( &Storage.Array ), InlineBlockFree( true ) {
+        InstallBlockIndexArray( &Storage.Array, Storage.Entries, Storage.Index );
+    }
+
     HAKLE_CPP20_CONSTEXPR ~SlowQueue() { Clear(); }
 
-    HAKLE_CPP14_CONSTEXPR SlowQueue( SlowQueue&& Other ) noexcept : Base( std::move( Other ) ), HAKLE_MOVE_PAIR_ATOMIC1( IndexEntryAllocatorPair ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, IndexEntryArrayAllocatorPair, IndexEntryPointerAllocatorPair ) {
+    HAKLE_CPP14_CONSTEXPR SlowQueue( SlowQueue&& Other ) noexcept
+        : Base( std::move( Other ) ), HAKLE_MOVE_PAIR_ATOMIC1( IndexEntryAllocatorPair ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, IndexEntryArrayAllocatorPair, IndexEntryPointerAllocatorPair, InlineBlock, InlineIndexEntryArray ),
+          HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_ATOMIC, InlineBlockFree, HeldBlocks ) {
         Other.Reset();
     }
 
@@ -803,7 +1149,8 @@ public:
             Clear();
             Base::operator=( std::move( Other ) );
             HAKLE_OP_MOVE_ATOMIC_ELEM( CurrentIndexEntryArray );
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, IndexEntryAllocator(), IndexEntryArrayAllocatorPair, IndexEntryPointerAllocatorPair );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, IndexEntryAllocator(), IndexEntryArrayAllocatorPair, IndexEntryPointerAllocatorPair, InlineBlock, InlineIndexEntryArray );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, InlineBlockFree, HeldBlocks );
             Other.Reset();
         }
         return *this;
@@ -816,8 +1163,14 @@ public:
         std::size_t Index = this->HeadIndex.load( std::memory_order_relaxed );
         std::size_t Tail  = this->TailIndex.load( std::memory_order_relaxed );
 
-        // Release all block
-        BlockType* Block = nullptr;
+        // Release all block, collected into one chain
+        BlockType* Block    = nullptr;
+        BlockType* Released = nullptr;
+        if ( Index == Tail && ( Tail & ( BlockSize - 1 ) ) != 0 ) {
+            // a partially filled tail block is never released by Dequeue, even when all its elements are gone
+            Released       = GetBlockIndexEntryForIndex( Tail - 1 )->Value.load( std::memory_order_relaxed );
+            Released->Next = nullptr;
+        }
         while ( Index != Tail ) {
             std::size_t InnerIndex = Index & ( BlockSize - 1 );
             if ( InnerIndex == 0 || Block == nullptr ) {
@@ -825,10 +1178,12 @@ public:
             }
             ValueAllocatorTraits::Destroy( this->ValueAllocator(), ( *Block )[ InnerIndex ] );
             if ( InnerIndex == BlockSize - 1 || Index == Tail - 1 ) {
-                BlockManager()->ReturnBlock( Block );
+                Block->Next = Released;
+                Released    = Block;
             }
             ++Index;
         }
+        ReleaseBlocks( Released );
 
         // Delete IndexEntryArray
         IndexEntryArray* CurrentArray = CurrentIndexEntryArray().load( std::memory_order_relaxed );
@@ -839,11 +1194,18 @@ public:
 
             while ( CurrentArray != nullptr ) {
                 IndexEntryArray* Prev = CurrentArray->Prev;
-                // pass size to detect memory leaks
-                IndexEntryPointerAllocatorTraits::Deallocate( IndexEntryPointerAllocator(), CurrentArray->Index, CurrentArray->Size );
-                IndexEntryAllocatorTraits::Deallocate( IndexEntryAllocator(), CurrentArray->Entries, Prev == nullptr ? CurrentArray->Size : ( CurrentArray->Size >> 1 ) );
-                IndexEntryArrayAllocatorTraits::Destroy( IndexEntryArrayAllocator(), CurrentArray );
-                IndexEntryArrayAllocatorTraits::Deallocate( IndexEntryArrayAllocator(), CurrentArray );
+                if ( CurrentArray != InlineIndexEntryArray ) {
+                    // pass size to detect memory leaks, superseded indexes may be reclaimed already
+                    if ( CurrentArray->Index != nullptr ) {
+                        this->IndexBytes.fetch_sub( CurrentArray->Size * sizeof( IndexEntry* ), std::memory_order_relaxed );
+                        IndexEntryPointerAllocatorTraits::Deallocate( IndexEntryPointerAllocator(), CurrentArray->Index, CurrentArray->Size );
+                    }
+                    std::size_t EntryCount = Prev == nullptr ? CurrentArray->Size : ( CurrentArray->Size >> 1 );
+                    this->IndexBytes.fetch_sub( sizeof( IndexEntryArray ) + EntryCount * sizeof( IndexEntry ), std::memory_order_relaxed );
+                    IndexEntryAllocatorTraits::Deallocate( IndexEntryAllocator(), CurrentArray->Entries, EntryCount );
+                    IndexEntryArrayAllocatorTraits::Destroy( IndexEntryArrayAllocator(), CurrentArray );
+                    IndexEntryArrayAllocatorTraits::Deallocate( IndexEntryArrayAllocator(), CurrentArray );
+                }
                 CurrentArray = Prev;
             }
         }
@@ -852,8 +1214,12 @@ public:
     HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
         Base::Reset();
         CurrentIndexEntryArray().store( nullptr, std::memory_order_relaxed );
-        BlockManager()     = nullptr;
-        IndexEntriesSize() = 0;
+        BlockManager()        = nullptr;
+        IndexEntriesSize()    = 0;
+        InlineBlock           = nullptr;
+        InlineIndexEntryArray = nullptr;
+        InlineBlockFree.store( false, std::memory_order_relaxed );
+        HeldBlocks.store( 0, std::memory_order_relaxed );
     }
 
 #if HAKLE_CPP_VERSION >= 20
@@ -861,10 +1227,39 @@ public:
         Base::swap( Other );
         HAKLE_SWAP_ATOMIC( CurrentIndexEntryArray() );
         using std::swap;
-        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, IndexEntryAllocator(), IndexEntryArrayAllocatorPair, IndexEntryPointerAllocatorPair );
+        HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, IndexEntryAllocator(), IndexEntryArrayAllocatorPair, IndexEntryPointerAllocatorPair, InlineBlock, InlineIndexEntryArray );
+        HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, InlineBlockFree, HeldBlocks );
     }
 #endif
 
+    // Same as FastQueue::GetMemoryStats, blocks count until a consumer releases them
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept {
+        MemoryStats Stats;
+        Stats.ProducerBlockBytes = HeldBlocks.load( std::memory_order_relaxed ) * sizeof( BlockType );
+        Stats.IndexBytes         = this->IndexBytes.load( std::memory_order_relaxed );
+        Stats.ProducerBytes      = sizeof( SlowQueue );
+        return Stats;
+    }
+
+    // NOTE: This is intentionally not thread safe; only used when the owner of the block manager is moved.
+    HAKLE_CPP14_CONSTEXPR void SetBlockManager( BlockManagerType* InBlockManager ) noexcept { BlockManager() = InBlockManager; }
+
+    // Grows the block index so that Count elements can be enqueued without allocating a new index array.
+    // Blocks are not kept by SlowQueue, so they have to be reserved in the block manager instead.
+    // NOTE: producer only, like Enqueue
+    HAKLE_CPP20_CONSTEXPR bool Reserve( std::size_t Count ) {
+        // one more block for the partially dequeued head block
+        std::size_t      BlockCount   = ( ( Count + BlockSize - 1 ) >> BlockSizeLog2 ) + 1;
+        IndexEntryArray* CurrentArray = CurrentIndexEntryArray().load( std::memory_order_relaxed );
+        while ( CurrentArray == nullptr || CurrentArray->Size < BlockCount ) {
+            if ( !CreateNewBlockIndexArray() ) {
+                return false;
+            }
+            CurrentArray = CurrentIndexEntryArray().load( std::memory_order_relaxed );
+        }
+        return true;
+    }
+
     template <AllocMode Mode, class... Args>
     HAKLE_REQUIRES( std::is_constructible_v<ValueType, Args&&...> )
     HAKLE_CPP20_CONSTEXPR bool Enqueue( Args&&... args ) {
@@ -876,13 +1271,14 @@ public:
             if HAKLE_UNLIKELY ( !CircularLessThan( this->HeadIndex.load( std::memory_order_relaxed ), CurrentTailIndex + BlockSize ) ) {
                 return false;
             }
+            ReclaimIndexArrays();
 
             IndexEntry* NewIndexEntry = nullptr;
             if HAKLE_UNLIKELY ( !InsertBlockIndexEntry<Mode>( NewIndexEntry, CurrentTailIndex ) ) {
                 return false;
             }
 
-            BlockType* NewBlock = BlockManager()->RequisitionBlock( Mode );
+            BlockType* NewBlock = RequisitionBlock( Mode );
             if HAKLE_UNLIKELY ( NewBlock == nullptr ) {
                 RewindBlockIndexTail();
                 NewIndexEntry->Value.store( nullptr, std::memory_order_relaxed );
@@ -896,7 +1292,7 @@ public:
                 HAKLE_CATCH( ... ) {
                     RewindBlockIndexTail();
                     NewIndexEntry->Value.store( nullptr, std::memory_order_relaxed );
-                    BlockManager()->ReturnBlock( NewBlock );
+                    ReleaseBlock( NewBlock );
                     HAKLE_RETHROW;
                 }
             }
@@ -919,6 +1315,8 @@ public:
     template <AllocMode Mode, HAKLE_CONCEPT( std::input_iterator ) Iterator>
     HAKLE_REQUIRES( requires( Iterator Item ) { ValueType( *Item ); } )
     HAKLE_CPP20_CONSTEXPR bool EnqueueBulk( Iterator ItemFirst, std::size_t Count ) {
+        ReclaimIndexArrays();
+
         std::size_t OriginTailIndex     = this->TailIndex.load( std::memory_order_relaxed );
         BlockType*  OriginTailBlock     = this->TailBlock();
         BlockType*  FirstAllocatedBlock = nullptr;
@@ -933,7 +1331,7 @@ public:
                 RewindBlockIndexTail();
             }
 
-            BlockManager()->ReturnBlocks( FirstAllocatedBlock );
+            ReleaseBlocks( FirstAllocatedBlock );
             this->TailBlock() = OriginTailBlock;
         };
 
@@ -941,6 +1339,8 @@ public:
         std::size_t CurrentTailIndex = ( OriginTailIndex - 1 ) & ~( BlockSize - 1 );
         // allocate index entry and block
         if ( NeedCount > 0 ) {
+            // the remaining blocks are requisitioned in one go, whatever is left over goes back on failure
+            BlockType* SpareBlocks = nullptr;
             while ( NeedCount > 0 ) {
                 CurrentTailIndex += BlockSize;
                 --NeedCount;
@@ -951,14 +1351,23 @@ public:
 
                 // TODO: add MAX_SIZE check
                 bool full = !CircularLessThan( this->HeadIndex.load( std::memory_order_relaxed ), CurrentTailIndex + BlockSize );
-                if ( full || !( IndexInserted = InsertBlockIndexEntry<Mode>( IndexEntry, CurrentTailIndex ) ) || !( NewBlock = BlockManager()->RequisitionBlock( Mode ) ) ) {
+                if ( !full && ( IndexInserted = InsertBlockIndexEntry<Mode>( IndexEntry, CurrentTailIndex ) ) ) {
+                    if ( SpareBlocks == nullptr ) {
+                        SpareBlocks = RequisitionBlocks( NeedCount + 1, Mode );
+                    }
+                    NewBlock = SpareBlocks;
+                }
+
+                if ( NewBlock == nullptr ) {
                     if ( IndexInserted ) {
                         RewindBlockIndexTail();
                         IndexEntry->Value.store( nullptr, std::memory_order_relaxed );
                     }
+                    ReleaseBlocks( SpareBlocks );
                     RollBack();
                     return false;
                 }
+                SpareBlocks = NewBlock->Next;
 
                 NewBlock->Reset();
                 NewBlock->Next = nullptr;
@@ -1049,23 +1458,24 @@ public:
                 ValueType&  Value = *( *Block )[ InnerIndex ];
 
                 HAKLE_CONSTEXPR_IF( !std::is_nothrow_assignable<U&, ValueType&&>::value ) {
+                    // releases through the queue, so the inline block and the block quota are handled like on the normal path
                     struct Guard {
-                        IndexEntry*                                   Entry;
-                        BlockType*                                    Block;
-                        BlockManagerType*                             BlockManager;
-                        CompressPair<std::size_t, ValueAllocatorType> ValueAllocatorPair;
+                        IndexEntry* Entry;
+                        BlockType*  Block;
+                        SlowQueue*  Queue;
+                        std::size_t InnerIndex;
 
                         ~Guard() {
-                            ValueAllocatorTraits::Destroy( ValueAllocatorPair.Second(), ( *Block )[ ValueAllocatorPair.First() ] );
-                            if ( Block->SetEmpty( ValueAllocatorPair.First() ) ) {
+                            ValueAllocatorTraits::Destroy( Queue->ValueAllocator(), ( *Block )[ InnerIndex ] );
+                            if ( Block->SetEmpty( InnerIndex ) ) {
                                 Entry->Value.store( nullptr, std::memory_order_relaxed );
-                                BlockManager->ReturnBlock( Block );
+                                Queue->ReleaseBlock( Block );
                             }
                         }
 #if HAKLE_CPP_VERSION >= 20
-                    } guard{ .Entry = Entry, .Block = Block, .BlockManager = BlockManager(), .ValueAllocatorPair = { InnerIndex, this->ValueAllocator() } };
+                    } guard{ .Entry = Entry, .Block = Block, .Queue = this, .InnerIndex = InnerIndex };
 #else
-                    } guard{ Entry, Block, BlockManager(), { InnerIndex, this->ValueAllocator() } };
+                    } guard{ Entry, Block, this, InnerIndex };
 #endif
                     Element = std::move( Value );
                 }
@@ -1074,7 +1484,7 @@ public:
                     ValueAllocatorTraits::Destroy( this->ValueAllocator(), &Value );
                     if ( Block->SetEmpty( InnerIndex ) ) {
                         Entry->Value.store( nullptr, std::memory_order_relaxed );
-                        BlockManager()->ReturnBlock( Block );
+                        ReleaseBlock( Block );
                     }
                 }
                 return true;
@@ -1108,8 +1518,11 @@ public:
                 std::size_t StartIndex = InnerIndex;
                 std::size_t NeedCount  = ActualCount;
 
-                IndexEntryArray* LocalIndexEntryArray;
-                std::size_t      IndexEntryIndex = GetBlockIndexIndexForIndex( Index, LocalIndexEntryArray );
+                // emptied blocks are handed back together once the copy is done
+                BlockType*                    EmptiedBlocks = nullptr;
+                typename Base::IndexReadGuard Guard( Base::IndexEpochs() );
+                IndexEntryArray*              LocalIndexEntryArray;
+                std::size_t                   IndexEntryIndex = GetBlockIndexIndexForIndex( Index, LocalIndexEntryArray );
                 while ( NeedCount != 0 ) {
                     IndexEntry* DequeueIndexEntry = LocalIndexEntryArray->Index[ IndexEntryIndex ];
                     BlockType*  DequeueBlock      = DequeueIndexEntry->Value.load( std::memory_order_relaxed );
@@ -1153,21 +1566,24 @@ public:
 
                                 if ( DequeueBlock->SetSomeEmpty( StartIndex, EndIndex - StartIndex ) ) {
                                     DequeueIndexEntry->Value.store( nullptr, std::memory_order_relaxed );
-                                    BlockManager()->ReturnBlock( DequeueBlock );
+                                    ReleaseBlock( DequeueBlock );
                                 }
                                 StartIndex      = 0;
                                 IndexEntryIndex = ( IndexEntryIndex + 1 ) & ( LocalIndexEntryArray->Size - 1 );
                             }
+                            ReleaseBlocks( EmptiedBlocks );
                             HAKLE_RETHROW;
                         }
                     }
                     if ( DequeueBlock->SetSomeEmpty( StartIndex, EndIndex - StartIndex ) ) {
                         DequeueIndexEntry->Value.store( nullptr, std::memory_order_relaxed );
-                        BlockManager()->ReturnBlock( DequeueBlock );
+                        DequeueBlock->Next = EmptiedBlocks;
+                        EmptiedBlocks      = DequeueBlock;
                     }
                     StartIndex      = 0;
                     IndexEntryIndex = ( IndexEntryIndex + 1 ) & ( LocalIndexEntryArray->Size - 1 );
                 }
+                ReleaseBlocks( EmptiedBlocks );
                 return ActualCount;
             }
 
@@ -1188,6 +1604,8 @@ private:
         IndexEntry*              Entries{ nullptr };
         IndexEntry**             Index{ nullptr };
         IndexEntryArray*         Prev{ nullptr };
+        // epoch at which the next array superseded this one's index
+        std::uint64_t RetireEpoch{ 0 };
     };
 
     template <AllocMode Mode>
@@ -1224,14 +1642,16 @@ private:
         LocalBlockEntryArray->Tail.store( ( LocalBlockEntryArray->Tail.load( std::memory_order_relaxed ) - 1 ) & ( LocalBlockEntryArray->Size - 1 ), std::memory_order_relaxed );
     }
 
+    // the entries themselves are never freed before Clear, only the index arrays pointing at them
     HAKLE_CPP20_CONSTEXPR IndexEntry* GetBlockIndexEntryForIndex( std::size_t Index ) const noexcept {
-        IndexEntryArray* LocalBlockIndexArray;
+        typename Base::IndexReadGuard Guard( Base::IndexEpochs() );
+        IndexEntryArray*              LocalBlockIndexArray;
         std::size_t      BlockIndex = GetBlockIndexIndexForIndex( Index, LocalBlockIndexArray );
         return LocalBlockIndexArray->Index[ BlockIndex ];
     }
 
     HAKLE_CPP20_CONSTEXPR std::size_t GetBlockIndexIndexForIndex( std::size_t Index, IndexEntryArray*& LocalBlockIndexArray ) const noexcept {
-        LocalBlockIndexArray   = CurrentIndexEntryArray().load( std::memory_order_acquire );
+        LocalBlockIndexArray   = CurrentIndexEntryArray().load( std::memory_order_seq_cst );
         std::size_t Tail       = LocalBlockIndexArray->Tail.load( std::memory_order_acquire );
         std::size_t TailBase   = LocalBlockIndexArray->Index[ Tail ]->Key.load( std::memory_order_relaxed );
         std::size_t Offset     = ( ( Index & ~( BlockSize - 1 ) ) - TailBase ) >> BlockSizeLog2;
@@ -1267,7 +1687,18 @@ private:
         }
 
         // noexcept
+        this->IndexBytes.fetch_add( sizeof( IndexEntryArray ) + EntryCount * sizeof( IndexEntry ) + IndexEntriesSize() * sizeof( IndexEntry* ), std::memory_order_relaxed );
         IndexEntryArrayAllocatorTraits::Construct( IndexEntryArrayAllocator(), NewIndexEntryArray );
+        InstallBlockIndexArray( NewIndexEntryArray, NewEntries, NewIndex );
+        ReclaimIndexArrays();
+        return true;
+    }
+
+    // Links the new entries after the current ones and makes the array current
+    HAKLE_CPP20_CONSTEXPR void InstallBlockIndexArray( IndexEntryArray* NewIndexEntryArray, IndexEntry* NewEntries, IndexEntry** NewIndex ) noexcept {
+        IndexEntryArray* Prev       = CurrentIndexEntryArray().load( std::memory_order_relaxed );
+        std::size_t      PrevSize   = Prev == nullptr ? 0 : Prev->Size;
+        std::size_t      EntryCount = Prev == nullptr ? IndexEntriesSize() : PrevSize;
 
         if HAKLE_LIKELY ( Prev != nullptr ) {
             std::size_t Tail = Prev->Tail.load( std::memory_order_relaxed );
@@ -1289,10 +1720,104 @@ private:
         NewIndexEntryArray->Tail.store( ( PrevSize - 1 ) & ( IndexEntriesSize() - 1 ), std::memory_order_relaxed );
         NewIndexEntryArray->Size = IndexEntriesSize();
 
-        CurrentIndexEntryArray().store( NewIndexEntryArray, std::memory_order_release );
+        CurrentIndexEntryArray().store( NewIndexEntryArray, std::memory_order_seq_cst );
+        if ( Prev != nullptr ) {
+            Prev->RetireEpoch = Base::IndexEpochs().GetEpoch();
+        }
 
         IndexEntriesSize() <<= 1;
-        return true;
+    }
+
+    // Superseded arrays keep their entries, which the current index still points at, but their index is freed once no
+    // consumer can still be reading it. Each entry segment is half the size of the index that superseded it.
+    // The newest superseded index was retired last, once it can go the older ones can too.
+    HAKLE_CPP20_CONSTEXPR void ReclaimIndexArrays() noexcept {
+        IndexEntryArray* Current = CurrentIndexEntryArray().load( std::memory_order_relaxed );
+        IndexEntryArray* Prev    = Current == nullptr ? nullptr : Current->Prev;
+        if ( Prev == nullptr || Prev->Index == nullptr || !Base::CanFreeIndex( Prev->RetireEpoch ) ) {
+            return;
+        }
+        for ( ; Prev != nullptr && Prev->Index != nullptr; Prev = Prev->Prev ) {
+            if ( Prev != InlineIndexEntryArray ) {
+                this->IndexBytes.fetch_sub( Prev->Size * sizeof( IndexEntry* ), std::memory_order_relaxed );
+                IndexEntryPointerAllocatorTraits::Deallocate( IndexEntryPointerAllocator(), Prev->Index, Prev->Size );
+            }
+            Prev->Index = nullptr;
+        }
+    }
+
+    // The inline block is handed out before asking the block manager
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlock( AllocMode Mode ) {
+        if ( InlineBlockFree.load( std::memory_order_acquire ) ) {
+            // only the producer takes it
+            InlineBlockFree.store( false, std::memory_order_relaxed );
+            return InlineBlock;
+        }
+        return RequisitionManagerBlocks( 1, Mode );
+    }
+
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionBlocks( std::size_t Count, AllocMode Mode ) {
+        if ( Count > 0 && InlineBlockFree.load( std::memory_order_acquire ) ) {
+            InlineBlockFree.store( false, std::memory_order_relaxed );
+            InlineBlock->Next = Count > 1 ? RequisitionManagerBlocks( Count - 1, Mode ) : nullptr;
+            return InlineBlock;
+        }
+        return RequisitionManagerBlocks( Count, Mode );
+    }
+
+    // Blocks from the block manager count against the block quota, up to Count of them are handed out
+    HAKLE_CPP20_CONSTEXPR BlockType* RequisitionManagerBlocks( std::size_t Count, AllocMode Mode ) {
+        std::size_t Held = HeldBlocks.load( std::memory_order_relaxed );
+        Count            = Held >= this->BlockQuota ? 0 : std::min( Count, this->BlockQuota - Held );
+        if HAKLE_UNLIKELY ( Count == 0 ) {
+            return nullptr;
+        }
+
+        if ( Count == 1 ) {
+            BlockType* Block = BlockManager()->RequisitionBlock( Mode );
+            if ( Block != nullptr ) {
+                HeldBlocks.fetch_add( 1, std::memory_order_relaxed );
+            }
+            return Block;
+        }
+
+        BlockType*  Blocks = hakle::RequisitionBlocks( *BlockManager(), Count, Mode );
+        std::size_t Got    = 0;
+        for ( BlockType* Block = Blocks; Block != nullptr; Block = Block->Next ) {
+            ++Got;
+        }
+        HeldBlocks.fetch_add( Got, std::memory_order_relaxed );
+        return Blocks;
+    }
+
+    HAKLE_CPP20_CONSTEXPR void ReleaseBlock( BlockType* Block ) {
+        if ( Block == InlineBlock ) {
+            InlineBlockFree.store( true, std::memory_order_release );
+        }
+        else {
+            HeldBlocks.fetch_sub( 1, std::memory_order_relaxed );
+            BlockManager()->ReturnBlock( Block );
+        }
+    }
+
+    HAKLE_CPP20_CONSTEXPR void ReleaseBlocks( BlockType* Blocks ) {
+        if ( InlineBlock != nullptr ) {
+            for ( BlockType** Link = &Blocks; *Link != nullptr; Link = &( *Link )->Next ) {
+                if ( *Link == InlineBlock ) {
+                    *Link = InlineBlock->Next;
+                    InlineBlockFree.store( true, std::memory_order_release );
+                    break;
+                }
+            }
+        }
+        if ( Blocks != nullptr ) {
+            std::size_t Count = 0;
+            for ( BlockType* Block = Blocks; Block != nullptr; Block = Block->Next ) {
+                ++Count;
+            }
+            HeldBlocks.fetch_sub( Count, std::memory_order_relaxed );
+            BlockManager()->ReturnBlocks( Blocks );
+        }
     }
 
     // compressed allocator
@@ -1311,6 +1836,13 @@ private:
     constexpr const IndexEntryArrayAllocatorType&   IndexEntryArrayAllocator() const noexcept { return IndexEntryArrayAllocatorPair.Second(); }
     constexpr const IndexEntryPointerAllocatorType& IndexEntryPointerAllocator() const noexcept { return IndexEntryPointerAllocatorPair.Second(); }
 
+    // from InlineStorage, not owned
+    BlockType*        InlineBlock{ nullptr };
+    IndexEntryArray*  InlineIndexEntryArray{ nullptr };
+    std::atomic<bool> InlineBlockFree{ false };
+    // blocks taken from the block manager and not released yet, released by consumers too
+    std::atomic<std::size_t> HeldBlocks{ 0 };
+
     HAKLE_CPP14_CONSTEXPR std::atomic<IndexEntryArray*>& CurrentIndexEntryArray() noexcept { return IndexEntryAllocatorPair.First(); }
     HAKLE_CPP14_CONSTEXPR BlockManagerType*&             BlockManager() noexcept { return IndexEntryArrayAllocatorPair.First(); }
     HAKLE_CPP14_CONSTEXPR std::size_t& IndexEntriesSize() noexcept { return IndexEntryPointerAllocatorPair.First(); }
@@ -1328,6 +1860,23 @@ struct ConcurrentQueueDefaultTraits {
     static constexpr std::size_t InitialExplicitQueueSize = 32;
     static constexpr std::size_t InitialImplicitQueueSize = 32;
 
+    // Allocate each producer's list node, queue, first index array and first block as one chunk
+    static constexpr bool SingleAllocationProducers = false;
+
+    // Implicit enqueues go to one of a few producers owned by the current CPU instead of one per thread, so the
+    // number of implicit producers stays bounded by the core count. A thread that finds them busy probes the other
+    // CPUs' producers and, when every one is held, yields until one frees up.
+    // NOTE: a thread that migrates or meets a busy producer spreads its items over several producers, so in this mode
+    // the items of one thread are NOT dequeued in the order it enqueued them
+    static constexpr bool PerCpuProducers = false;
+
+    // Most blocks one producer may hold from its block manager, 0 for no limit
+    static constexpr std::size_t MaxBlocksPerProducer = 0;
+
+    // Explicit producers give empty blocks back once more than this many sit idle in their ring, keeping half of them.
+    // 0 keeps every block until ShrinkToFit is called
+    static constexpr std::size_t MaxIdleBlocksPerProducer = 0;
+
     using AllocatorType = Allocator;
 
     using ExplicitBlockType = HakleFlagsBlock<T, BlockSize>;
@@ -1346,6 +1895,56 @@ struct ConcurrentQueueDefaultTraits {
     static ImplicitBlockManagerType MakeImplicitBlockManager( const ExplicitAllocatorType& InAllocator, std::size_t BlockPoolSize ) { return ImplicitBlockManagerType( BlockPoolSize, InAllocator ); }
 };
 
+// Default traits with block managers that many queues can share (see SharedBlockManager). A default constructed queue
+// gets managers of its own, handles from Share() passed to the constructor pool the blocks of several queues.
+template <class T, HAKLE_CONCEPT( IsAllocator ) Allocator>
+struct ConcurrentQueueSharedTraits : ConcurrentQueueDefaultTraits<T, Allocator> {
+    using Base = ConcurrentQueueDefaultTraits<T, Allocator>;
+    using typename Base::ExplicitAllocatorType;
+    using typename Base::ImplicitAllocatorType;
+
+    using ExplicitBlockManagerType = SharedBlockManager<typename Base::ExplicitBlockManagerType>;
+    using ImplicitBlockManagerType = SharedBlockManager<typename Base::ImplicitBlockManagerType>;
+
+    static ExplicitBlockManagerType MakeDefaultExplicitBlockManager( const ExplicitAllocatorType& InAllocator ) { return ExplicitBlockManagerType( Base::InitialBlockPoolSize, InAllocator ); }
+    static ImplicitBlockManagerType MakeDefaultImplicitBlockManager( const ImplicitAllocatorType& InAllocator ) { return ImplicitBlockManagerType( Base::InitialBlockPoolSize, InAllocator ); }
+
+    static ExplicitBlockManagerType MakeExplicitBlockManager( const ExplicitAllocatorType& InAllocator, std::size_t BlockPoolSize ) { return ExplicitBlockManagerType( BlockPoolSize, InAllocator ); }
+    static ImplicitBlockManagerType MakeImplicitBlockManager( const ImplicitAllocatorType& InAllocator, std::size_t BlockPoolSize ) { return ImplicitBlockManagerType( BlockPoolSize, InAllocator ); }
+};
+
+// Real-time profile: the constructor builds MAX_EXPLICIT_PRODUCERS explicit and MAX_IMPLICIT_PRODUCERS implicit
+// producers with room for ELEMENTS_PER_PRODUCER elements each, and block pools sized to match, from prefaulted and
+// (if LOCK_MEMORY) mlocked storage. Afterwards nothing is allocated: only the Try* enqueues compile, tokens and
+// threads beyond the reserved producers fail instead of creating new ones, and the hash never grows.
+template <class T, std::size_t ELEMENTS_PER_PRODUCER, std::size_t MAX_EXPLICIT_PRODUCERS, std::size_t MAX_IMPLICIT_PRODUCERS, bool LOCK_MEMORY = true>
+struct ConcurrentQueueRealTimeTraits : ConcurrentQueueDefaultTraits<T, HaklePinnedAllocator<T, LOCK_MEMORY>> {
+    using Base = ConcurrentQueueDefaultTraits<T, HaklePinnedAllocator<T, LOCK_MEMORY>>;
+    using typename Base::ExplicitAllocatorType;
+    using typename Base::ExplicitBlockManagerType;
+    using typename Base::ImplicitAllocatorType;
+    using typename Base::ImplicitBlockManagerType;
+
+    static constexpr bool        NoRuntimeAllocation  = true;
+    static constexpr std::size_t ElementsPerProducer  = ELEMENTS_PER_PRODUCER;
+    static constexpr std::size_t MaxExplicitProducers = MAX_EXPLICIT_PRODUCERS;
+    static constexpr std::size_t MaxImplicitProducers = MAX_IMPLICIT_PRODUCERS;
+
+    // one spare block, a producer holds a partly dequeued block while it fills the next
+    static constexpr std::size_t BlocksPerProducer    = ( ELEMENTS_PER_PRODUCER + Base::BlockSize - 1 ) / Base::BlockSize + 1;
+    static constexpr std::size_t MaxBlocksPerProducer = BlocksPerProducer;
+
+    // the hash grows once it is half full, one entry per implicit producer must never get there
+    static constexpr std::size_t InitialHashSize = CeilToPow2( 2 * MAX_IMPLICIT_PRODUCERS + 1 ) < Base::InitialHashSize ? Base::InitialHashSize : CeilToPow2( 2 * MAX_IMPLICIT_PRODUCERS + 1 );
+
+    static ExplicitBlockManagerType MakeDefaultExplicitBlockManager( const ExplicitAllocatorType& InAllocator ) {
+        return ExplicitBlockManagerType( MaxExplicitProducers * BlocksPerProducer, InAllocator );
+    }
+    static ImplicitBlockManagerType MakeDefaultImplicitBlockManager( const ImplicitAllocatorType& InAllocator ) {
+        return ImplicitBlockManagerType( MaxImplicitProducers * BlocksPerProducer, InAllocator );
+    }
+};
+
 template <class T, class Allocator = HakleAllocator<T>, HAKLE_CONCEPT( IsConcurrentQueueTraits ) Traits = ConcurrentQueueDefaultTraits<T, Allocator>>
 class ConcurrentQueue : private Traits {
 private:
@@ -1387,33 +1986,52 @@ public:
     using ExplicitProducerAllocatorType = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<ExplicitProducer>;
     using ImplicitProducerAllocatorType = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<ImplicitProducer>;
     using ProducerListNodeAllocatorType = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<ProducerListNode>;
+    using ImplicitMapAllocatorType      = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<Pair<std::atomic<details::thread_id_t>, std::atomic<ImplicitProducer*>>>;
 
+    // every allocator the queue keeps is a rebind of InAllocator, so a stateful allocator such as HakleArenaAllocator
+    // serves all of the queue's control structures
     explicit constexpr ConcurrentQueue( const AllocatorType& InAllocator = AllocatorType{} )
-        : ExplicitProducerAllocatorPair( MakeDefaultExplicitBlockManager( ExplicitAllocatorType( InAllocator ) ), ExplicitProducerAllocatorType( InAllocator ) ),
-          ImplicitProducerAllocatorPair( MakeDefaultImplicitBlockManager( ImplicitAllocatorType( InAllocator ) ), ImplicitProducerAllocatorType( InAllocator ) ) {}
+        : ImplicitMap( details::thread_id_t{}, ImplicitMapAllocatorType( InAllocator ) ),
+          ExplicitProducerAllocatorPair( MakeDefaultExplicitBlockManager( ExplicitAllocatorType( InAllocator ) ), ExplicitProducerAllocatorType( InAllocator ) ),
+          ImplicitProducerAllocatorPair( MakeDefaultImplicitBlockManager( ImplicitAllocatorType( InAllocator ) ), ImplicitProducerAllocatorType( InAllocator ) ), ValueAllocatorPair( ValueInitTag{}, InAllocator ),
+          ProducerListNodeAllocatorPair( ValueInitTag{}, ProducerListNodeAllocatorType( InAllocator ) ) {
+        ReserveStaticStorage();
+    }
+
+    // Takes the block managers instead of making them, e.g. handles to managers shared with other queues
+    constexpr ConcurrentQueue( ExplicitBlockManagerType&& InExplicitManager, ImplicitBlockManagerType&& InImplicitManager, const AllocatorType& InAllocator = AllocatorType{} )
+        : ImplicitMap( details::thread_id_t{}, ImplicitMapAllocatorType( InAllocator ) ), ExplicitProducerAllocatorPair( std::move( InExplicitManager ), ExplicitProducerAllocatorType( InAllocator ) ),
+          ImplicitProducerAllocatorPair( std::move( InImplicitManager ), ImplicitProducerAllocatorType( InAllocator ) ), ValueAllocatorPair( ValueInitTag{}, InAllocator ),
+          ProducerListNodeAllocatorPair( ValueInitTag{}, ProducerListNodeAllocatorType( InAllocator ) ) {
+        ReserveStaticStorage();
+    }
 
     template <class... Args1, class... Args2>
     HAKLE_REQUIRES( HasMakeImplicitBlockManager<Traits>&& HasMakeExplicitBlockManager<Traits>&& std::invocable<decltype( Traits::MakeExplicitBlockManager ), Args1&&...>&& std::invocable<decltype( Traits::MakeImplicitBlockManager ), Args2&&...> )
     explicit constexpr ConcurrentQueue( std::piecewise_construct_t, std::tuple<Args1...> FirstArgs, std::tuple<Args2...> SecondArgs, const AllocatorType& InAllocator )
-        :
+        : ImplicitMap( details::thread_id_t{}, ImplicitMapAllocatorType( InAllocator ) ),
 #if HAKLE_CPP_VERSION >= 17
           ExplicitProducerAllocatorPair( std::apply( [ &InAllocator ]( Args1&&... args1 ) { return Traits::MakeExplicitBlockManager( ExplicitAllocatorType( InAllocator ), std::forward<Args1>( args1 )... ); }, FirstArgs ),
                                          ExplicitProducerAllocatorType( InAllocator ) ),
           ImplicitProducerAllocatorPair( std::apply( [ &InAllocator ]( Args2&&... args2 ) { return Traits::MakeImplicitBlockManager( ImplicitAllocatorType( InAllocator ), std::forward<Args2>( args2 )... ); }, SecondArgs ),
-                                         ImplicitProducerAllocatorType( InAllocator ) )
+                                         ImplicitProducerAllocatorType( InAllocator ) ),
 #else
           ExplicitProducerAllocatorPair( hakle::Apply( [ &InAllocator ]( Args1&&... args1 ) { return Traits::MakeExplicitBlockManager( ExplicitAllocatorType( InAllocator ), std::forward<Args1>( args1 )... ); }, FirstArgs ),
                                          ExplicitProducerAllocatorType( InAllocator ) ),
           ImplicitProducerAllocatorPair( hakle::Apply( [ &InAllocator ]( Args2&&... args2 ) { return Traits::MakeImplicitBlockManager( ImplicitAllocatorType( InAllocator ), std::forward<Args2>( args2 )... ); }, SecondArgs ),
-                                         ImplicitProducerAllocatorType( InAllocator ) )
+                                         ImplicitProducerAllocatorType( InAllocator ) ),
 #endif
-    {
+          ValueAllocatorPair( ValueInitTag{}, InAllocator ), ProducerListNodeAllocatorPair( ValueInitTag{}, ProducerListNodeAllocatorType( InAllocator ) ) {
+        ReserveStaticStorage();
     }
 
-    HAKLE_CPP20_CONSTEXPR ~ConcurrentQueue() noexcept { ClearList(); }
+    HAKLE_CPP20_CONSTEXPR ~ConcurrentQueue() noexcept {
+        ClearList();
+        DeletePerCpuSlots( PerCpuSlots.load( std::memory_order_relaxed ) );
+    }
 
     HAKLE_CPP14_CONSTEXPR ConcurrentQueue( ConcurrentQueue&& Other ) noexcept
-        : HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_ATOMIC, ProducerListsHead, ProducerCount ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, ImplicitMap, ExplicitProducerAllocatorPair, ImplicitProducerAllocatorPair ),
+        : HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_ATOMIC, ProducerListsHead, ProducerCount, PerCpuSlots ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, ImplicitMap, ExplicitProducerAllocatorPair, ImplicitProducerAllocatorPair ),
           HAKLE_FOR_EACH_COMMA( HAKLE_MOVE_PAIR_ATOMIC1, ValueAllocatorPair, ProducerListNodeAllocatorPair ) {
         Other.Reset();
         ReclaimProducerLists();
@@ -1422,8 +2040,9 @@ public:
     HAKLE_CPP14_CONSTEXPR ConcurrentQueue& operator=( ConcurrentQueue&& Other ) noexcept {
         if ( this != &Other ) {
             ClearList();
+            DeletePerCpuSlots( PerCpuSlots.load( std::memory_order_relaxed ) );
 
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, ProducerListsHead, ProducerCount, GlobalExplicitConsumerOffset(), NextExplicitConsumerId() );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, ProducerListsHead, ProducerCount, PerCpuSlots, GlobalExplicitConsumerOffset(), NextExplicitConsumerId() );
             HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, ImplicitMap, ExplicitProducerAllocatorPair, ImplicitProducerAllocatorPair, ValueAllocator(), ProducerListNodeAllocator() );
 
             Other.Reset();
@@ -1439,9 +2058,12 @@ public:
     HAKLE_CPP14_CONSTEXPR void swap( ConcurrentQueue& Other ) noexcept
         HAKLE_REQUIRES( std::swappable<HashTable<details::thread_id_t, ImplicitProducer*, InitialHashSize, details::thread_hash>>&& std::swappable<CompressPair<ExplicitBlockManagerType, ExplicitProducerAllocatorType>>&&
                             std::swappable<CompressPair<ImplicitBlockManagerType, ImplicitProducerAllocatorType>>&& std::swappable<AllocatorType>&& std::swappable<ProducerListNodeAllocatorType> ) {
-        HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, ProducerListsHead, ProducerCount, NextExplicitConsumerId(), GlobalExplicitConsumerOffset() );
+        HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, ProducerListsHead, ProducerCount, PerCpuSlots, NextExplicitConsumerId(), GlobalExplicitConsumerOffset() );
         using std::swap;
         HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, ImplicitMap, ExplicitProducerAllocatorPair, ImplicitProducerAllocatorPair, ValueAllocator(), ProducerListNodeAllocator() );
+
+        ReclaimProducerLists();
+        Other.ReclaimProducerLists();
     }
 #endif
 
@@ -1452,11 +2074,13 @@ public:
     HAKLE_CPP14_CONSTEXPR void Reset() noexcept {
         ProducerListsHead.store( nullptr, std::memory_order_relaxed );
         ProducerCount.store( 0, std::memory_order_relaxed );
+        PerCpuSlots.store( nullptr, std::memory_order_relaxed );
         GlobalExplicitConsumerOffset().store( 0, std::memory_order_relaxed );
         NextExplicitConsumerId().store( 0, std::memory_order_relaxed );
     }
 
     HAKLE_CPP14_CONSTEXPR ProducerToken GetProducerToken() noexcept { return ProducerToken( *this ); }
+    HAKLE_CPP14_CONSTEXPR ProducerToken GetProducerToken( std::size_t Capacity ) { return ProducerToken( *this, Capacity ); }
     HAKLE_CPP14_CONSTEXPR ConsumerToken GetConsumerToken() noexcept { return ConsumerToken( *this ); }
 
     template <class... Args>
@@ -1495,7 +2119,7 @@ public:
     template <class... Args>
     HAKLE_REQUIRES( std::is_constructible_v<T, Args...> )
     constexpr bool TryEnqueue( const ProducerToken& Token, Args&&... args ) {
-        return InnerEnqueue<AllocMode::CannotAlloc>( Token, std::forward<Args>( args )... );
+        return InnerEnqueueWithToken<AllocMode::CannotAlloc>( Token, std::forward<Args>( args )... );
     }
 
     template <HAKLE_CONCEPT( std::input_iterator ) Iterator>
@@ -1638,6 +2262,151 @@ public:
         return Token.ProducerNode->ProducerDequeueBulk( ItemFirst, MaxCount );
     }
 
+    // Moves every element of Other into this queue without touching the elements: each producer of Other with elements
+    // hands its blocks and index, partially consumed head block included, to a parked empty producer here, which is made
+    // if there is none. Empty producers of Other only give their blocks back and stay, so splicing back and forth does
+    // not grow the producer lists.
+    // Other stays usable and ends up empty with the capacity it was constructed with: its block managers only give up the
+    // storage backing the spliced blocks, and a pool among it is replaced by a new one of the same size.
+    // Returns false if the block managers cannot take over each other's blocks or a producer cannot be made; both
+    // queues then keep their elements, at most some parked empty producers were added here.
+    // NOTE: not thread safe, neither queue may be in use
+    HAKLE_CPP20_CONSTEXPR bool SpliceFrom( ConcurrentQueue& Other ) {
+        HAKLE_CONSTEXPR_IF( SingleAllocationProducers || !HasAdoptBlocks<ExplicitBlockManagerType>::value || !HasAdoptBlocks<ImplicitBlockManagerType>::value ) { return false; }
+        else {
+            if ( this == &Other ) {
+                return true;
+            }
+
+            // empty producers of Other give their blocks back first, only producers with elements have to move
+            for ( ProducerListNode* Node = Other.ProducerListsHead.load( std::memory_order_relaxed ); Node != nullptr; Node = Node->Next ) {
+                if ( Node->GetProducerSize() == 0 && Node->HoldsBlocks() ) {
+                    Other.RecycleProducer( Node );
+                }
+            }
+
+            // the producers to splice into are made before either block manager changes
+            if ( !ParkSpliceTargets( Other, ProducerType::Explicit ) || !ParkSpliceTargets( Other, ProducerType::Implicit ) ) {
+                return false;
+            }
+
+            // blocks of the spliced producers may come from Other's pools, which must outlive them
+            if ( !hakle::AdoptBlocks( ExplicitManager(), Other.ExplicitManager() ) || !hakle::AdoptBlocks( ImplicitManager(), Other.ImplicitManager() ) ) {
+                return false;
+            }
+
+            ProducerListNode* ExplicitTarget = ProducerListsHead.load( std::memory_order_relaxed );
+            ProducerListNode* ImplicitTarget = ExplicitTarget;
+            for ( ProducerListNode* Node = Other.ProducerListsHead.load( std::memory_order_relaxed ); Node != nullptr; Node = Node->Next ) {
+                if ( !Node->HoldsBlocks() ) {
+                    continue;
+                }
+                ProducerListNode*& Target = Node->Type == ProducerType::Explicit ? ExplicitTarget : ImplicitTarget;
+                Target                    = NextSpliceTarget( Target, Node->Type );
+                SpliceProducer( Other, Node, Target );
+                Target = Target->Next;
+            }
+            return true;
+        }
+    }
+
+    // Pre-builds producers, their index arrays and blocks, so that the first enqueues after startup (or after a burst) do not allocate.
+    // Reserved producers are parked as inactive and taken over by the next ProducerTokens and new implicit producer threads.
+    // Returns false if some of the reservation could not be made, everything reserved so far stays usable.
+    HAKLE_CPP14_CONSTEXPR bool Reserve( std::size_t ExplicitProducers, std::size_t ImplicitProducers, std::size_t ElementsPerProducer ) {
+        for ( std::size_t i = 0; i < ExplicitProducers; ++i ) {
+            if ( !ReserveProducer( ProducerType::Explicit, ElementsPerProducer ) ) {
+                return false;
+            }
+        }
+
+        for ( std::size_t i = 0; i < ImplicitProducers; ++i ) {
+            if ( !ReserveProducer( ProducerType::Implicit, ElementsPerProducer ) ) {
+                return false;
+            }
+        }
+
+        // implicit producers return their blocks as soon as they are empty, so blocks are stocked in the manager instead
+        std::size_t BlocksPerProducer = ( ElementsPerProducer + BlockSize - 1 ) / BlockSize + 1;
+        return ImplicitProducers == 0 || ReserveBlocks( ImplicitManager(), BlocksPerProducer * ImplicitProducers );
+    }
+
+    // Gives the token's idle blocks back to the block manager, keeping KeepBlocks of them. Returns the number released.
+    // NOTE: only from the thread that enqueues with Token
+    HAKLE_CPP20_CONSTEXPR std::size_t ShrinkToFit( ProducerToken& Token, std::size_t KeepBlocks = 0 ) {
+        return Token.ProducerNode != nullptr ? Token.ProducerNode->GetExplicitProducer()->ShrinkToFit( KeepBlocks ) : 0;
+    }
+
+    // See FastQueue::SetShrinkPolicy, overrides MaxIdleBlocksPerProducer for this token
+    // NOTE: only from the thread that enqueues with Token
+    HAKLE_CPP14_CONSTEXPR void SetShrinkPolicy( ProducerToken& Token, std::size_t HighWater, std::size_t LowWater ) noexcept {
+        if ( Token.ProducerNode != nullptr ) {
+            Token.ProducerNode->GetExplicitProducer()->SetShrinkPolicy( HighWater, LowWater );
+        }
+    }
+
+    // Caps the memory each block manager holds, see HakleBlockManager::SetMemoryBudget. Returns false if the block managers have no budget.
+    // NOTE: set it before the queue is shared
+    HAKLE_CPP14_CONSTEXPR bool SetMemoryBudget( std::size_t MaxBytes, BudgetPolicy Policy = BudgetPolicy::Refuse ) noexcept {
+        HAKLE_CONSTEXPR_IF( !HasMemoryBudget<ExplicitBlockManagerType>::value || !HasMemoryBudget<ImplicitBlockManagerType>::value ) { return false; }
+        else {
+            ExplicitManager().SetMemoryBudget( MaxBytes, Policy );
+            ImplicitManager().SetMemoryBudget( MaxBytes, Policy );
+            return true;
+        }
+    }
+
+    // Gives block storage the managers grew into during a burst back to the allocator, each manager keeps at most TargetBytes of it.
+    // Returns the bytes freed, 0 if the block managers cannot trim. Producers and consumers may keep running, storage one
+    // of them may still touch is freed by a later call.
+    // NOTE: one thread trims or maintains at a time
+    HAKLE_CPP20_CONSTEXPR std::size_t TrimBlocks( std::size_t TargetBytes = 0 ) {
+        std::size_t Released = 0;
+        HAKLE_CONSTEXPR_IF( HasTrim<ExplicitBlockManagerType>::value ) { Released += ExplicitManager().Trim( TargetBytes ); }
+        HAKLE_CONSTEXPR_IF( HasTrim<ImplicitBlockManagerType>::value ) { Released += ImplicitManager().Trim( TargetBytes ); }
+        return Released;
+    }
+
+    // Keeps at least LowWater free blocks stocked in each block manager, see HakleBlockManager::Maintain.
+    // Returns the free blocks counted, 0 if the block managers cannot be maintained. Producers and consumers may keep
+    // running, also with a finite HighWater.
+    // NOTE: one thread trims or maintains at a time
+    HAKLE_CPP20_CONSTEXPR std::size_t MaintainBlocks( std::size_t LowWater, std::size_t HighWater = static_cast<std::size_t>( -1 ) ) {
+        std::size_t Free = 0;
+        HAKLE_CONSTEXPR_IF( HasMaintain<ExplicitBlockManagerType>::value ) { Free += ExplicitManager().Maintain( LowWater, HighWater ); }
+        HAKLE_CONSTEXPR_IF( HasMaintain<ImplicitBlockManagerType>::value ) { Free += ImplicitManager().Maintain( LowWater, HighWater ); }
+        return Free;
+    }
+
+    // Block storage and free blocks as the block managers report them (shared managers report everything they hold),
+    // producer blocks, index arrays and producers summed over the producer list, and the implicit producer hash.
+    // Every number comes from a counter, only the producer list is walked. Any thread may call it, the numbers can lag
+    // behind producers and consumers running at the same time.
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept {
+        MemoryStats Stats;
+        HAKLE_CONSTEXPR_IF( HasMemoryStats<ExplicitBlockManagerType>::value ) { Stats += ExplicitManager().GetMemoryStats(); }
+        HAKLE_CONSTEXPR_IF( HasMemoryStats<ImplicitBlockManagerType>::value ) { Stats += ImplicitManager().GetMemoryStats(); }
+        // managers count blocks cached on their side as handed out too, the producers know what they really hold
+        Stats.ProducerBlockBytes = 0;
+
+        for ( ProducerListNode* Node = ProducerListsHead.load( std::memory_order_acquire ); Node != nullptr; Node = Node->Next ) {
+            bool        Explicit      = Node->Type == ProducerType::Explicit;
+            MemoryStats ProducerStats = Explicit ? Node->GetExplicitProducer()->GetMemoryStats() : Node->GetImplicitProducer()->GetMemoryStats();
+            Stats.ProducerBlockBytes += ProducerStats.ProducerBlockBytes;
+            Stats.IndexBytes += ProducerStats.IndexBytes;
+            HAKLE_CONSTEXPR_IF( SingleAllocationProducers ) { Stats.ProducerBytes += Explicit ? sizeof( ExplicitProducerChunk ) : sizeof( ImplicitProducerChunk ); }
+            else {
+                Stats.ProducerBytes += sizeof( ProducerListNode ) + ProducerStats.ProducerBytes;
+            }
+        }
+        if ( PerCpuSlots.load( std::memory_order_acquire ) != nullptr ) {
+            Stats.ProducerBytes += sizeof( PerCpuSlot ) * PerCpuSlotCount();
+        }
+
+        Stats.HashBytes = ImplicitMap.GetMemoryStats().HashBytes;
+        return Stats;
+    }
+
     HAKLE_CPP14_CONSTEXPR std::size_t Size() noexcept {
         std::size_t QueueSize = 0;
         ForEachProducer( [ &QueueSize ]( ProducerListNode* Node ) noexcept { QueueSize += Node->GetProducerSize(); } );
@@ -1647,6 +2416,14 @@ public:
     struct ProducerToken {
         friend class ConcurrentQueue;
         explicit ProducerToken( ConcurrentQueue& queue ) : ProducerNode( queue.GetProducerListNode( ProducerType::Explicit ) ) {}
+        // Capacity is a hint, the producer reserves room for that many elements up front
+        ProducerToken( ConcurrentQueue& queue, std::size_t Capacity ) : ProducerToken( queue ) {
+            // reserved producers already hold all the room they will get
+            HAKLE_CONSTEXPR_IF( NoRuntimeAllocation ) { return; }
+            if ( ProducerNode != nullptr ) {
+                ProducerNode->GetExplicitProducer()->Reserve( Capacity );
+            }
+        }
         ProducerToken( ProducerToken&& Other ) noexcept : ProducerNode( Other.ProducerNode ) {
             Other.ProducerNode = nullptr;
             if ( ProducerNode != nullptr ) {
@@ -1723,12 +2500,22 @@ private:
     template <AllocMode Alloc, class... Args>
     HAKLE_REQUIRES( std::is_constructible_v<T, Args...> )
     constexpr bool InnerEnqueueWithToken( const ProducerToken& Token, Args&&... args ) {
+        static_assert( Alloc == AllocMode::CannotAlloc || !NoRuntimeAllocation, "NoRuntimeAllocation queues only support TryEnqueue" );
+        HAKLE_CONSTEXPR_IF( NoRuntimeAllocation ) {
+            if ( Token.ProducerNode == nullptr ) {
+                return false;
+            }
+        }
         return Token.ProducerNode->template ProducerEnqueue<Alloc>( std::forward<Args>( args )... );
     }
 
     template <AllocMode Alloc, class... Args>
     HAKLE_REQUIRES( std::is_constructible_v<T, Args...> )
     HAKLE_CPP14_CONSTEXPR bool InnerEnqueue( Args&&... args ) {
+        static_assert( Alloc == AllocMode::CannotAlloc || !NoRuntimeAllocation, "NoRuntimeAllocation queues only support TryEnqueue" );
+        HAKLE_CONSTEXPR_IF( PerCpuProducers ) {
+            return EnqueueOnCurrentCpu( [ & ]( ImplicitProducer* producer ) { return producer->template Enqueue<Alloc>( std::forward<Args>( args )... ); } );
+        }
         ImplicitProducer* producer = GetOrAddImplicitProducer();
         return producer == nullptr ? false : producer->template Enqueue<Alloc>( std::forward<Args>( args )... );
     }
@@ -1736,12 +2523,22 @@ private:
     template <AllocMode Alloc, HAKLE_CONCEPT( std::input_iterator ) Iterator>
     HAKLE_REQUIRES( requires( Iterator Item ) { T( *Item ); } )
     constexpr bool InnerEnqueueBulk( const ProducerToken& Token, Iterator ItermFirst, std::size_t Count ) {
+        static_assert( Alloc == AllocMode::CannotAlloc || !NoRuntimeAllocation, "NoRuntimeAllocation queues only support TryEnqueueBulk" );
+        HAKLE_CONSTEXPR_IF( NoRuntimeAllocation ) {
+            if ( Token.ProducerNode == nullptr ) {
+                return false;
+            }
+        }
         return Token.ProducerNode->template ProducerEnqueueBulk<Alloc>( ItermFirst, Count );
     }
 
     template <AllocMode Alloc, HAKLE_CONCEPT( std::input_iterator ) Iterator>
     HAKLE_REQUIRES( requires( Iterator Item ) { T( *Item ); } )
     HAKLE_CPP14_CONSTEXPR bool InnerEnqueueBulk( Iterator ItermFirst, std::size_t Count ) {
+        static_assert( Alloc == AllocMode::CannotAlloc || !NoRuntimeAllocation, "NoRuntimeAllocation queues only support TryEnqueueBulk" );
+        HAKLE_CONSTEXPR_IF( PerCpuProducers ) {
+            return EnqueueOnCurrentCpu( [ & ]( ImplicitProducer* producer ) { return producer->template EnqueueBulk<Alloc>( ItermFirst, Count ); } );
+        }
         ImplicitProducer* producer = GetOrAddImplicitProducer();
         return producer == nullptr ? false : producer->template EnqueueBulk<Alloc>( ItermFirst, Count );
     }
@@ -1784,7 +2581,7 @@ private:
         }
 
         template <class U>
-        HAKLE_CPP14_CONSTEXPR bool ProducerDequeue( U& Element ) HAKLE_REQUIRES( std::assignable_from<decltype( Element ), T&&> ) {
+        HAKLE_CPP14_CONSTEXPR bool ProducerDequeue( U& Element ) HAKLE_REQUIRES( std::assignable_from<U&, T&&> ) {
             if ( Type == ProducerType::Explicit ) {
                 return GetExplicitProducer()->Dequeue( Element );
             }
@@ -1805,9 +2602,68 @@ private:
 
         HAKLE_NODISCARD constexpr std::size_t GetProducerSize() const noexcept { return Type == ProducerType::Explicit ? GetExplicitProducer()->Size() : GetImplicitProducer()->Size(); }
 
+        // blocks taken from the block manager, a producer without any has no elements either
+        HAKLE_NODISCARD bool HoldsBlocks() const noexcept {
+            return ( Type == ProducerType::Explicit ? GetExplicitProducer()->GetMemoryStats() : GetImplicitProducer()->GetMemoryStats() ).ProducerBlockBytes != 0;
+        }
+
         HAKLE_CPP20_CONSTEXPR ~ProducerListNode() = default;
     };
 
+    static constexpr bool SingleAllocationProducers = SingleAllocationProducersHelper<Traits>::value;
+
+    // Node, producer and the producer's inline storage in one cache line aligned allocation
+    template <class Producer, std::size_t InitialSize>
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) ProducerChunk : ProducerListNode {
+        template <class BlockManagerType>
+        constexpr ProducerChunk( ProducerType InType, ConcurrentQueue* InParent, BlockManagerType* InBlockManager, const AllocatorType& InAllocator )
+            : ProducerListNode( nullptr, InType, InParent ), Queue( Storage, InBlockManager, InAllocator ) {
+            this->Producer = &Queue;
+        }
+
+        typename Producer::template InlineStorage<InitialSize> Storage{};
+        Producer                                               Queue;
+    };
+
+    using ExplicitProducerChunk = ProducerChunk<ExplicitProducer, InitialExplicitQueueSize>;
+    using ImplicitProducerChunk = ProducerChunk<ImplicitProducer, InitialImplicitQueueSize>;
+
+    static constexpr bool        PerCpuProducers      = PerCpuProducersHelper<Traits>::value;
+    static constexpr std::size_t MaxBlocksPerProducer     = MaxBlocksPerProducerHelper<Traits>::value;
+    static constexpr std::size_t MaxIdleBlocksPerProducer = MaxIdleBlocksPerProducerHelper<Traits>::value;
+    static constexpr bool        NoRuntimeAllocation      = NoRuntimeAllocationHelper<Traits>::value;
+
+    static_assert( !NoRuntimeAllocation || !PerCpuProducers, "per-CPU slots are allocated on first use" );
+
+    // producers per CPU, the first is the usual one, the others take the overflow of a preempted holder
+    static constexpr std::size_t SlotsPerCpu = 4;
+
+    // NoRuntimeAllocation traits get every producer, index array and block here, before the queue is shared
+    HAKLE_CPP14_CONSTEXPR void ReserveStaticStorage() {
+        HAKLE_CONSTEXPR_IF( NoRuntimeAllocation ) {
+            if ( !Reserve( Traits::MaxExplicitProducers, Traits::MaxImplicitProducers, Traits::ElementsPerProducer ) ) {
+                // the destructor does not run for a throwing constructor
+                ClearList();
+                HAKLE_THROW( std::bad_alloc() );
+            }
+        }
+    }
+
+    // An implicit producer shared by the threads running on one CPU (SlotsPerCpu of them per CPU); Busy makes them
+    // take turns
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) PerCpuSlot {
+        std::atomic<bool> Busy{ false };
+        ImplicitProducer* Producer{ nullptr };
+    };
+
+    struct PerCpuSlotGuard {
+        PerCpuSlot* Slot;
+        HAKLE_CPP20_CONSTEXPR ~PerCpuSlotGuard() noexcept { Slot->Busy.store( false, std::memory_order_release ); }
+    };
+
+    using PerCpuSlotAllocatorType   = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<PerCpuSlot>;
+    using PerCpuSlotAllocatorTraits = typename HakeAllocatorTraits<AllocatorType>::template RebindTraits<PerCpuSlot>;
+
     HAKLE_CPP14_CONSTEXPR ProducerListNode* GetProducerListNode( ProducerType Type ) noexcept {
         for ( ProducerListNode* Node = ProducerListsHead.load( std::memory_order_relaxed ); Node != nullptr; Node = Node->Next ) {
             if ( Node->Inactive.load( std::memory_order_relaxed ) && Node->Type == Type ) {
@@ -1818,11 +2674,104 @@ private:
             }
         }
 
+        HAKLE_CONSTEXPR_IF( NoRuntimeAllocation ) { return nullptr; }
         return AddProducer( CreateProducerListNode( Type ) );
     }
 
     constexpr void ReclaimProducerLists() noexcept {
-        ForEachProducer( [ this ]( ProducerListNode* Node ) { Node->Parent = this; } );
+        ForEachProducer( [ this ]( ProducerListNode* Node ) {
+            Node->Parent = this;
+            // block managers live inside the queue, so producers must follow them when the queue is moved or swapped
+            if ( Node->Type == ProducerType::Explicit ) {
+                Node->GetExplicitProducer()->SetBlockManager( &ExplicitManager() );
+            }
+            else {
+                Node->GetImplicitProducer()->SetBlockManager( &ImplicitManager() );
+            }
+        } );
+    }
+
+    HAKLE_CPP14_CONSTEXPR bool ReserveProducer( ProducerType Type, std::size_t ElementsPerProducer ) {
+        ProducerListNode* Node = CreateProducerListNode( Type );
+        if ( Node == nullptr ) {
+            return false;
+        }
+
+        bool Result = Type == ProducerType::Explicit ? Node->GetExplicitProducer()->Reserve( ElementsPerProducer ) : Node->GetImplicitProducer()->Reserve( ElementsPerProducer );
+
+        // parked until a token or a new thread takes it over in GetProducerListNode
+        Node->Inactive.store( true, std::memory_order_relaxed );
+        AddProducer( Node );
+        return Result;
+    }
+
+    // Swaps a new producer in for Node's empty one, whose blocks and index then go back to the block manager and
+    // allocator. The block quota and shrink policy stay.
+    // NOTE: not thread safe, the queue may not be in use
+    HAKLE_CPP20_CONSTEXPR void RecycleProducer( ProducerListNode* Node ) {
+        using std::swap;
+        if ( Node->Type == ProducerType::Explicit ) {
+            ExplicitProducer  Old( InitialExplicitQueueSize, &ExplicitManager(), ValueAllocator() );
+            ExplicitProducer& Producer = *Node->GetExplicitProducer();
+            swap( Producer, Old );
+            Producer.SetBlockQuota( Old.GetBlockQuota() );
+            Producer.SetShrinkPolicy( Old.GetShrinkHighWater(), Old.GetShrinkLowWater() );
+        }
+        else {
+            ImplicitProducer  Old( InitialImplicitQueueSize, &ImplicitManager(), ValueAllocator() );
+            ImplicitProducer& Producer = *Node->GetImplicitProducer();
+            swap( Producer, Old );
+            Producer.SetBlockQuota( Old.GetBlockQuota() );
+        }
+    }
+
+    // A parked producer holding no blocks, which a producer of another queue can be swapped into
+    static HAKLE_CPP14_CONSTEXPR bool IsSpliceTarget( const ProducerListNode* Node, ProducerType Type ) noexcept {
+        return Node->Type == Type && Node->Inactive.load( std::memory_order_relaxed ) && !Node->HoldsBlocks();
+    }
+
+    static HAKLE_CPP14_CONSTEXPR ProducerListNode* NextSpliceTarget( ProducerListNode* Node, ProducerType Type ) noexcept {
+        while ( Node != nullptr && !IsSpliceTarget( Node, Type ) ) {
+            Node = Node->Next;
+        }
+        return Node;
+    }
+
+    // Parks as many new empty producers of Type as SpliceFrom( Other ) is short of
+    HAKLE_CPP20_CONSTEXPR bool ParkSpliceTargets( const ConcurrentQueue& Other, ProducerType Type ) {
+        std::size_t Needed = 0;
+        for ( ProducerListNode* Node = Other.ProducerListsHead.load( std::memory_order_relaxed ); Node != nullptr; Node = Node->Next ) {
+            Needed += Node->Type == Type && Node->HoldsBlocks();
+        }
+        for ( ProducerListNode* Node = ProducerListsHead.load( std::memory_order_relaxed ); Node != nullptr && Needed > 0; Node = Node->Next ) {
+            Needed -= IsSpliceTarget( Node, Type );
+        }
+
+        for ( ; Needed > 0; --Needed ) {
+            ProducerListNode* Node = CreateProducerListNode( Type );
+            if ( Node == nullptr ) {
+                return false;
+            }
+            Node->Inactive.store( true, std::memory_order_relaxed );
+            AddProducer( Node );
+        }
+        return true;
+    }
+
+    // Swaps the contents of Other's producer with Node, a parked empty producer here; tokens and threads of Other keep their producer.
+    HAKLE_CPP20_CONSTEXPR void SpliceProducer( ConcurrentQueue& Other, ProducerListNode* OtherNode, ProducerListNode* Node ) {
+        using std::swap;
+        if ( Node->Type == ProducerType::Explicit ) {
+            swap( *Node->GetExplicitProducer(), *OtherNode->GetExplicitProducer() );
+            Node->GetExplicitProducer()->SetBlockManager( &ExplicitManager() );
+            OtherNode->GetExplicitProducer()->SetBlockManager( &Other.ExplicitManager() );
+        }
+        else {
+            swap( *Node->GetImplicitProducer(), *OtherNode->GetImplicitProducer() );
+            Node->GetImplicitProducer()->SetBlockManager( &ImplicitManager() );
+            OtherNode->GetImplicitProducer()->SetBlockManager( &Other.ImplicitManager() );
+        }
+        // stays parked like a reserved producer, consumers drain it and the next token or thread may take it over
     }
 
     HAKLE_CPP14_CONSTEXPR ProducerListNode* AddProducer( ProducerListNode* Node ) {
@@ -1841,6 +2790,13 @@ private:
     }
 
     HAKLE_CPP14_CONSTEXPR ProducerListNode* CreateProducerListNode( ProducerType Type ) {
+        HAKLE_CONSTEXPR_IF( SingleAllocationProducers ) {
+            if ( Type == ProducerType::Explicit ) {
+                return ApplyProducerLimits( CreateProducerChunk<ExplicitProducerChunk>( Type, &ExplicitManager() ) );
+            }
+            return ApplyProducerLimits( CreateProducerChunk<ImplicitProducerChunk>( Type, &ImplicitManager() ) );
+        }
+
         BaseProducer* producer = nullptr;
 
         if ( Type == ProducerType::Explicit ) {
@@ -1855,7 +2811,24 @@ private:
         ProducerListNode* node = ProducerListNodeAllocatorTraits::Allocate( ProducerListNodeAllocator() );
         ProducerListNodeAllocatorTraits::Construct( ProducerListNodeAllocator(), node, producer, Type, this );
 
-        return node;
+        return ApplyProducerLimits( node );
+    }
+
+    HAKLE_CPP14_CONSTEXPR static ProducerListNode* ApplyProducerLimits( ProducerListNode* Node ) noexcept {
+        HAKLE_CONSTEXPR_IF( MaxBlocksPerProducer != 0 ) {
+            if ( Node->Type == ProducerType::Explicit ) {
+                Node->GetExplicitProducer()->SetBlockQuota( MaxBlocksPerProducer );
+            }
+            else {
+                Node->GetImplicitProducer()->SetBlockQuota( MaxBlocksPerProducer );
+            }
+        }
+        HAKLE_CONSTEXPR_IF( MaxIdleBlocksPerProducer != 0 ) {
+            if ( Node->Type == ProducerType::Explicit ) {
+                Node->GetExplicitProducer()->SetShrinkPolicy( MaxIdleBlocksPerProducer, MaxIdleBlocksPerProducer / 2 );
+            }
+        }
+        return Node;
     }
 
     // only used in destructor
@@ -1866,6 +2839,16 @@ private:
 
         ProducerCount.fetch_sub( 1, std::memory_order_relaxed );
 
+        HAKLE_CONSTEXPR_IF( SingleAllocationProducers ) {
+            if ( Node->Type == ProducerType::Explicit ) {
+                DeleteProducerChunk( static_cast<ExplicitProducerChunk*>( Node ) );
+            }
+            else {
+                DeleteProducerChunk( static_cast<ImplicitProducerChunk*>( Node ) );
+            }
+            return;
+        }
+
         if ( Node->Type == ProducerType::Explicit ) {
             ExplicitProducerAllocatorTraits::Destroy( ExplicitProducerAllocator(), Node->GetExplicitProducer() );
             ExplicitProducerAllocatorTraits::Deallocate( ExplicitProducerAllocator(), Node->GetExplicitProducer() );
@@ -1879,6 +2862,31 @@ private:
         ProducerListNodeAllocatorTraits::Deallocate( ProducerListNodeAllocator(), Node );
     }
 
+    template <class Chunk, class BlockManagerType>
+    HAKLE_CPP14_CONSTEXPR ProducerListNode* CreateProducerChunk( ProducerType Type, BlockManagerType* InBlockManager ) {
+        using ChunkAllocatorType   = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<Chunk>;
+        using ChunkAllocatorTraits = typename HakeAllocatorTraits<AllocatorType>::template RebindTraits<Chunk>;
+
+        ChunkAllocatorType ChunkAllocator( ProducerListNodeAllocator() );
+        Chunk*             NewChunk = ChunkAllocatorTraits::Allocate( ChunkAllocator );
+        HAKLE_TRY { ChunkAllocatorTraits::Construct( ChunkAllocator, NewChunk, Type, this, InBlockManager, ValueAllocator() ); }
+        HAKLE_CATCH( ... ) {
+            ChunkAllocatorTraits::Deallocate( ChunkAllocator, NewChunk );
+            HAKLE_RETHROW;
+        }
+        return NewChunk;
+    }
+
+    template <class Chunk>
+    HAKLE_CPP14_CONSTEXPR void DeleteProducerChunk( Chunk* InChunk ) noexcept {
+        using ChunkAllocatorType   = typename HakeAllocatorTraits<AllocatorType>::template RebindAlloc<Chunk>;
+        using ChunkAllocatorTraits = typename HakeAllocatorTraits<AllocatorType>::template RebindTraits<Chunk>;
+
+        ChunkAllocatorType ChunkAllocator( ProducerListNodeAllocator() );
+        ChunkAllocatorTraits::Destroy( ChunkAllocator, InChunk );
+        ChunkAllocatorTraits::Deallocate( ChunkAllocator, InChunk );
+    }
+
     constexpr void ForEachProducer( std::function<void( ProducerListNode* )> Func ) HAKLE_NOEXCEPT( noexcept( Func( nullptr ) ) ) {
         for ( ProducerListNode* Node = ProducerListsHead.load( std::memory_order_relaxed ); Node != nullptr; Node = Node->Next ) {
             Func( Node );
@@ -1948,16 +2956,87 @@ private:
     ImplicitProducer* GetOrAddImplicitProducer() {
         details::thread_id_t thread_id = details::thread_id();
         ImplicitProducer*    producer  = nullptr;
-        HashTableStatus      Result    = ImplicitMap.GetOrAddByFunc( thread_id, producer, [ this, &producer ]() { return producer = GetProducerListNode( ProducerType::Implicit )->GetImplicitProducer(); } );
+        HashTableStatus      Result    = ImplicitMap.GetOrAddByFunc( thread_id, producer, [ this, &producer ]() {
+            ProducerListNode* Node = GetProducerListNode( ProducerType::Implicit );
+            return producer = Node != nullptr ? Node->GetImplicitProducer() : nullptr;
+        } );
         if ( Result == HashTableStatus::FAILED ) {
             return nullptr;
         }
         return producer;
     }
 
-    std::atomic<ProducerListNode*>                                                            ProducerListsHead{};
-    std::atomic<uint32_t>                                                                     ProducerCount{};
-    HashTable<details::thread_id_t, ImplicitProducer*, InitialHashSize, details::thread_hash> ImplicitMap{};
+    // Runs Func on a producer of the current CPU. A thread that was migrated or preempted may still hold
+    // that slot, so the probe goes on through the CPU's overflow slots and then every other slot. Only when
+    // all of them are held does it yield and start over; no thread ever gets a producer of its own.
+    template <class Func>
+    bool EnqueueOnCurrentCpu( Func&& EnqueueFunc ) {
+        PerCpuSlot* Slots = GetPerCpuSlots();
+        if ( Slots == nullptr ) {
+            return false;
+        }
+
+        const std::size_t SlotCount = PerCpuSlotCount();
+        while ( true ) {
+            const std::size_t First = ( details::current_cpu() % details::cpu_count() ) * SlotsPerCpu;
+            for ( std::size_t i = 0; i < SlotCount; ++i ) {
+                PerCpuSlot& Slot = Slots[ ( First + i ) % SlotCount ];
+                if ( Slot.Busy.load( std::memory_order_relaxed ) || Slot.Busy.exchange( true, std::memory_order_acquire ) ) {
+                    continue;
+                }
+                PerCpuSlotGuard Guard{ &Slot };
+                if ( Slot.Producer == nullptr ) {
+                    ProducerListNode* Node = GetProducerListNode( ProducerType::Implicit );
+                    if ( Node == nullptr ) {
+                        return false;
+                    }
+                    Slot.Producer = Node->GetImplicitProducer();
+                }
+                return EnqueueFunc( Slot.Producer );
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    static std::size_t PerCpuSlotCount() noexcept { return details::cpu_count() * SlotsPerCpu; }
+
+    PerCpuSlot* GetPerCpuSlots() {
+        PerCpuSlot* Slots = PerCpuSlots.load( std::memory_order_acquire );
+        if ( HAKLE_LIKELY( Slots != nullptr ) ) {
+            return Slots;
+        }
+
+        PerCpuSlotAllocatorType SlotAllocator( ProducerListNodeAllocator() );
+        PerCpuSlot*             NewSlots = PerCpuSlotAllocatorTraits::Allocate( SlotAllocator, PerCpuSlotCount() );
+        if ( NewSlots == nullptr ) {
+            return nullptr;
+        }
+        for ( std::size_t i = 0; i < PerCpuSlotCount(); ++i ) {
+            PerCpuSlotAllocatorTraits::Construct( SlotAllocator, NewSlots + i );
+        }
+
+        if ( PerCpuSlots.compare_exchange_strong( Slots, NewSlots, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+            return NewSlots;
+        }
+        // another thread won the race
+        DeletePerCpuSlots( NewSlots );
+        return Slots;
+    }
+
+    // The producers themselves live in the producer list and are deleted with it
+    HAKLE_CPP14_CONSTEXPR void DeletePerCpuSlots( PerCpuSlot* Slots ) noexcept {
+        if ( Slots == nullptr ) {
+            return;
+        }
+        PerCpuSlotAllocatorType SlotAllocator( ProducerListNodeAllocator() );
+        PerCpuSlotAllocatorTraits::Destroy( SlotAllocator, Slots, PerCpuSlotCount() );
+        PerCpuSlotAllocatorTraits::Deallocate( SlotAllocator, Slots, PerCpuSlotCount() );
+    }
+
+    std::atomic<ProducerListNode*>                                                                                      ProducerListsHead{};
+    std::atomic<uint32_t>                                                                                               ProducerCount{};
+    std::atomic<PerCpuSlot*>                                                                                            PerCpuSlots{};
+    HashTable<details::thread_id_t, ImplicitProducer*, InitialHashSize, details::thread_hash, ImplicitMapAllocatorType> ImplicitMap{};
 
     CompressPair<ExplicitBlockManagerType, ExplicitProducerAllocatorType>   ExplicitProducerAllocatorPair{};
     CompressPair<ImplicitBlockManagerType, ImplicitProducerAllocatorType>   ImplicitProducerAllocatorPair{};
@@ -97,7 +97,7 @@ private:
 public:
     using Entry = Pair<std::atomic<TKey>, std::atomic<TValue>>;
 
-    explicit HAKLE_CPP14_CONSTEXPR HashTable( TKey InValidKey = TKey{}, const Allocator& InAllocator = Allocator{} ) : PairAllocatorPair( ValueInitTag{}, InAllocator ), INVALID_KEY( InValidKey ) {
+    explicit HAKLE_CPP14_CONSTEXPR HashTable( TKey InValidKey = TKey{}, const Allocator& InAllocator = Allocator{} ) : PairAllocatorPair( ValueInitTag{}, InAllocator ), NodeAllocatorPair( nullptr, NodeAllocatorType( InAllocator ) ), INVALID_KEY( InValidKey ) {
 #ifndef HAKLE_USE_CONCEPT
         assert( std::atomic<TValue>{}.is_lock_free() );
 #endif
@@ -112,7 +112,8 @@ public:
 
     // NOTE: This is intentionally not thread safe; it is up to the user to synchronize this call.
     HAKLE_CPP14_CONSTEXPR HashTable( HashTable&& Other ) noexcept
-        : HAKLE_MOVE_ATOMIC( EntriesCount ), PairAllocatorPair( ValueInitTag{}, std::move( Other.PairAllocator() ) ), HAKLE_MOVE_PAIR_ATOMIC1( NodeAllocatorPair ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, Hash, INVALID_KEY ) {
+        : HAKLE_MOVE_ATOMIC( EntriesCount ), PairAllocatorPair( ValueInitTag{}, std::move( Other.PairAllocator() ) ), HAKLE_MOVE_PAIR_ATOMIC1( NodeAllocatorPair ), HAKLE_FOR_EACH_COMMA( HAKLE_MOVE, Hash, INVALID_KEY ),
+          HAKLE_MOVE_ATOMIC( NodeBytes ) {
         Other.Reset();
     }
 
@@ -120,7 +121,7 @@ public:
     HAKLE_CPP14_CONSTEXPR HashTable& operator=( HashTable&& Other ) noexcept {
         if ( this != &Other ) {
             Clear();
-            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, EntriesCount, MainHash() );
+            HAKLE_FOR_EACH( HAKLE_OP_MOVE_ATOMIC, HAKLE_SEM, EntriesCount, MainHash(), NodeBytes );
             HAKLE_FOR_EACH( HAKLE_OP_MOVE, HAKLE_SEM, PairAllocator(), NodeAllocator(), Hash, INVALID_KEY );
             HashResizeInProgressFlag().clear( std::memory_order_relaxed );
             Other.Reset();
@@ -136,7 +137,7 @@ public:
     HAKLE_CPP14_CONSTEXPR void swap( HashTable& Other ) noexcept HAKLE_REQUIRES( std::swappable<HashType>&& std::swappable<TKey>&& std::swappable<PairAllocatorType>&& std::swappable<NodeAllocatorType> ) {
         // can't swap during resizing.
         if ( this != &Other ) {
-            HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, EntriesCount, MainHash() );
+            HAKLE_FOR_EACH( HAKLE_SWAP_ATOMIC, HAKLE_SEM, EntriesCount, MainHash(), NodeBytes );
             using std::swap;
             HAKLE_FOR_EACH( HAKLE_SWAP, HAKLE_SEM, Hash, INVALID_KEY, PairAllocator(), NodeAllocator() );
             HashResizeInProgressFlag().clear( std::memory_order_relaxed );
@@ -158,6 +159,7 @@ public:
         EntriesCount.store( 0, std::memory_order_relaxed );
         MainHash().store( nullptr, std::memory_order_relaxed );
         HashResizeInProgressFlag().clear( std::memory_order_relaxed );
+        NodeBytes.store( 0, std::memory_order_relaxed );
     }
 
     HAKLE_CPP14_CONSTEXPR bool Get( const TKey& Key, TValue& OutValue ) const noexcept {
@@ -228,6 +230,13 @@ public:
 
     HAKLE_NODISCARD constexpr std::size_t GetSize() const noexcept { return EntriesCount.load( std::memory_order_relaxed ); }
 
+    // nodes superseded by a resize are kept until Clear, so they are counted too
+    HAKLE_NODISCARD MemoryStats GetMemoryStats() const noexcept {
+        MemoryStats Stats;
+        Stats.HashBytes = NodeBytes.load( std::memory_order_relaxed );
+        return Stats;
+    }
+
 private:
     HashNode* CreateNewHashNode( std::size_t InCapacity ) {
         HashNode* NewNode = NodeAllocatorTraits::Allocate( NodeAllocator() );
@@ -237,6 +246,7 @@ private:
             PairAllocatorTraits::Construct( PairAllocator(), NewNode->Entries + i );
             NewNode->Entries[ i ].First.store( INVALID_KEY, std::memory_order_relaxed );
         }
+        NodeBytes.fetch_add( sizeof( HashNode ) + InCapacity * sizeof( Entry ), std::memory_order_relaxed );
         return NewNode;
     }
 
@@ -245,6 +255,7 @@ private:
         for ( std::size_t i = 0; i < Capacity; ++i ) {
             PairAllocatorTraits::Destroy( PairAllocator(), Node->Entries + i );
         }
+        NodeBytes.fetch_sub( sizeof( HashNode ) + Capacity * sizeof( Entry ), std::memory_order_relaxed );
         PairAllocatorTraits::Deallocate( PairAllocator(), Node->Entries, Node->Capacity );
         NodeAllocatorTraits::Destroy( NodeAllocator(), Node );
         NodeAllocatorTraits::Deallocate( NodeAllocator(), Node, 1 );
@@ -356,6 +367,8 @@ private:
     // TODO: use compress pair
     HashType Hash{};
     TKey     INVALID_KEY{};
+    // bytes of the live hash nodes and their entries
+    std::atomic<std::size_t> NodeBytes{ 0 };
 
     HAKLE_CPP14_CONSTEXPR PairAllocatorType& PairAllocator() noexcept { return PairAllocatorPair.Second(); }
     HAKLE_CPP14_CONSTEXPR NodeAllocatorType& NodeAllocator() noexcept { return NodeAllocatorPair.Second(); }
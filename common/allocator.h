@@ -5,7 +5,10 @@
 #ifndef ALLOCATOR_H
 #define ALLOCATOR_H
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <new>
 #include <type_traits>
 #if defined( ENABLE_MEMORY_LEAK_DETECTION )
 #include <atomic>
@@ -17,6 +20,22 @@
 #include "common/common.h"
 #include "memory.h"
 
+#if HAKLE_CPP_VERSION >= 17 && defined( __has_include )
+#if __has_include( <memory_resource> )
+#include <memory_resource>
+#define HAKLE_HAS_PMR 1
+#endif
+#endif
+
+#if defined( __linux__ ) && defined( __has_include )
+#if __has_include( <sys/mman.h> )
+#include <atomic>
+#include <sys/mman.h>
+#include <unistd.h>
+#define HAKLE_HAS_MMAP 1
+#endif
+#endif
+
 namespace hakle {
 
 template <class, class Alloc, class... Args>
@@ -113,11 +132,193 @@ struct HakeAllocatorTraits {
     static void Destroy( AllocatorType& Allocator, Pointer first, Pointer last ) noexcept { Destroy( Allocator, first, last - first ); }
 };
 
+// Small dense index of the calling thread, threads started one after another get neighbouring indices
+inline std::size_t CurrentThreadIndex() noexcept {
+    static std::atomic<std::size_t> NextIndex{ 0 };
+    thread_local const std::size_t  Index = NextIndex.fetch_add( 1, std::memory_order_relaxed );
+    return Index;
+}
+
+// Signed count split over cache-line shards like LeakCounters, for counts bumped on hot paths of many threads and
+// summed only when someone asks. Moves and swaps are only safe while neither counter is in use.
+class ShardedCounter {
+public:
+    constexpr static std::size_t ShardCount = 16;
+
+    ShardedCounter() noexcept = default;
+    ~ShardedCounter()         = default;
+
+    ShardedCounter( ShardedCounter&& Other ) noexcept { Add( Other.Exchange() ); }
+    ShardedCounter& operator=( ShardedCounter&& Other ) noexcept {
+        if ( this != &Other ) {
+            Exchange();
+            Add( Other.Exchange() );
+        }
+        return *this;
+    }
+
+    ShardedCounter( const ShardedCounter& )            = delete;
+    ShardedCounter& operator=( const ShardedCounter& ) = delete;
+
+    void swap( ShardedCounter& Other ) noexcept {
+        std::ptrdiff_t Mine = Exchange();
+        Add( Other.Exchange() );
+        Other.Add( Mine );
+    }
+
+    void Add( std::ptrdiff_t n ) noexcept { Shards[ CurrentThreadIndex() % ShardCount ].Value.fetch_add( n, std::memory_order_relaxed ); }
+
+    HAKLE_NODISCARD std::ptrdiff_t Get() const noexcept {
+        std::ptrdiff_t Sum = 0;
+        for ( const Shard& Current : Shards ) {
+            Sum += Current.Value.load( std::memory_order_relaxed );
+        }
+        return Sum;
+    }
+
+    // zeroes the count, returns what it was
+    std::ptrdiff_t Exchange() noexcept {
+        std::ptrdiff_t Sum = 0;
+        for ( Shard& Current : Shards ) {
+            Sum += Current.Value.exchange( 0, std::memory_order_relaxed );
+        }
+        return Sum;
+    }
+
+private:
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) Shard {
+        std::atomic<std::ptrdiff_t> Value{ 0 };
+    };
+
+    Shard Shards[ ShardCount ];
+};
+
+// Epoch based pinning for memory one reclaiming thread unlinks while other threads may still read it.
+// A reader pins the current epoch on its thread's shard for the short time it reads. Something unlinked while the epoch
+// was E may be freed once the epoch reached E + 2: each step is only taken when no pin of the epoch before is left, so
+// every reader that could have seen it is gone. Readers never wait, the reclaimer just frees later.
+// Moves and swaps are only safe while nothing is pinned.
+class EpochPins {
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) Shard {
+        // pins of even and odd epochs
+        std::atomic<std::size_t> Pins[ 2 ]{};
+    };
+
+public:
+    constexpr static std::size_t ShardCount = 16;
+
+    EpochPins() noexcept = default;
+    ~EpochPins()         = default;
+
+    EpochPins( EpochPins&& Other ) noexcept : Epoch( Other.Epoch.load( std::memory_order_relaxed ) ) {}
+    EpochPins& operator=( EpochPins&& Other ) noexcept {
+        Epoch.store( Other.Epoch.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        return *this;
+    }
+
+    EpochPins( const EpochPins& )            = delete;
+    EpochPins& operator=( const EpochPins& ) = delete;
+
+    void swap( EpochPins& Other ) noexcept {
+        std::uint64_t Mine = Epoch.load( std::memory_order_relaxed );
+        Epoch.store( Other.Epoch.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        Other.Epoch.store( Mine, std::memory_order_relaxed );
+    }
+
+    // Pins the epoch for the guard's lifetime. The increment is seq_cst like the reload of the epoch after it and the
+    // reclaimer's store, so either the reclaimer sees the pin or the reader sees the new epoch and pins that one.
+    class Guard {
+    public:
+        explicit Guard( EpochPins& InPins ) noexcept : Own( InPins.Shards[ CurrentThreadIndex() % ShardCount ] ) {
+            Pinned = InPins.Epoch.load( std::memory_order_relaxed );
+            while ( true ) {
+                Own.Pins[ Pinned & 1 ].fetch_add( 1, std::memory_order_seq_cst );
+                std::uint64_t Now = InPins.Epoch.load( std::memory_order_seq_cst );
+                if ( Now == Pinned ) {
+                    return;
+                }
+                Own.Pins[ Pinned & 1 ].fetch_sub( 1, std::memory_order_relaxed );
+                Pinned = Now;
+            }
+        }
+        ~Guard() { Own.Pins[ Pinned & 1 ].fetch_sub( 1, std::memory_order_release ); }
+
+        Guard( const Guard& )            = delete;
+        Guard& operator=( const Guard& ) = delete;
+
+    private:
+        Shard&        Own;
+        std::uint64_t Pinned{};
+    };
+
+    HAKLE_NODISCARD std::uint64_t GetEpoch() const noexcept { return Epoch.load( std::memory_order_seq_cst ); }
+
+    // Moves the epoch on when no pin of the previous epoch is left, returns the current epoch. Several reclaimers may
+    // call it, the CAS lets only one of them move the epoch past the one they all checked.
+    std::uint64_t TryAdvance() noexcept {
+        std::uint64_t Current = Epoch.load( std::memory_order_seq_cst );
+        for ( const Shard& Each : Shards ) {
+            if ( Each.Pins[ ( Current + 1 ) & 1 ].load( std::memory_order_seq_cst ) != 0 ) {
+                return Current;
+            }
+        }
+        if ( Epoch.compare_exchange_strong( Current, Current + 1, std::memory_order_seq_cst, std::memory_order_seq_cst ) ) {
+            return Current + 1;
+        }
+        return Current;
+    }
+
+    // memory unlinked while the epoch was InEpoch can be freed
+    HAKLE_NODISCARD static bool CanFree( std::uint64_t InEpoch, std::uint64_t Current ) noexcept { return Current >= InEpoch + 2; }
+
+private:
+    std::atomic<std::uint64_t> Epoch{ 0 };
+    Shard                      Shards[ ShardCount ];
+};
+
 #if defined( ENABLE_MEMORY_LEAK_DETECTION )
 inline std::mutex& GetMutex() {
     static std::mutex print_mtx;
     return print_mtx;
 }
+
+// Live allocation and construction counts split over cache-line shards picked by thread index, so threads hammering
+// one allocator do not bounce a shared counter. A shard goes negative when another thread frees what it allocated,
+// only the sum over all shards is meaningful and it is only taken when someone asks.
+class LeakCounters {
+public:
+    constexpr static std::size_t ShardCount = 16;
+
+    void AddAllocated( std::ptrdiff_t n ) noexcept { Own().Allocated.fetch_add( n, std::memory_order_relaxed ); }
+    void AddConstructed( std::ptrdiff_t n ) noexcept { Own().Constructed.fetch_add( n, std::memory_order_relaxed ); }
+
+    HAKLE_NODISCARD std::ptrdiff_t GetAllocated() const noexcept {
+        std::ptrdiff_t Sum = 0;
+        for ( const Shard& Current : Shards ) {
+            Sum += Current.Allocated.load( std::memory_order_relaxed );
+        }
+        return Sum;
+    }
+
+    HAKLE_NODISCARD std::ptrdiff_t GetConstructed() const noexcept {
+        std::ptrdiff_t Sum = 0;
+        for ( const Shard& Current : Shards ) {
+            Sum += Current.Constructed.load( std::memory_order_relaxed );
+        }
+        return Sum;
+    }
+
+private:
+    struct alignas( HAKLE_CACHE_LINE_SIZE ) Shard {
+        std::atomic<std::ptrdiff_t> Allocated{ 0 };
+        std::atomic<std::ptrdiff_t> Constructed{ 0 };
+    };
+
+    Shard& Own() noexcept { return Shards[ CurrentThreadIndex() % ShardCount ]; }
+
+    Shard Shards[ ShardCount ];
+};
+
 template <class Tp>
 class HakleAllocator {
 public:
@@ -149,55 +350,59 @@ public:
 
     ~HakleAllocator() = default;
 
-    struct Info {
-        std::atomic<int> ConstructCount{ 0 };
-        std::atomic<int> AllocateCount{ 0 };
+    struct Info : LeakCounters {
         Info() {}
         ~Info() {
-            if ( AllocateCount.load() != 0 || ConstructCount.load() != 0 ) {
+            const std::ptrdiff_t Allocated   = GetAllocated();
+            const std::ptrdiff_t Constructed = GetConstructed();
+            if ( Allocated != 0 || Constructed != 0 ) {
                 std::lock_guard<std::mutex> lock( GetMutex() );
-                fprintf( stderr, "\033[31m[%s] Quit with Allocate=%d, Construct=%d\033[0m\n", typeid( Tp ).name(), AllocateCount.load(), ConstructCount.load() );
+                fprintf( stderr, "\033[31m[%s] Quit with Allocate=%td, Construct=%td\033[0m\n", typeid( Tp ).name(), Allocated, Constructed );
                 fflush( stderr );
             }
-            // printf( "[%s] DELETED\n", typeid( Tp ).name() );
         }
     };
 
     static Info info;
 
+    // objects allocated and not yet deallocated, summed over all threads
+    HAKLE_NODISCARD static std::ptrdiff_t GetLiveAllocations() noexcept { return info.GetAllocated(); }
+    // objects constructed and not yet destroyed, summed over all threads
+    HAKLE_NODISCARD static std::ptrdiff_t GetLiveConstructions() noexcept { return info.GetConstructed(); }
+
     HAKLE_CPP14_CONSTEXPR void swap( HakleAllocator& ) noexcept {}
 
     constexpr Pointer Allocate() {
-        ++info.AllocateCount;
+        info.AddAllocated( 1 );
         return HAKLE_OPERATOR_NEW( Tp );
     }
     constexpr Pointer Allocate( SizeType n ) {
-        info.AllocateCount += static_cast<int>( n );
+        info.AddAllocated( static_cast<std::ptrdiff_t>( n ) );
         return HAKLE_OPERATOR_NEW_ARRAY( Tp, n );
     }
 
     constexpr void Deallocate( Pointer ptr ) noexcept {
         HAKLE_OPERATOR_DELETE( ptr );
-        --info.AllocateCount;
+        info.AddAllocated( -1 );
     }
-    constexpr void Deallocate( Pointer ptr, HAKLE_MAYBE_UNUSED SizeType n ) noexcept {
-        Deallocate( ptr );
-        info.AllocateCount -= static_cast<int>( n - 1 );
+    constexpr void Deallocate( Pointer ptr, SizeType n ) noexcept {
+        HAKLE_OPERATOR_DELETE( ptr );
+        info.AddAllocated( -static_cast<std::ptrdiff_t>( n ) );
     }
 
     template <class... Args>
     constexpr void Construct( Pointer ptr, Args&&... args ) {
         HAKLE_CONSTRUCT( ptr, std::forward<Args>( args )... );
-        ++info.ConstructCount;
+        info.AddConstructed( 1 );
     }
 
     constexpr void Destroy( Pointer ptr ) noexcept {
         HAKLE_DESTROY( ptr );
-        --info.ConstructCount;
+        info.AddConstructed( -1 );
     }
     constexpr void Destroy( Pointer ptr, SizeType n ) noexcept {
         HAKLE_DESTROY_ARRAY( ptr, n );
-        info.ConstructCount -= static_cast<int>( n );
+        info.AddConstructed( -static_cast<std::ptrdiff_t>( n ) );
     }
     constexpr void Destroy( Pointer first, Pointer last ) noexcept { Destroy( first, last - first ); }
 };
@@ -271,6 +476,883 @@ HAKLE_CPP14_CONSTEXPR void swap( HakleAllocator<Tp>& X, HakleAllocator<Tp>& Y )
     X.swap( Y );
 }
 
+// Backs large array allocations with 2MB pages: MAP_HUGETLB first, then an aligned anonymous mapping advised with
+// MADV_HUGEPAGE, then regular pages. Small and single-object allocations use aligned operator new. Every allocation
+// is aligned to at least HAKLE_CACHE_LINE_SIZE.
+template <class Tp>
+class HakleHugePageAllocator {
+public:
+    using ValueType      = Tp;
+    using Pointer        = Tp*;
+    using ConstPointer   = const Tp*;
+    using Reference      = Tp&;
+    using ConstReference = const Tp&;
+    using SizeType       = size_t;
+    using DifferenceType = std::ptrdiff_t;
+
+    constexpr static std::size_t HugePageSize = static_cast<std::size_t>( 2 ) << 20;
+    // rounding below this up to a whole huge page would waste more than half of it
+    constexpr static std::size_t HugePageThreshold = HugePageSize / 2;
+    constexpr static std::size_t Alignment         = alignof( Tp ) > HAKLE_CACHE_LINE_SIZE ? alignof( Tp ) : HAKLE_CACHE_LINE_SIZE;
+
+    constexpr HakleHugePageAllocator() noexcept = default;
+
+    template <class Up>
+    explicit constexpr HakleHugePageAllocator( const HakleHugePageAllocator<Up>& ) noexcept {}
+
+    template <class Up>
+    explicit constexpr HakleHugePageAllocator( const HakleHugePageAllocator<Up>&& ) noexcept {}
+
+    template <class Up>
+    constexpr HakleHugePageAllocator& operator=( const HakleHugePageAllocator<Up>& ) noexcept {
+        return *this;
+    }
+
+    template <class Up>
+    constexpr HakleHugePageAllocator& operator=( const HakleHugePageAllocator<Up>&& ) noexcept {
+        return *this;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void swap( HakleHugePageAllocator& ) noexcept {}
+
+    static Pointer Allocate() { return static_cast<Pointer>( ::operator new( sizeof( Tp ), static_cast<std::align_val_t>( Alignment ) ) ); }
+    static Pointer Allocate( SizeType n ) {
+#if defined( HAKLE_HAS_MMAP )
+        if ( UsesHugePages( n ) ) {
+            return static_cast<Pointer>( MapHugePages( MappedBytes( n ) ) );
+        }
+#endif
+        return static_cast<Pointer>( ::operator new( n * sizeof( Tp ), static_cast<std::align_val_t>( Alignment ) ) );
+    }
+
+    static void Deallocate( Pointer ptr ) noexcept { ::operator delete( ptr, static_cast<std::align_val_t>( Alignment ) ); }
+    static void Deallocate( Pointer ptr, SizeType n ) noexcept {
+#if defined( HAKLE_HAS_MMAP )
+        if ( UsesHugePages( n ) ) {
+            ::munmap( ptr, MappedBytes( n ) );
+            return;
+        }
+#endif
+        Deallocate( ptr );
+    }
+
+    template <class... Args>
+    static constexpr void Construct( Pointer ptr, Args&&... args ) {
+        HAKLE_CONSTRUCT( ptr, std::forward<Args>( args )... );
+    }
+
+    static constexpr void Destroy( Pointer ptr ) noexcept { HAKLE_DESTROY( ptr ); }
+    static constexpr void Destroy( Pointer ptr, SizeType n ) noexcept { HAKLE_DESTROY_ARRAY( ptr, n ); }
+    static constexpr void Destroy( Pointer first, Pointer last ) noexcept { Destroy( first, last - first ); }
+
+    HAKLE_NODISCARD static constexpr bool UsesHugePages( SizeType n ) noexcept {
+#if defined( HAKLE_HAS_MMAP )
+        return n >= ( HugePageThreshold + sizeof( Tp ) - 1 ) / sizeof( Tp );
+#else
+        return ( void )n, false;
+#endif
+    }
+
+private:
+#if defined( HAKLE_HAS_MMAP )
+    static constexpr std::size_t MappedBytes( SizeType n ) noexcept { return ( n * sizeof( Tp ) + HugePageSize - 1 ) & ~( HugePageSize - 1 ); }
+
+    static void* MapHugePages( std::size_t Bytes ) {
+        // most systems reserve no hugetlbfs pages; stop asking once the kernel has refused
+        static std::atomic<bool> HugeTlbUnavailable{ false };
+#if defined( MAP_HUGETLB )
+        if ( !HugeTlbUnavailable.load( std::memory_order_relaxed ) ) {
+            void* Ptr = ::mmap( nullptr, Bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+            if ( Ptr != MAP_FAILED ) {
+                return Ptr;
+            }
+            HugeTlbUnavailable.store( true, std::memory_order_relaxed );
+        }
+#endif
+        // over-map by one huge page so the range can be trimmed to a 2MB boundary, which transparent huge pages need
+        void* Raw = ::mmap( nullptr, Bytes + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if ( Raw == MAP_FAILED ) {
+            HAKLE_THROW( std::bad_alloc() );
+        }
+        char*       Begin   = static_cast<char*>( Raw );
+        char*       Aligned = reinterpret_cast<char*>( ( reinterpret_cast<std::uintptr_t>( Begin ) + HugePageSize - 1 ) & ~( HugePageSize - 1 ) );
+        std::size_t Head    = static_cast<std::size_t>( Aligned - Begin );
+        if ( Head != 0 ) {
+            ::munmap( Begin, Head );
+        }
+        ::munmap( Aligned + Bytes, HugePageSize - Head );
+#if defined( MADV_HUGEPAGE )
+        // failure only means the kernel keeps regular pages for this range
+        ::madvise( Aligned, Bytes, MADV_HUGEPAGE );
+#endif
+        return Aligned;
+    }
+#endif
+};
+
+template <class Tp>
+HAKLE_CPP14_CONSTEXPR bool operator==( const HakleHugePageAllocator<Tp>&, const HakleHugePageAllocator<Tp>& ) noexcept {
+    return true;
+}
+
+template <class Tp>
+HAKLE_CPP14_CONSTEXPR bool operator!=( const HakleHugePageAllocator<Tp>& X, const HakleHugePageAllocator<Tp>& Y ) noexcept {
+    return !( X == Y );
+}
+
+template <class Tp>
+HAKLE_CPP14_CONSTEXPR void swap( HakleHugePageAllocator<Tp>& X, HakleHugePageAllocator<Tp>& Y ) noexcept {
+    X.swap( Y );
+}
+
+// mlock failures of every HaklePinnedAllocator instantiation; usually RLIMIT_MEMLOCK is too small
+inline std::atomic<std::size_t>& PinnedLockFailures() noexcept {
+    static std::atomic<std::size_t> Failures{ 0 };
+    return Failures;
+}
+
+// Storage for real-time use: every page is faulted in when it is allocated and, if LOCK is set, locked into RAM so
+// the hot path never takes a page fault. Array allocations of a page or more get their own MAP_POPULATE mapping that
+// is unlocked by munmap. Smaller ones come from aligned operator new; their pages may be shared with other objects, so
+// they are locked but never unlocked. A failed mlock is not fatal and only bumps GetLockFailures().
+template <class Tp, bool LOCK = true>
+class HaklePinnedAllocator {
+public:
+    using ValueType      = Tp;
+    using Pointer        = Tp*;
+    using ConstPointer   = const Tp*;
+    using Reference      = Tp&;
+    using ConstReference = const Tp&;
+    using SizeType       = size_t;
+    using DifferenceType = std::ptrdiff_t;
+
+    // the generic rebind only handles type parameters
+    template <class Up>
+    struct rebind {
+        using other = HaklePinnedAllocator<Up, LOCK>;
+    };
+
+    constexpr static bool        LockMemory = LOCK;
+    constexpr static std::size_t Alignment  = alignof( Tp ) > HAKLE_CACHE_LINE_SIZE ? alignof( Tp ) : HAKLE_CACHE_LINE_SIZE;
+
+    constexpr HaklePinnedAllocator() noexcept = default;
+
+    template <class Up>
+    explicit constexpr HaklePinnedAllocator( const HaklePinnedAllocator<Up, LOCK>& ) noexcept {}
+
+    template <class Up>
+    constexpr HaklePinnedAllocator& operator=( const HaklePinnedAllocator<Up, LOCK>& ) noexcept {
+        return *this;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void swap( HaklePinnedAllocator& ) noexcept {}
+
+    static Pointer Allocate() { return Allocate( 1 ); }
+    static Pointer Allocate( SizeType n ) {
+        std::size_t Bytes = n * sizeof( Tp );
+#if defined( HAKLE_HAS_MMAP )
+        if ( UsesMapping( n ) ) {
+            std::size_t Mapped = MappedBytes( n );
+            void*       Ptr    = ::mmap( nullptr, Mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0 );
+            if ( Ptr == MAP_FAILED ) {
+                HAKLE_THROW( std::bad_alloc() );
+            }
+            Pin( Ptr, Mapped );
+            return static_cast<Pointer>( Ptr );
+        }
+#endif
+        void* Ptr = ::operator new( Bytes, static_cast<std::align_val_t>( Alignment ) );
+        Pin( Ptr, Bytes );
+        return static_cast<Pointer>( Ptr );
+    }
+
+    static void Deallocate( Pointer ptr ) noexcept { ::operator delete( ptr, static_cast<std::align_val_t>( Alignment ) ); }
+    static void Deallocate( Pointer ptr, SizeType n ) noexcept {
+#if defined( HAKLE_HAS_MMAP )
+        if ( UsesMapping( n ) ) {
+            ::munmap( ptr, MappedBytes( n ) );
+            return;
+        }
+#endif
+        Deallocate( ptr );
+    }
+
+    template <class... Args>
+    static constexpr void Construct( Pointer ptr, Args&&... args ) {
+        HAKLE_CONSTRUCT( ptr, std::forward<Args>( args )... );
+    }
+
+    static constexpr void Destroy( Pointer ptr ) noexcept { HAKLE_DESTROY( ptr ); }
+    static constexpr void Destroy( Pointer ptr, SizeType n ) noexcept { HAKLE_DESTROY_ARRAY( ptr, n ); }
+    static constexpr void Destroy( Pointer first, Pointer last ) noexcept { Destroy( first, last - first ); }
+
+    HAKLE_NODISCARD static std::size_t GetLockFailures() noexcept { return PinnedLockFailures().load( std::memory_order_relaxed ); }
+
+    HAKLE_NODISCARD static bool UsesMapping( SizeType n ) noexcept {
+#if defined( HAKLE_HAS_MMAP )
+        return n > 1 && n * sizeof( Tp ) >= PageSize();
+#else
+        return ( void )n, false;
+#endif
+    }
+
+    HAKLE_NODISCARD static std::size_t PageSize() noexcept {
+#if defined( HAKLE_HAS_MMAP )
+        static const std::size_t Size = static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+        return Size;
+#else
+        return 4096;
+#endif
+    }
+
+private:
+    static std::size_t MappedBytes( SizeType n ) noexcept { return ( n * sizeof( Tp ) + PageSize() - 1 ) & ~( PageSize() - 1 ); }
+
+    static void Pin( void* Ptr, std::size_t Bytes ) noexcept {
+        // write one byte per page so the fault happens now; MAP_POPULATE ranges are already resident
+        volatile char* Begin = static_cast<volatile char*>( Ptr );
+        for ( std::size_t Offset = 0; Offset < Bytes; Offset += PageSize() ) {
+            Begin[ Offset ] = 0;
+        }
+        if ( Bytes != 0 ) {
+            Begin[ Bytes - 1 ] = 0;
+        }
+#if defined( HAKLE_HAS_MMAP )
+        HAKLE_CONSTEXPR_IF( LOCK ) {
+            if ( ::mlock( Ptr, Bytes ) != 0 ) {
+                PinnedLockFailures().fetch_add( 1, std::memory_order_relaxed );
+            }
+        }
+#endif
+    }
+};
+
+template <class Tp, bool LOCK>
+HAKLE_CPP14_CONSTEXPR bool operator==( const HaklePinnedAllocator<Tp, LOCK>&, const HaklePinnedAllocator<Tp, LOCK>& ) noexcept {
+    return true;
+}
+
+template <class Tp, bool LOCK>
+HAKLE_CPP14_CONSTEXPR bool operator!=( const HaklePinnedAllocator<Tp, LOCK>& X, const HaklePinnedAllocator<Tp, LOCK>& Y ) noexcept {
+    return !( X == Y );
+}
+
+template <class Tp, bool LOCK>
+HAKLE_CPP14_CONSTEXPR void swap( HaklePinnedAllocator<Tp, LOCK>& X, HaklePinnedAllocator<Tp, LOCK>& Y ) noexcept {
+    X.swap( Y );
+}
+
+// Thread-safe bump arena behind HakleArenaAllocator. Requests are carved from chunks with a fetch_add and only go back
+// to the system when the arena is destroyed; requests over a quarter of a chunk are left to operator new.
+class HakleArena {
+public:
+    constexpr static std::size_t DefaultChunkSize = static_cast<std::size_t>( 64 ) << 10;
+
+    explicit HakleArena( std::size_t InChunkSize = DefaultChunkSize ) noexcept : ChunkSize( InChunkSize < MinChunkSize ? MinChunkSize : InChunkSize ) {}
+
+    ~HakleArena() {
+        Chunk* Current = Newest.load( std::memory_order_relaxed );
+        while ( Current != nullptr ) {
+            Chunk* Next = Current->Next;
+            ::operator delete( Current, static_cast<std::align_val_t>( ChunkAlignment ) );
+            Current = Next;
+        }
+    }
+
+    HakleArena( const HakleArena& )            = delete;
+    HakleArena& operator=( const HakleArena& ) = delete;
+
+    // whether Allocate serves a request of Bytes aligned to Alignment
+    HAKLE_NODISCARD constexpr bool Serves( std::size_t Bytes, std::size_t Alignment ) const noexcept { return Reserved( Bytes, Alignment ) <= ChunkSize / 4; }
+
+    void* Allocate( std::size_t Bytes, std::size_t Alignment ) {
+        const std::size_t Size    = Reserved( Bytes, Alignment );
+        Chunk*            Current = Newest.load( std::memory_order_acquire );
+        while ( true ) {
+            if ( Current != nullptr ) {
+                std::size_t Offset = Current->Used.fetch_add( Size, std::memory_order_relaxed );
+                if ( Offset + Size <= ChunkSize - ChunkHeader ) {
+                    return AlignUp( Current->Data() + Offset, Alignment );
+                }
+            }
+
+            Chunk* Latest = Newest.load( std::memory_order_acquire );
+            if ( Latest != Current ) {
+                Current = Latest;
+                continue;
+            }
+
+            // the creator claims its bytes before the chunk is published, a chunk that loses the race is freed again
+            Chunk* NewChunk = ::new ( ::operator new( ChunkSize, static_cast<std::align_val_t>( ChunkAlignment ) ) ) Chunk{ Current, { Size } };
+            if ( Newest.compare_exchange_strong( Current, NewChunk, std::memory_order_release, std::memory_order_acquire ) ) {
+                ChunkCount.fetch_add( 1, std::memory_order_relaxed );
+                return AlignUp( NewChunk->Data(), Alignment );
+            }
+            ::operator delete( NewChunk, static_cast<std::align_val_t>( ChunkAlignment ) );
+        }
+    }
+
+    // bytes held in chunks, requests left to operator new are not counted
+    HAKLE_NODISCARD std::size_t GetBytes() const noexcept { return ChunkCount.load( std::memory_order_relaxed ) * ChunkSize; }
+    HAKLE_NODISCARD constexpr std::size_t GetChunkSize() const noexcept { return ChunkSize; }
+
+    // shared by the allocator copies, the last one to let go destroys the arena
+    void AddRef() noexcept { Refs.fetch_add( 1, std::memory_order_relaxed ); }
+    HAKLE_NODISCARD bool Release() noexcept { return Refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1; }
+
+private:
+    constexpr static std::size_t BaseAlignment  = alignof( std::max_align_t );
+    constexpr static std::size_t ChunkAlignment = HAKLE_CACHE_LINE_SIZE > BaseAlignment ? HAKLE_CACHE_LINE_SIZE : BaseAlignment;
+
+    struct Chunk {
+        Chunk*                   Next;
+        std::atomic<std::size_t> Used;
+
+        char* Data() noexcept { return reinterpret_cast<char*>( this ) + ChunkHeader; }
+    };
+
+    constexpr static std::size_t ChunkHeader  = ( sizeof( Chunk ) + ChunkAlignment - 1 ) & ~( ChunkAlignment - 1 );
+    constexpr static std::size_t MinChunkSize = 4 * ChunkHeader + 4096;
+
+    // every reservation keeps the next one BaseAlignment aligned, a stricter alignment pays its padding up front
+    static constexpr std::size_t Reserved( std::size_t Bytes, std::size_t Alignment ) noexcept {
+        std::size_t Rounded = ( Bytes + BaseAlignment - 1 ) & ~( BaseAlignment - 1 );
+        return Alignment > BaseAlignment ? Rounded + Alignment - BaseAlignment : Rounded;
+    }
+
+    static void* AlignUp( char* Ptr, std::size_t Alignment ) noexcept {
+        return reinterpret_cast<void*>( ( reinterpret_cast<std::uintptr_t>( Ptr ) + Alignment - 1 ) & ~( static_cast<std::uintptr_t>( Alignment ) - 1 ) );
+    }
+
+    std::atomic<Chunk*>      Newest{ nullptr };
+    std::atomic<std::size_t> ChunkCount{ 0 };
+    std::atomic<std::size_t> Refs{ 1 };
+    std::size_t              ChunkSize;
+};
+
+// Monotonic allocator over a HakleArena shared by all copies and rebinds, so a queue built with it serves its producers,
+// producer list nodes, index arrays and hash nodes from one arena that is freed in one shot with the queue.
+// Deallocate only gives back what bypassed the arena: arrays too large for a chunk, such as block pools and slabs.
+// A default-constructed allocator starts its own arena.
+template <class Tp>
+class HakleArenaAllocator {
+public:
+    using ValueType      = Tp;
+    using Pointer        = Tp*;
+    using ConstPointer   = const Tp*;
+    using Reference      = Tp&;
+    using ConstReference = const Tp&;
+    using SizeType       = size_t;
+    using DifferenceType = std::ptrdiff_t;
+
+    HakleArenaAllocator() : State( HAKLE_NEW( HakleArena ) ) {}
+    explicit HakleArenaAllocator( std::size_t InChunkSize ) : State( HAKLE_NEW( HakleArena, InChunkSize ) ) {}
+
+    // copies share the arena, a moved-from allocator keeps sharing it too
+    HakleArenaAllocator( const HakleArenaAllocator& Other ) noexcept : State( Other.State ) { State->AddRef(); }
+
+    template <class Up>
+    explicit HakleArenaAllocator( const HakleArenaAllocator<Up>& Other ) noexcept : State( Other.GetArena() ) {
+        State->AddRef();
+    }
+
+    HakleArenaAllocator& operator=( const HakleArenaAllocator& Other ) noexcept {
+        Other.State->AddRef();
+        Drop();
+        State = Other.State;
+        return *this;
+    }
+
+    template <class Up>
+    HakleArenaAllocator& operator=( const HakleArenaAllocator<Up>& Other ) noexcept {
+        Other.GetArena()->AddRef();
+        Drop();
+        State = Other.GetArena();
+        return *this;
+    }
+
+    ~HakleArenaAllocator() { Drop(); }
+
+    void swap( HakleArenaAllocator& Other ) noexcept { std::swap( State, Other.State ); }
+
+    Pointer Allocate() { return Allocate( 1 ); }
+    Pointer Allocate( SizeType n ) {
+        if ( State->Serves( n * sizeof( Tp ), alignof( Tp ) ) ) {
+            return static_cast<Pointer>( State->Allocate( n * sizeof( Tp ), alignof( Tp ) ) );
+        }
+        return HAKLE_OPERATOR_NEW_ARRAY( Tp, n );
+    }
+
+    void Deallocate( Pointer ptr ) noexcept { Deallocate( ptr, 1 ); }
+    void Deallocate( Pointer ptr, SizeType n ) noexcept {
+        if ( !State->Serves( n * sizeof( Tp ), alignof( Tp ) ) ) {
+            HAKLE_OPERATOR_DELETE( ptr );
+        }
+    }
+
+    template <class... Args>
+    static constexpr void Construct( Pointer ptr, Args&&... args ) {
+        HAKLE_CONSTRUCT( ptr, std::forward<Args>( args )... );
+    }
+
+    static constexpr void Destroy( Pointer ptr ) noexcept { HAKLE_DESTROY( ptr ); }
+    static constexpr void Destroy( Pointer ptr, SizeType n ) noexcept { HAKLE_DESTROY_ARRAY( ptr, n ); }
+    static constexpr void Destroy( Pointer first, Pointer last ) noexcept { Destroy( first, last - first ); }
+
+    HAKLE_NODISCARD HakleArena* GetArena() const noexcept { return State; }
+
+private:
+    void Drop() noexcept {
+        if ( State->Release() ) {
+            HAKLE_DELETE( State );
+        }
+    }
+
+    HakleArena* State;
+};
+
+template <class Tp>
+bool operator==( const HakleArenaAllocator<Tp>& X, const HakleArenaAllocator<Tp>& Y ) noexcept {
+    return X.GetArena() == Y.GetArena();
+}
+
+template <class Tp>
+bool operator!=( const HakleArenaAllocator<Tp>& X, const HakleArenaAllocator<Tp>& Y ) noexcept {
+    return !( X == Y );
+}
+
+template <class Tp>
+void swap( HakleArenaAllocator<Tp>& X, HakleArenaAllocator<Tp>& Y ) noexcept {
+    X.swap( Y );
+}
+
+// Process-wide size-class heap behind HakleSlabAllocator. Requests up to MaxSize are rounded to one of ClassCount
+// classes (powers of two and the halfway steps between them) and carved from SpanSize spans that live as long as the
+// process. Each thread caches up to two batches per class, so the common path touches no shared state. An empty cache
+// takes every batch on the class's shared stack with one exchange and puts back all but the first. A full cache pushes
+// one batch with one CAS. Since batches only leave the stack through an exchange, the stack has no ABA problem. Any
+// thread may free any block, which lands in the freeing thread's cache.
+class HakleSlabHeap {
+public:
+    constexpr static std::size_t MinSize    = 16;
+    constexpr static std::size_t MaxSize    = 8192;
+    constexpr static std::size_t ClassCount = 18;
+    constexpr static std::size_t SpanSize   = static_cast<std::size_t>( 64 ) << 10;
+    // spans are aligned to this, power-of-two classes inherit it
+    constexpr static std::size_t MaxAlignment = 64;
+
+    // class serving Bytes aligned to Alignment, ClassCount when the request is left to operator new
+    HAKLE_NODISCARD static constexpr std::size_t ClassOf( std::size_t Bytes, std::size_t Alignment ) noexcept {
+        if ( Bytes > MaxSize || Alignment > MaxAlignment ) {
+            return ClassCount;
+        }
+        std::size_t Class = SizeClass( Bytes );
+        while ( Class < ClassCount && ClassSize( Class ) % Alignment != 0 ) {
+            ++Class;
+        }
+        return Class;
+    }
+
+    HAKLE_NODISCARD static constexpr std::size_t ClassSize( std::size_t Class ) noexcept {
+        if ( Class < 2 ) {
+            return MinSize << Class;
+        }
+        const std::size_t Shift = ( Class - 2 ) / 2 + 5;
+        return Class % 2 == 0 ? static_cast<std::size_t>( 3 ) << ( Shift - 1 ) : static_cast<std::size_t>( 1 ) << ( Shift + 1 );
+    }
+
+    // blocks moved between a thread cache and the shared stack at a time, a cache holds up to twice as many
+    HAKLE_NODISCARD static constexpr std::size_t BatchSize( std::size_t Class ) noexcept {
+        const std::size_t Count = ( static_cast<std::size_t>( 16 ) << 10 ) / ClassSize( Class );
+        return Count < 2 ? 2 : ( Count > 64 ? 64 : Count );
+    }
+
+    static void* Allocate( std::size_t Class ) {
+        ThreadCache& Cache = Local();
+        FreeBlock*   Block = Cache.Heads[ Class ];
+        if HAKLE_UNLIKELY ( Block == nullptr ) {
+            Block = Refill( Cache, Class );
+        }
+        Cache.Heads[ Class ] = Block->Next;
+        --Cache.Counts[ Class ];
+        if HAKLE_UNLIKELY ( Cache.Retired ) {
+            Spill( Cache, Class, 0 );
+        }
+        return Block;
+    }
+
+    static void Deallocate( void* Ptr, std::size_t Class ) noexcept {
+        ThreadCache& Cache = Local();
+        if HAKLE_UNLIKELY ( !Cache.Registered ) {
+            Register( Cache );
+        }
+        FreeBlock* Block     = static_cast<FreeBlock*>( Ptr );
+        Block->Next          = Cache.Heads[ Class ];
+        Cache.Heads[ Class ] = Block;
+        if HAKLE_UNLIKELY ( ++Cache.Counts[ Class ] >= 2 * BatchSize( Class ) || Cache.Retired ) {
+            Spill( Cache, Class, Cache.Retired ? 0 : BatchSize( Class ) );
+        }
+    }
+
+    // bytes held in spans across all classes and threads
+    HAKLE_NODISCARD static std::size_t GetBytes() noexcept { return Global().SpanCount.load( std::memory_order_relaxed ) * SpanSize; }
+
+    // blocks of Class sitting in the calling thread's cache
+    HAKLE_NODISCARD static std::size_t GetThreadCached( std::size_t Class ) noexcept { return Local().Counts[ Class ]; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* Next;
+        // links batches on the shared stack, only meaningful in a batch's first block
+        FreeBlock* NextBatch;
+    };
+
+    struct Span {
+        Span* Next;
+    };
+
+    constexpr static std::size_t SpanHeader = MaxAlignment;
+
+    struct SharedState {
+        std::atomic<FreeBlock*>  Batches[ ClassCount ];
+        std::atomic<Span*>       Spans;
+        std::atomic<std::size_t> SpanCount;
+    };
+
+    // trivially destructible so it is never torn down, blocks may come back from thread and static destructors late
+    struct ThreadCache {
+        FreeBlock*  Heads[ ClassCount ];
+        std::size_t Counts[ ClassCount ];
+        bool        Registered;
+        bool        Retired;
+    };
+
+    // hands the cache back when its thread exits, later frees on that thread go straight to the shared stacks
+    struct CacheReaper {
+        ~CacheReaper() {
+            ThreadCache& Cache = Local();
+            Cache.Retired      = true;
+            for ( std::size_t Class = 0; Class < ClassCount; ++Class ) {
+                Spill( Cache, Class, 0 );
+            }
+        }
+    };
+
+    static SharedState& Global() noexcept {
+        static SharedState State{};
+        return State;
+    }
+
+    static ThreadCache& Local() noexcept {
+        thread_local ThreadCache Cache{};
+        return Cache;
+    }
+
+    static void Register( ThreadCache& Cache ) noexcept {
+        Cache.Registered = true;
+        thread_local CacheReaper Reaper;
+        ( void )Reaper;
+    }
+
+    static constexpr std::size_t SizeClass( std::size_t Bytes ) noexcept {
+        if ( Bytes <= 2 * MinSize ) {
+            return Bytes <= MinSize ? 0 : 1;
+        }
+        std::size_t Shift = 5;
+        while ( ( static_cast<std::size_t>( 1 ) << ( Shift + 1 ) ) < Bytes ) {
+            ++Shift;
+        }
+        const std::size_t Half = static_cast<std::size_t>( 3 ) << ( Shift - 1 );
+        return 2 * ( Shift - 5 ) + 2 + ( Bytes > Half ? 1 : 0 );
+    }
+
+    // pushes a chain of batches linked through NextBatch
+    static void PushBatches( std::size_t Class, FreeBlock* First ) noexcept {
+        FreeBlock* Last = First;
+        while ( Last->NextBatch != nullptr ) {
+            Last = Last->NextBatch;
+        }
+        std::atomic<FreeBlock*>& Stack = Global().Batches[ Class ];
+        Last->NextBatch                = Stack.load( std::memory_order_relaxed );
+        while ( !Stack.compare_exchange_weak( Last->NextBatch, First, std::memory_order_release, std::memory_order_relaxed ) ) {
+        }
+    }
+
+    // pushes everything in the cache past its first Keep blocks as one batch
+    static void Spill( ThreadCache& Cache, std::size_t Class, std::size_t Keep ) noexcept {
+        if ( Cache.Counts[ Class ] <= Keep ) {
+            return;
+        }
+        FreeBlock* Rest = Cache.Heads[ Class ];
+        if ( Keep == 0 ) {
+            Cache.Heads[ Class ] = nullptr;
+        }
+        else {
+            FreeBlock* Tail = Rest;
+            for ( std::size_t i = 1; i < Keep; ++i ) {
+                Tail = Tail->Next;
+            }
+            Rest       = Tail->Next;
+            Tail->Next = nullptr;
+        }
+        Cache.Counts[ Class ] = Keep;
+        Rest->NextBatch       = nullptr;
+        PushBatches( Class, Rest );
+    }
+
+    static FreeBlock* Refill( ThreadCache& Cache, std::size_t Class ) {
+        if HAKLE_UNLIKELY ( !Cache.Registered ) {
+            Register( Cache );
+        }
+        FreeBlock* Taken = Global().Batches[ Class ].exchange( nullptr, std::memory_order_acquire );
+        if ( Taken == nullptr ) {
+            Taken = Carve( Class );
+        }
+        if ( Taken->NextBatch != nullptr ) {
+            PushBatches( Class, Taken->NextBatch );
+        }
+        std::size_t Count = 0;
+        for ( FreeBlock* Block = Taken; Block != nullptr; Block = Block->Next ) {
+            ++Count;
+        }
+        Cache.Heads[ Class ]  = Taken;
+        Cache.Counts[ Class ] = Count;
+        return Taken;
+    }
+
+    // cuts a new span into batches linked through NextBatch
+    static FreeBlock* Carve( std::size_t Class ) {
+        SharedState& State   = Global();
+        char*        Raw     = static_cast<char*>( ::operator new( SpanSize, static_cast<std::align_val_t>( MaxAlignment ) ) );
+        Span*        NewSpan = ::new ( Raw ) Span{ State.Spans.load( std::memory_order_relaxed ) };
+        while ( !State.Spans.compare_exchange_weak( NewSpan->Next, NewSpan, std::memory_order_release, std::memory_order_relaxed ) ) {
+        }
+        State.SpanCount.fetch_add( 1, std::memory_order_relaxed );
+
+        const std::size_t Size  = ClassSize( Class );
+        const std::size_t Count = ( SpanSize - SpanHeader ) / Size;
+        const std::size_t Batch = BatchSize( Class );
+        char* const       Begin = Raw + SpanHeader;
+        FreeBlock*        First = nullptr;
+        FreeBlock*        Prev  = nullptr;
+        for ( std::size_t i = 0; i < Count; ++i ) {
+            FreeBlock* Block = reinterpret_cast<FreeBlock*>( Begin + i * Size );
+            Block->Next      = i + 1 < Count && ( i + 1 ) % Batch != 0 ? reinterpret_cast<FreeBlock*>( Begin + ( i + 1 ) * Size ) : nullptr;
+            if ( i % Batch == 0 ) {
+                Block->NextBatch = nullptr;
+                if ( Prev == nullptr ) {
+                    First = Block;
+                }
+                else {
+                    Prev->NextBatch = Block;
+                }
+                Prev = Block;
+            }
+        }
+        return First;
+    }
+};
+
+// Stateless allocator over HakleSlabHeap. Queue control structures (producers, index arrays, list and hash nodes) come
+// in a handful of recurring sizes and are served from thread caches without going through malloc. Arrays larger than
+// HakleSlabHeap::MaxSize, such as block pools and slabs, and types aligned beyond HakleSlabHeap::MaxAlignment go to
+// operator new.
+template <class Tp>
+class HakleSlabAllocator {
+public:
+    using ValueType      = Tp;
+    using Pointer        = Tp*;
+    using ConstPointer   = const Tp*;
+    using Reference      = Tp&;
+    using ConstReference = const Tp&;
+    using SizeType       = size_t;
+    using DifferenceType = std::ptrdiff_t;
+
+    constexpr HakleSlabAllocator() noexcept = default;
+
+    template <class Up>
+    explicit constexpr HakleSlabAllocator( const HakleSlabAllocator<Up>& ) noexcept {}
+
+    template <class Up>
+    explicit constexpr HakleSlabAllocator( const HakleSlabAllocator<Up>&& ) noexcept {}
+
+    template <class Up>
+    constexpr HakleSlabAllocator& operator=( const HakleSlabAllocator<Up>& ) noexcept {
+        return *this;
+    }
+
+    template <class Up>
+    constexpr HakleSlabAllocator& operator=( const HakleSlabAllocator<Up>&& ) noexcept {
+        return *this;
+    }
+
+    HAKLE_CPP14_CONSTEXPR void swap( HakleSlabAllocator& ) noexcept {}
+
+    static Pointer Allocate() { return Allocate( 1 ); }
+    static Pointer Allocate( SizeType n ) {
+        const std::size_t Class = ClassOf( n );
+        if ( Class < HakleSlabHeap::ClassCount ) {
+            return static_cast<Pointer>( HakleSlabHeap::Allocate( Class ) );
+        }
+        return HAKLE_OPERATOR_NEW_ARRAY( Tp, n );
+    }
+
+    static void Deallocate( Pointer ptr ) noexcept { Deallocate( ptr, 1 ); }
+    static void Deallocate( Pointer ptr, SizeType n ) noexcept {
+        const std::size_t Class = ClassOf( n );
+        if ( Class < HakleSlabHeap::ClassCount ) {
+            // like operator delete, an empty pool hands back nullptr
+            if ( ptr != nullptr ) {
+                HakleSlabHeap::Deallocate( ptr, Class );
+            }
+        }
+        else {
+            HAKLE_OPERATOR_DELETE( ptr );
+        }
+    }
+
+    template <class... Args>
+    static constexpr void Construct( Pointer ptr, Args&&... args ) {
+        HAKLE_CONSTRUCT( ptr, std::forward<Args>( args )... );
+    }
+
+    static constexpr void Destroy( Pointer ptr ) noexcept { HAKLE_DESTROY( ptr ); }
+    static constexpr void Destroy( Pointer ptr, SizeType n ) noexcept { HAKLE_DESTROY_ARRAY( ptr, n ); }
+    static constexpr void Destroy( Pointer first, Pointer last ) noexcept { Destroy( first, last - first ); }
+
+    // size class serving n objects, HakleSlabHeap::ClassCount when they bypass the heap
+    HAKLE_NODISCARD static constexpr std::size_t ClassOf( SizeType n ) noexcept {
+        return n <= HakleSlabHeap::MaxSize / sizeof( Tp ) ? HakleSlabHeap::ClassOf( n * sizeof( Tp ), alignof( Tp ) ) : HakleSlabHeap::ClassCount;
+    }
+};
+
+template <class Tp>
+HAKLE_CPP14_CONSTEXPR bool operator==( const HakleSlabAllocator<Tp>&, const HakleSlabAllocator<Tp>& ) noexcept {
+    return true;
+}
+
+template <class Tp>
+HAKLE_CPP14_CONSTEXPR bool operator!=( const HakleSlabAllocator<Tp>& X, const HakleSlabAllocator<Tp>& Y ) noexcept {
+    return !( X == Y );
+}
+
+template <class Tp>
+HAKLE_CPP14_CONSTEXPR void swap( HakleSlabAllocator<Tp>& X, HakleSlabAllocator<Tp>& Y ) noexcept {
+    X.swap( Y );
+}
+
+#if defined( HAKLE_HAS_PMR )
+// Adapts a std::pmr::memory_resource to the IsAllocator interface, so a queue, hash table or block manager can draw
+// from a monotonic or pool resource. Copies and rebinds share the resource, which must outlive every allocator and
+// container using it. Sizes and alignments passed to the resource follow the rebound Tp, so deallocate always sees what
+// allocate was given. The default constructor uses std::pmr::get_default_resource().
+template <class Tp>
+class HaklePmrAllocator {
+public:
+    using ValueType      = Tp;
+    using Pointer        = Tp*;
+    using ConstPointer   = const Tp*;
+    using Reference      = Tp&;
+    using ConstReference = const Tp&;
+    using SizeType       = size_t;
+    using DifferenceType = std::ptrdiff_t;
+
+    HaklePmrAllocator() noexcept : Resource( std::pmr::get_default_resource() ) {}
+    HaklePmrAllocator( std::pmr::memory_resource* InResource ) noexcept : Resource( InResource ) {}
+
+    HaklePmrAllocator( const HaklePmrAllocator& ) noexcept            = default;
+    HaklePmrAllocator& operator=( const HaklePmrAllocator& ) noexcept = default;
+
+    template <class Up>
+    explicit HaklePmrAllocator( const HaklePmrAllocator<Up>& Other ) noexcept : Resource( Other.GetResource() ) {}
+
+    template <class Up>
+    HaklePmrAllocator& operator=( const HaklePmrAllocator<Up>& Other ) noexcept {
+        Resource = Other.GetResource();
+        return *this;
+    }
+
+    void swap( HaklePmrAllocator& Other ) noexcept { std::swap( Resource, Other.Resource ); }
+
+    Pointer Allocate() { return Allocate( 1 ); }
+    Pointer Allocate( SizeType n ) {
+        if ( n > static_cast<SizeType>( -1 ) / sizeof( Tp ) ) {
+            HAKLE_THROW( std::bad_array_new_length() );
+        }
+        return static_cast<Pointer>( Resource->allocate( n * sizeof( Tp ), alignof( Tp ) ) );
+    }
+
+    void Deallocate( Pointer ptr ) noexcept { Deallocate( ptr, 1 ); }
+    void Deallocate( Pointer ptr, SizeType n ) noexcept {
+        if ( ptr != nullptr ) {
+            Resource->deallocate( ptr, n * sizeof( Tp ), alignof( Tp ) );
+        }
+    }
+
+    template <class... Args>
+    static constexpr void Construct( Pointer ptr, Args&&... args ) {
+        HAKLE_CONSTRUCT( ptr, std::forward<Args>( args )... );
+    }
+
+    static constexpr void Destroy( Pointer ptr ) noexcept { HAKLE_DESTROY( ptr ); }
+    static constexpr void Destroy( Pointer ptr, SizeType n ) noexcept { HAKLE_DESTROY_ARRAY( ptr, n ); }
+    static constexpr void Destroy( Pointer first, Pointer last ) noexcept { Destroy( first, last - first ); }
+
+    HAKLE_NODISCARD std::pmr::memory_resource* GetResource() const noexcept { return Resource; }
+
+private:
+    std::pmr::memory_resource* Resource;
+};
+
+// equal when either resource can free what the other allocated
+template <class Tp>
+bool operator==( const HaklePmrAllocator<Tp>& X, const HaklePmrAllocator<Tp>& Y ) noexcept {
+    return *X.GetResource() == *Y.GetResource();
+}
+
+template <class Tp>
+bool operator!=( const HaklePmrAllocator<Tp>& X, const HaklePmrAllocator<Tp>& Y ) noexcept {
+    return !( X == Y );
+}
+
+template <class Tp>
+void swap( HaklePmrAllocator<Tp>& X, HaklePmrAllocator<Tp>& Y ) noexcept {
+    X.swap( Y );
+}
+#endif
+
+// Bytes held by a queue, its producers or a block manager, read from counters kept up to date as memory comes and goes
+struct MemoryStats {
+    // blocks allocated up front by the block pool
+    std::size_t PoolBlockBytes{ 0 };
+    // blocks allocated on demand once the pool ran dry
+    std::size_t OverflowBlockBytes{ 0 };
+    // pool and overflow blocks waiting in the block manager
+    std::size_t FreeBlockBytes{ 0 };
+    // pool and overflow blocks held by producers
+    std::size_t ProducerBlockBytes{ 0 };
+    // block index arrays of the producers
+    std::size_t IndexBytes{ 0 };
+    // the producers themselves
+    std::size_t ProducerBytes{ 0 };
+    // implicit producer hash nodes
+    std::size_t HashBytes{ 0 };
+
+    // free and producer blocks are part of the pool and overflow blocks
+    HAKLE_NODISCARD constexpr std::size_t GetTotalBytes() const noexcept { return PoolBlockBytes + OverflowBlockBytes + IndexBytes + ProducerBytes + HashBytes; }
+
+    HAKLE_CPP14_CONSTEXPR MemoryStats& operator+=( const MemoryStats& Other ) noexcept {
+        PoolBlockBytes += Other.PoolBlockBytes;
+        OverflowBlockBytes += Other.OverflowBlockBytes;
+        FreeBlockBytes += Other.FreeBlockBytes;
+        ProducerBlockBytes += Other.ProducerBlockBytes;
+        IndexBytes += Other.IndexBytes;
+        ProducerBytes += Other.ProducerBytes;
+        HashBytes += Other.HashBytes;
+        return *this;
+    }
+};
+
 }  // namespace hakle
 
 #endif  // ALLOCATOR_H
@@ -81,4 +81,16 @@
 #define HAKLE_UNLIKELY( x ) ( __builtin_expect( !!( x ), 0 ) )
 #endif
 
+// spin-wait hint for retry loops
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+#include <intrin.h>
+#define HAKLE_CPU_PAUSE() _mm_pause()
+#elif defined( __x86_64__ ) || defined( __i386__ )
+#define HAKLE_CPU_PAUSE() __builtin_ia32_pause()
+#elif defined( __aarch64__ ) || defined( __arm__ )
+#define HAKLE_CPU_PAUSE() __asm__ __volatile__( "yield" )
+#else
+#define HAKLE_CPU_PAUSE() ( (void)0 )
+#endif
+
 #endif  // COMMON_H
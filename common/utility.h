@@ -164,7 +164,7 @@ inline constexpr bool CircularLessThan( T a, T b ) noexcept {
     return static_cast<T>( a - b ) > static_cast<T>( static_cast<T>( 1 ) << ( static_cast<T>( sizeof( T ) * CHAR_BIT - 1 ) ) );
 }
 
-inline std::size_t CeilToPow2( std::size_t X ) noexcept {
+inline HAKLE_CPP14_CONSTEXPR std::size_t CeilToPow2( std::size_t X ) noexcept {
     --X;
     X |= X >> 1;
     X |= X >> 2;
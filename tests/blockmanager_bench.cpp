@@ -0,0 +1,153 @@
+#include "ConcurrentQueue/Block.h"
+#include "ConcurrentQueue/BlockManager.h"
+#include "ConcurrentQueue/ConcurrentQueue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// 基本配置
+constexpr std::size_t kBlockSize = 32;
+constexpr std::size_t kPoolSize  = 1024;
+constexpr std::size_t kBatch     = 8;
+
+using BlockType = hakle::HakleFlagsBlock<int, kBlockSize>;
+
+// 所有线程共用一个 manager，每轮申请 kBatch 个 block 再全部归还
+template <class Manager>
+static void BM_RequisitionReturn( benchmark::State& state ) {
+    static Manager manager( kPoolSize );
+
+    BlockType* held[ kBatch ];
+    for ( auto _ : state ) {
+        for ( BlockType*& block : held ) {
+            block = manager.RequisitionBlock( hakle::AllocMode::CanAlloc );
+        }
+        benchmark::DoNotOptimize( held );
+        for ( BlockType* block : held ) {
+            manager.ReturnBlock( block );
+        }
+    }
+    state.SetItemsProcessed( state.iterations() * kBatch );
+}
+
+// 单个 FreeList 头，所有线程在同一条 cache line 上竞争
+BENCHMARK_TEMPLATE( BM_RequisitionReturn, hakle::HakleBlockManager<BlockType> )->ThreadRange( 1, 32 )->UseRealTime();
+// 每个线程一个弹匣，只在弹匣空/满时访问共享 FreeList
+BENCHMARK_TEMPLATE( BM_RequisitionReturn, hakle::MagazineBlockManager<BlockType> )->ThreadRange( 1, 32 )->UseRealTime();
+
+#if HAKLE_HAS_TAGGED_FREELIST
+// 同样的 manager，FreeList 换成单字 tagged 头
+BENCHMARK_TEMPLATE( BM_RequisitionReturn, hakle::HakleBlockManager<BlockType, hakle::HakleAllocator<BlockType>, hakle::FreeList_Tagged<BlockType>> )
+    ->ThreadRange( 1, 32 )
+    ->UseRealTime();
+#endif
+// 放回和申请先在消除槽里配对，配不上才访问 FreeList 头
+BENCHMARK_TEMPLATE( BM_RequisitionReturn, hakle::HakleBlockManager<BlockType, hakle::HakleAllocator<BlockType>, hakle::EliminationFreeList<BlockType>> )
+    ->ThreadRange( 1, 32 )
+    ->UseRealTime();
+
+// 直接比较几种 FreeList：所有线程共用一条链，每轮取 kBatch 个节点再全部放回
+struct BenchNode : hakle::FreeListNode<BenchNode> {};
+
+template <class List>
+struct FreeListFixture {
+    FreeListFixture() : Nodes( kPoolSize ) {
+        for ( BenchNode& node : Nodes ) {
+            node.HasOwner = true;
+            list.Add( &node );
+        }
+    }
+
+    std::vector<BenchNode> Nodes;
+    List                   list;
+};
+
+template <class List>
+static void BM_FreeListChurn( benchmark::State& state ) {
+    static FreeListFixture<List> fixture;
+
+    BenchNode* held[ kBatch ];
+    for ( auto _ : state ) {
+        for ( BenchNode*& node : held ) {
+            node = fixture.list.TryGet();
+        }
+        benchmark::DoNotOptimize( held );
+        for ( BenchNode* node : held ) {
+            fixture.list.Add( node );
+        }
+    }
+    state.SetItemsProcessed( state.iterations() * kBatch );
+}
+
+// 引用计数，单字 CAS
+BENCHMARK_TEMPLATE( BM_FreeListChurn, hakle::FreeList<BenchNode> )->ThreadRange( 1, 32 )->UseRealTime();
+#if HAKLE_HAS_TAGGED_FREELIST
+// 48 位指针 + 16 位 tag，单字 CAS
+BENCHMARK_TEMPLATE( BM_FreeListChurn, hakle::FreeList_Tagged<BenchNode> )->ThreadRange( 1, 32 )->UseRealTime();
+#endif
+// 引用计数 FreeList 前面加消除槽
+BENCHMARK_TEMPLATE( BM_FreeListChurn, hakle::EliminationFreeList<BenchNode> )->ThreadRange( 1, 32 )->UseRealTime();
+#if defined( HAKLE_BENCH_DAS ) && defined( NDEBUG )
+// 指针 + tag 的 16 字节 CAS，内联或经 libatomic（见 CMakeLists.txt 的探测）
+// 经 libatomic 时不是 lock-free，构造时的断言只在 NDEBUG 下关闭，所以 Debug 构建不跑这一项
+BENCHMARK_TEMPLATE( BM_FreeListChurn, hakle::FreeList_DAS<BenchNode> )->ThreadRange( 1, 32 )->UseRealTime();
+#endif
+
+// 跨线程归还：上一轮别的线程申请的 block 由本线程归还
+template <class Manager>
+static void BM_CrossThreadReturn( benchmark::State& state ) {
+    static Manager                 manager( kPoolSize );
+    static std::atomic<BlockType*> mailbox[ 64 ]{};
+
+    const std::size_t slot = static_cast<std::size_t>( state.thread_index() );
+    const std::size_t next = ( slot + 1 ) % static_cast<std::size_t>( state.threads() );
+    for ( auto _ : state ) {
+        BlockType* block = manager.RequisitionBlock( hakle::AllocMode::CanAlloc );
+        block            = mailbox[ next ].exchange( block, std::memory_order_acq_rel );
+        if ( block != nullptr ) {
+            manager.ReturnBlock( block );
+        }
+    }
+    if ( BlockType* block = mailbox[ slot ].exchange( nullptr, std::memory_order_acq_rel ) ) {
+        manager.ReturnBlock( block );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK_TEMPLATE( BM_CrossThreadReturn, hakle::HakleBlockManager<BlockType> )->ThreadRange( 2, 32 )->UseRealTime();
+BENCHMARK_TEMPLATE( BM_CrossThreadReturn, hakle::MagazineBlockManager<BlockType> )->ThreadRange( 2, 32 )->UseRealTime();
+
+// 小 block 时每两个元素就换一次 block，比较直接调用和经虚函数调用 manager 的开销
+// SlowQueue 的 block 一空就归还，每个 block 都要经过一次申请和归还
+constexpr std::size_t kSmallBlockSize = 2;
+
+using SmallBlockType          = hakle::HakleCounterBlock<int, kSmallBlockSize>;
+using SmallManager            = hakle::HakleBlockManager<SmallBlockType>;
+using SmallPolymorphicManager = hakle::PolymorphicBlockManager<SmallBlockType>;
+using SmallPolymorphicAdapter = hakle::PolymorphicBlockManagerAdapter<SmallManager>;
+
+template <class Manager, class Storage>
+static void BM_SmallBlockTurnover( benchmark::State& state ) {
+    Storage                                                                                     storage( kPoolSize );
+    hakle::SlowQueue<int, kSmallBlockSize, hakle::HakleAllocator<int>, SmallBlockType, Manager> queue( 4, &storage );
+
+    int value = 0;
+    for ( auto _ : state ) {
+        for ( int i = 0; i < static_cast<int>( kBatch * kSmallBlockSize ); ++i ) {
+            queue.template Enqueue<hakle::AllocMode::CanAlloc>( i );
+        }
+        for ( std::size_t i = 0; i < kBatch * kSmallBlockSize; ++i ) {
+            queue.Dequeue( value );
+        }
+        benchmark::DoNotOptimize( value );
+    }
+    state.SetItemsProcessed( state.iterations() * kBatch * kSmallBlockSize );
+}
+
+// 队列模板参数是具体的 manager，调用可以内联
+BENCHMARK_TEMPLATE( BM_SmallBlockTurnover, SmallManager, SmallManager );
+// 经 PolymorphicBlockManager 接口调用
+BENCHMARK_TEMPLATE( BM_SmallBlockTurnover, SmallPolymorphicManager, SmallPolymorphicAdapter );
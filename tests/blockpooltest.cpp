@@ -9,6 +9,9 @@
 #include <chrono>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -27,6 +30,14 @@ struct CustomBlock : public HakleFlagsBlock<double, 32> {
     CustomBlock() { initialized.store( true, std::memory_order_relaxed ); }
 };
 
+// 统计构造和析构次数的块类型
+struct CountingBlock : public HakleFlagsBlock<int, 64> {
+    static inline std::atomic<int> alive{ 0 };
+
+    CountingBlock() { alive.fetch_add( 1, std::memory_order_relaxed ); }
+    ~CountingBlock() { alive.fetch_sub( 1, std::memory_order_relaxed ); }
+};
+
 class BlockPoolTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -62,6 +73,31 @@ TEST_F( BlockPoolTest, BasicBlockAllocation ) {
     EXPECT_EQ( should_be_null, nullptr );
 }
 
+// 池只在块第一次被取出时构造它
+TEST_F( BlockPoolTest, LazyConstruction ) {
+    constexpr size_t POOL_SIZE = 100;
+
+    {
+        BlockPool<CountingBlock> pool( POOL_SIZE );
+        EXPECT_EQ( CountingBlock::alive.load(), 0 );
+
+        for ( int i = 0; i < 3; ++i ) {
+            CountingBlock* block = pool.GetBlock();
+            ASSERT_NE( block, nullptr );
+            EXPECT_TRUE( block->HasOwner );
+        }
+        EXPECT_EQ( CountingBlock::alive.load(), 3 );
+
+        size_t         count = 0;
+        CountingBlock* range = pool.GetBlocks( 10, count );
+        ASSERT_NE( range, nullptr );
+        EXPECT_EQ( count, 10 );
+        EXPECT_EQ( CountingBlock::alive.load(), 13 );
+    }
+    // 只析构构造过的块
+    EXPECT_EQ( CountingBlock::alive.load(), 0 );
+}
+
 // 测试自定义块类型
 TEST_F( BlockPoolTest, CustomBlockType ) {
     constexpr size_t POOL_SIZE  = 5;
@@ -306,6 +342,1043 @@ TEST_F( BlockPoolTest, Destruction ) {
     EXPECT_TRUE( true );  // 如果能到达这里且没有内存泄漏，测试通过
 }
 
+// 测试批量获取：一次 fetch_add 取一段连续的块
+TEST_F( BlockPoolTest, BatchAllocation ) {
+    constexpr size_t POOL_SIZE  = 10;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    BlockPool<HakleFlagsBlock<int, BLOCK_SIZE>> pool( POOL_SIZE );
+
+    size_t count  = 0;
+    auto*  first  = pool.GetBlocks( 4, count );
+    auto*  second = pool.GetBlocks( 4, count );
+    ASSERT_NE( first, nullptr );
+    ASSERT_EQ( count, 4 );
+    EXPECT_EQ( second, first + 4 );
+
+    // 只剩两块
+    auto* third = pool.GetBlocks( 4, count );
+    EXPECT_EQ( third, first + 8 );
+    EXPECT_EQ( count, 2 );
+
+    EXPECT_EQ( pool.GetBlocks( 1, count ), nullptr );
+    EXPECT_EQ( count, 0 );
+    EXPECT_EQ( pool.GetBlock(), nullptr );
+}
+
+// 测试 block manager 的批量获取：池、空闲链表、新分配依次使用
+TEST_F( BlockPoolTest, ManagerRequisitionBlocks ) {
+    constexpr size_t POOL_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( POOL_SIZE );
+
+    auto CountChain = []( BlockType* block ) {
+        size_t n = 0;
+        for ( ; block != nullptr; block = block->Next ) {
+            ++n;
+        }
+        return n;
+    };
+
+    BlockType* chain = manager.RequisitionBlocks( 3, AllocMode::CannotAlloc );
+    EXPECT_EQ( CountChain( chain ), 3 );
+    manager.ReturnBlocks( chain );
+
+    // 池里剩 1 块，空闲链表里 3 块，不允许分配时只能拿到 4 块
+    BlockType* partial = manager.RequisitionBlocks( 6, AllocMode::CannotAlloc );
+    EXPECT_EQ( CountChain( partial ), 4 );
+    manager.ReturnBlocks( partial );
+
+    BlockType* full = manager.RequisitionBlocks( 6, AllocMode::CanAlloc );
+    EXPECT_EQ( CountChain( full ), 6 );
+    manager.ReturnBlocks( full );
+
+    // 通用入口对任何 block manager 都可用
+    BlockType* generic = RequisitionBlocks( manager, 2, AllocMode::CannotAlloc );
+    EXPECT_EQ( CountChain( generic ), 2 );
+    manager.ReturnBlocks( generic );
+}
+
+TEST_F( BlockPoolTest, ManagerAdoptBlocks ) {
+    constexpr size_t POOL_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+    constexpr size_t SLAB_SIZE  = 2;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( POOL_SIZE, {}, SLAB_SIZE );
+
+    BlockType* fromOther = nullptr;
+    BlockType* fromSlab  = nullptr;
+    {
+        HakleBlockManager<BlockType> other( POOL_SIZE, {}, SLAB_SIZE );
+        fromOther = other.RequisitionBlock( AllocMode::CannotAlloc );
+        other.ReturnBlock( other.RequisitionBlock( AllocMode::CanAlloc ) );
+        ASSERT_NE( fromOther, nullptr );
+
+        // 池用完后长出两个 slab：先长出的全部空闲，最新的那个留一块借出
+        BlockType* rest = other.RequisitionBlocks( 3 + 2 * SLAB_SIZE, AllocMode::CanAlloc );
+        ASSERT_NE( rest, nullptr );
+        BlockType* last = rest;
+        while ( last->Next->Next != nullptr ) {
+            last = last->Next;
+        }
+        fromSlab   = last->Next;
+        last->Next = nullptr;
+        other.ReturnBlocks( rest );
+        EXPECT_EQ( other.GetSlabBytes(), 2 * SLAB_SIZE * sizeof( BlockType ) );
+
+        manager.AdoptBlocks( other );
+
+        // 只交出有 block 借出的存储：池换成同样大小的新池，全部空闲的 slab 留下
+        EXPECT_EQ( other.GetBlockPoolSize(), POOL_SIZE );
+        EXPECT_EQ( other.GetSlabBytes(), SLAB_SIZE * sizeof( BlockType ) );
+        EXPECT_EQ( manager.GetSlabBytes(), ( POOL_SIZE + SLAB_SIZE ) * sizeof( BlockType ) );
+        EXPECT_EQ( other.GetMemoryStats().ProducerBlockBytes, 0 );
+        std::vector<BlockType*> kept;
+        while ( BlockType* block = other.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+            kept.push_back( block );
+        }
+        EXPECT_EQ( kept.size(), POOL_SIZE + SLAB_SIZE );
+        for ( BlockType* block : kept ) {
+            other.ReturnBlock( block );
+        }
+    }
+
+    // other 析构后，它发出的 block 依然有效，可以归还给 manager
+    fromOther->SetAllEmpty();
+    manager.ReturnBlock( fromOther );
+    fromSlab->SetAllEmpty();
+    manager.ReturnBlock( fromSlab );
+    EXPECT_EQ( manager.GetMemoryStats().ProducerBlockBytes, 0 );
+
+    // 自己的池 4 块 + other 的旧池 4 块 + 有 block 借出的那个 slab 2 块
+    std::vector<BlockType*> blocks;
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), 2 * POOL_SIZE + SLAB_SIZE );
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+
+    // 接管来的存储全部空闲后可以被 Trim 释放
+    EXPECT_EQ( manager.Trim( 0 ), ( POOL_SIZE + SLAB_SIZE ) * sizeof( BlockType ) );
+    EXPECT_EQ( manager.GetSlabBytes(), 0 );
+}
+
+// 测试池用完后按 slab 增长，以及 Trim 只释放所有 block 都空闲的 slab
+TEST_F( BlockPoolTest, ManagerSlabsTrim ) {
+    constexpr size_t POOL_SIZE  = 2;
+    constexpr size_t SLAB_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( POOL_SIZE, {}, SLAB_SIZE );
+    EXPECT_EQ( manager.GetSlabBytes(), 0 );
+
+    // 池 2 块 + 两个 slab
+    std::vector<BlockType*> blocks;
+    for ( size_t i = 0; i < POOL_SIZE + 2 * SLAB_SIZE; ++i ) {
+        blocks.push_back( manager.RequisitionBlock( AllocMode::CanAlloc ) );
+        ASSERT_NE( blocks.back(), nullptr );
+    }
+    EXPECT_EQ( manager.GetSlabBytes(), 2 * SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( manager.RequisitionBlock( AllocMode::CannotAlloc ), nullptr );
+
+    // 还有一块没归还的 slab 不能释放
+    BlockType* held = blocks.back();
+    blocks.pop_back();
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+    EXPECT_EQ( manager.Trim(), SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( manager.GetSlabBytes(), SLAB_SIZE * sizeof( BlockType ) );
+
+    // 剩下的 block 依然可用：池 2 块 + 留下的 slab 里 3 块
+    blocks.clear();
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), POOL_SIZE + SLAB_SIZE - 1 );
+    blocks.push_back( held );
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+
+    // 目标字节数以内不释放
+    EXPECT_EQ( manager.Trim( SLAB_SIZE * sizeof( BlockType ) ), 0 );
+    EXPECT_EQ( manager.Trim(), SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( manager.GetSlabBytes(), 0 );
+
+    // 池里的 block 不受影响，之后还能继续增长
+    blocks.clear();
+    BlockType* chain = manager.RequisitionBlocks( POOL_SIZE + 1, AllocMode::CanAlloc );
+    size_t     count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+        ++count;
+    }
+    EXPECT_EQ( count, POOL_SIZE + 1 );
+    EXPECT_EQ( manager.GetSlabBytes(), SLAB_SIZE * sizeof( BlockType ) );
+    manager.ReturnBlocks( chain );
+}
+
+// 多线程同时增长 slab，拿到的 block 不能重复
+TEST_F( BlockPoolTest, ManagerSlabsConcurrentGrowth ) {
+    constexpr size_t BLOCK_SIZE  = 64;
+    constexpr int    NUM_THREADS = 4;
+    constexpr int    PER_THREAD  = 500;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( 0, {}, 8 );
+
+    std::vector<std::vector<BlockType*>> taken( NUM_THREADS );
+    std::vector<std::thread>             threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ &manager, &taken, t ]() {
+            for ( int i = 0; i < PER_THREAD; ++i ) {
+                if ( i % 3 == 0 ) {
+                    for ( BlockType* block = manager.RequisitionBlocks( 3, AllocMode::CanAlloc ); block != nullptr; block = block->Next ) {
+                        taken[ t ].push_back( block );
+                    }
+                }
+                else {
+                    taken[ t ].push_back( manager.RequisitionBlock( AllocMode::CanAlloc ) );
+                }
+            }
+        } );
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+
+    std::set<BlockType*> unique;
+    for ( auto& list : taken ) {
+        for ( BlockType* block : list ) {
+            ASSERT_NE( block, nullptr );
+            EXPECT_TRUE( unique.insert( block ).second );
+            manager.ReturnBlock( block );
+        }
+    }
+    EXPECT_GE( manager.GetSlabBytes(), unique.size() * sizeof( BlockType ) );
+    manager.Trim();
+    EXPECT_EQ( manager.GetSlabBytes(), 0 );
+}
+
+// slab 默认按页的量级分配，block 和池一样拿到时才构造
+TEST_F( BlockPoolTest, SlabsLazyConstruction ) {
+    constexpr size_t SLAB_SIZE = 16;
+    EXPECT_GE( BlockSlabs<CountingBlock>::DefaultSlabSize * sizeof( CountingBlock ), size_t{ 4096 } );
+
+    {
+        BlockSlabs<CountingBlock> slabs( SLAB_SIZE );
+        size_t                    count = 0;
+        CountingBlock*            block = slabs.GetBlocks( 1, count, true );
+        ASSERT_NE( block, nullptr );
+        EXPECT_EQ( count, 1 );
+        EXPECT_TRUE( block->HasOwner );
+        EXPECT_EQ( slabs.GetBytes(), SLAB_SIZE * sizeof( CountingBlock ) );
+        EXPECT_EQ( CountingBlock::alive.load(), 1 );
+
+        CountingBlock* range = slabs.GetBlocks( 3, count, true );
+        ASSERT_NE( range, nullptr );
+        EXPECT_EQ( count, 3 );
+        EXPECT_EQ( CountingBlock::alive.load(), 4 );
+    }
+    // 只析构构造过的块
+    EXPECT_EQ( CountingBlock::alive.load(), 0 );
+}
+
+// 生产者、消费者一直在拿还 block 时 Trim 也能运行，被释放的 slab 等没人能碰到时才真正释放
+template <class ManagerType>
+static void TrimWhileInUse() {
+    constexpr int NUM_THREADS = 4;
+    constexpr int ROUNDS      = 2000;
+
+    using BlockType = typename ManagerType::BlockType;
+    ManagerType       manager( 0, {}, 4 );
+    std::atomic<int>  done{ 0 };
+
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ &manager, &done ]() {
+            std::vector<BlockType*> held;
+            for ( int i = 0; i < ROUNDS; ++i ) {
+                if ( i % 2 == 0 ) {
+                    for ( BlockType* block = manager.RequisitionBlocks( 3, AllocMode::CanAlloc ); block != nullptr; block = block->Next ) {
+                        held.push_back( block );
+                    }
+                }
+                else {
+                    held.push_back( manager.RequisitionBlock( AllocMode::CanAlloc ) );
+                }
+                for ( BlockType* block : held ) {
+                    ASSERT_NE( block, nullptr );
+                    *( *block )[ 0 ] = i;
+                }
+                // 一阵一阵地全部归还，让整个 slab 空出来
+                if ( i % 7 == 0 ) {
+                    for ( BlockType* block : held ) {
+                        manager.ReturnBlock( block );
+                    }
+                    held.clear();
+                }
+            }
+            for ( BlockType* block : held ) {
+                manager.ReturnBlock( block );
+            }
+            done.fetch_add( 1 );
+        } );
+    }
+
+    std::size_t released = 0;
+    while ( done.load() < NUM_THREADS ) {
+        released += manager.Trim();
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+    released += manager.Trim();
+    EXPECT_GT( released, 0 );
+    EXPECT_EQ( manager.GetSlabBytes(), 0 );
+}
+
+TEST_F( BlockPoolTest, ManagerSlabsTrimWhileInUse ) {
+    TrimWhileInUse<HakleBlockManager<HakleFlagsBlock<int, 64>>>();
+#if HAKLE_HAS_TAGGED_FREELIST
+    using BlockType = HakleFlagsBlock<int, 64>;
+    TrimWhileInUse<HakleBlockManager<BlockType, HakleAllocator<BlockType>, FreeList_Tagged<BlockType>>>();
+#endif
+}
+
+// 测试 Maintain：低于 LowWater 时提前备好 slab，连续多轮高于 HighWater 时释放多余的 slab
+TEST_F( BlockPoolTest, ManagerMaintain ) {
+    constexpr size_t POOL_SIZE  = 2;
+    constexpr size_t SLAB_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( POOL_SIZE, {}, SLAB_SIZE );
+
+    // 池 2 块 + 两个 slab
+    EXPECT_EQ( manager.Maintain( 10 ), 10 );
+    EXPECT_EQ( manager.GetSlabBytes(), 2 * SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( manager.Maintain( 10 ), 10 );
+    EXPECT_EQ( manager.GetCounters().OverflowAllocations, 2 );
+
+    // 不允许分配时也能拿到备好的 block
+    std::vector<BlockType*> blocks;
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), 10 );
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+
+    // 第一轮只记下，第二轮才释放
+    EXPECT_EQ( manager.Maintain( 0, 4, 2 ), 10 );
+    EXPECT_EQ( manager.GetSlabBytes(), 2 * SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( manager.Maintain( 0, 4, 2 ), 10 );
+    EXPECT_EQ( manager.GetSlabBytes(), 0 );
+
+    // 回落后轮数重新计
+    EXPECT_EQ( manager.Maintain( 6 ), 6 );
+    EXPECT_EQ( manager.Maintain( 0, 8, 2 ), 6 );
+    EXPECT_EQ( manager.GetSlabBytes(), SLAB_SIZE * sizeof( BlockType ) );
+
+    // 预算以内才备 block，且不算作拒绝
+    manager.Trim();
+    manager.SetBlockBudget( 5 );
+    EXPECT_EQ( manager.Maintain( 100 ), 5 );
+    EXPECT_EQ( manager.GetSlabBytes(), 3 * sizeof( BlockType ) );
+    EXPECT_EQ( manager.GetCounters().RefusedAllocations, 0 );
+}
+
+#if HAKLE_HAS_TAGGED_FREELIST
+// FreeList 换成单字 tagged 头后，manager 的行为不变
+TEST_F( BlockPoolTest, ManagerTaggedFreeList ) {
+    constexpr size_t POOL_SIZE  = 2;
+    constexpr size_t SLAB_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType, HakleAllocator<BlockType>, FreeList_Tagged<BlockType>> manager( POOL_SIZE, {}, SLAB_SIZE );
+
+    std::set<BlockType*> unique;
+    for ( size_t i = 0; i < POOL_SIZE + SLAB_SIZE; ++i ) {
+        EXPECT_TRUE( unique.insert( manager.RequisitionBlock( AllocMode::CanAlloc ) ).second );
+    }
+    EXPECT_EQ( manager.RequisitionBlock( AllocMode::CannotAlloc ), nullptr );
+    for ( BlockType* block : unique ) {
+        manager.ReturnBlock( block );
+    }
+
+    // 一次取出一串，放回后全部空闲，slab 可以释放
+    BlockType* chain = manager.RequisitionBlocks( POOL_SIZE + SLAB_SIZE, AllocMode::CannotAlloc );
+    size_t     count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+        EXPECT_EQ( unique.count( block ), 1 );
+        ++count;
+    }
+    EXPECT_EQ( count, POOL_SIZE + SLAB_SIZE );
+    manager.ReturnBlocks( chain );
+    EXPECT_EQ( manager.Trim(), SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( manager.Maintain( POOL_SIZE + SLAB_SIZE ), POOL_SIZE + SLAB_SIZE );
+}
+#endif
+
+// 测试内存预算：超出后拒绝分配，计数器记录当前、峰值、溢出和拒绝次数
+TEST_F( BlockPoolTest, ManagerBudget ) {
+    constexpr size_t POOL_SIZE  = 2;
+    constexpr size_t SLAB_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( POOL_SIZE, {}, SLAB_SIZE );
+    manager.SetBlockBudget( 7 );
+
+    // 池 2 块 + 一个 slab 4 块 + 截短的 slab 1 块
+    std::vector<BlockType*> blocks;
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CanAlloc ) ) {
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), 7 );
+    EXPECT_EQ( manager.RequisitionBlocks( 2, AllocMode::CanAlloc ), nullptr );
+
+    BlockCounters counters = manager.GetCounters();
+    EXPECT_EQ( counters.CurrentBytes, 7 * sizeof( BlockType ) );
+    EXPECT_EQ( counters.PeakBytes, 7 * sizeof( BlockType ) );
+    EXPECT_EQ( counters.OverflowAllocations, 2 );
+    EXPECT_GE( counters.RefusedAllocations, 2 );
+
+    // 归还后可以再拿到
+    manager.ReturnBlock( blocks.back() );
+    blocks.back() = manager.RequisitionBlock( AllocMode::CanAlloc );
+    EXPECT_NE( blocks.back(), nullptr );
+
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+    manager.Trim();
+    counters = manager.GetCounters();
+    EXPECT_EQ( counters.CurrentBytes, POOL_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( counters.PeakBytes, 7 * sizeof( BlockType ) );
+
+    // 按字节设置，预算小于池时只能用池里的 block
+    manager.SetMemoryBudget( sizeof( BlockType ) );
+    BlockType* chain = manager.RequisitionBlocks( POOL_SIZE + 1, AllocMode::CanAlloc );
+    size_t     count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+        ++count;
+    }
+    EXPECT_EQ( count, POOL_SIZE );
+    manager.ReturnBlocks( chain );
+}
+
+// 测试 Wait 策略：超出预算时等待其他线程归还 block
+TEST_F( BlockPoolTest, ManagerBudgetWait ) {
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( 2 );
+    manager.SetBlockBudget( 2, BudgetPolicy::Wait );
+
+    BlockType* first  = manager.RequisitionBlock( AllocMode::CanAlloc );
+    BlockType* second = manager.RequisitionBlock( AllocMode::CanAlloc );
+    ASSERT_NE( first, nullptr );
+    ASSERT_NE( second, nullptr );
+
+    std::atomic<bool> returned{ false };
+    std::thread       releaser( [ & ]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        returned.store( true );
+        manager.ReturnBlock( first );
+    } );
+
+    BlockType* third = manager.RequisitionBlock( AllocMode::CanAlloc );
+    EXPECT_TRUE( returned.load() );
+    EXPECT_EQ( third, first );
+    releaser.join();
+
+    // 永远满足不了的批量请求不等待
+    EXPECT_EQ( manager.RequisitionBlocks( 3, AllocMode::CanAlloc ), nullptr );
+    // 不允许分配时也不等待
+    EXPECT_EQ( manager.RequisitionBlock( AllocMode::CannotAlloc ), nullptr );
+
+    manager.ReturnBlock( second );
+    manager.ReturnBlock( third );
+}
+
+TEST_F( BlockPoolTest, ManagerBudgetWaitBulk ) {
+    constexpr size_t BLOCK_SIZE  = 64;
+    constexpr int    NUM_THREADS = 4;
+    constexpr int    ROUNDS      = 20000;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( 0 );
+    manager.SetBlockBudget( 4, BudgetPolicy::Wait );
+
+    // 预算只够一个 3 块的批量请求，等待时不能各自攥着一部分 block 互相等
+    std::vector<std::thread> threads;
+    std::atomic<int>         short_chains{ 0 };
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ &, t ]() {
+            for ( int i = 0; i < ROUNDS; ++i ) {
+                size_t     count = 1 + static_cast<size_t>( ( t + i ) % 3 );
+                BlockType* chain = manager.RequisitionBlocks( count, AllocMode::CanAlloc );
+                size_t     n     = 0;
+                for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+                    ++n;
+                }
+                if ( n != count ) {
+                    short_chains.fetch_add( 1 );
+                }
+                manager.ReturnBlocks( chain );
+            }
+        } );
+    }
+    for ( auto& thread : threads ) {
+        thread.join();
+    }
+    EXPECT_EQ( short_chains.load(), 0 );
+    EXPECT_EQ( manager.GetSlabBytes(), 4 * sizeof( BlockType ) );
+}
+
+TEST_F( BlockPoolTest, ManagerReserveRefuses ) {
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( 0 );
+    manager.SetBlockBudget( 4, BudgetPolicy::Wait );
+
+    // 超过预算的预留立即失败，不等待
+    EXPECT_FALSE( ReserveBlocks( manager, 5 ) );
+    EXPECT_TRUE( ReserveBlocks( manager, 4 ) );
+    EXPECT_EQ( manager.GetSlabBytes(), 4 * sizeof( BlockType ) );
+
+    // 预留不拿走 block，之后不允许分配也能拿到
+    BlockType* chain = manager.RequisitionBlocks( 4, AllocMode::CannotAlloc );
+    ASSERT_NE( chain, nullptr );
+
+    // block 全被拿走时也不等待
+    EXPECT_FALSE( ReserveBlocks( manager, 1 ) );
+    manager.ReturnBlocks( chain );
+    EXPECT_TRUE( ReserveBlocks( manager, 4 ) );
+}
+
+TEST_F( BlockPoolTest, HugePageAllocator ) {
+    using Allocator = HakleHugePageAllocator<int>;
+
+    // 小分配走 operator new，大分配走大页映射，都按缓存行对齐
+    constexpr size_t SMALL = 100;
+    constexpr size_t LARGE = ( 3 << 20 ) / sizeof( int );
+    EXPECT_FALSE( Allocator::UsesHugePages( SMALL ) );
+
+    int* small = Allocator::Allocate( SMALL );
+    int* large = Allocator::Allocate( LARGE );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( small ) % HAKLE_CACHE_LINE_SIZE, 0 );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( large ) % HAKLE_CACHE_LINE_SIZE, 0 );
+    for ( size_t i = 0; i < LARGE; ++i ) {
+        large[ i ] = static_cast<int>( i );
+    }
+    EXPECT_EQ( large[ LARGE - 1 ], static_cast<int>( LARGE - 1 ) );
+    Allocator::Deallocate( small, SMALL );
+    Allocator::Deallocate( large, LARGE );
+
+    // 池足够大时整个池落在大页上
+    using BlockType            = HakleFlagsBlock<int, 64>;
+    using BlockAllocator       = HakleHugePageAllocator<BlockType>;
+    constexpr size_t POOL_SIZE = ( 2 << 20 ) / sizeof( BlockType );
+    HakleBlockManager<BlockType, BlockAllocator> manager( POOL_SIZE );
+
+    std::vector<BlockType*> blocks;
+    for ( size_t i = 0; i < POOL_SIZE; ++i ) {
+        BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc );
+        ASSERT_NE( block, nullptr );
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( blocks.front() ) % HAKLE_CACHE_LINE_SIZE, 0 );
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+}
+
+// 测试常驻分配器：所有页在分配时就缺页，大分配单独映射，rebind 保留是否锁定
+TEST_F( BlockPoolTest, PinnedAllocator ) {
+    using Allocator = HaklePinnedAllocator<int>;
+    static_assert( std::is_same<HakeAllocatorTraits<Allocator>::RebindAlloc<long>, HaklePinnedAllocator<long>>::value, "" );
+    static_assert( std::is_same<HakeAllocatorTraits<HaklePinnedAllocator<int, false>>::RebindAlloc<long>, HaklePinnedAllocator<long, false>>::value, "" );
+
+    const size_t SMALL = 16;
+    const size_t LARGE = 4 * Allocator::PageSize() / sizeof( int );
+    EXPECT_FALSE( Allocator::UsesMapping( SMALL ) );
+
+    int* small = Allocator::Allocate( SMALL );
+    int* large = Allocator::Allocate( LARGE );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( small ) % HAKLE_CACHE_LINE_SIZE, 0 );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( large ) % HAKLE_CACHE_LINE_SIZE, 0 );
+    for ( size_t i = 0; i < LARGE; ++i ) {
+        large[ i ] = static_cast<int>( i );
+    }
+    EXPECT_EQ( large[ LARGE - 1 ], static_cast<int>( LARGE - 1 ) );
+    Allocator::Deallocate( small, SMALL );
+    Allocator::Deallocate( large, LARGE );
+
+    // 整个池一次分配，构造完就全部常驻
+    using BlockType      = HakleFlagsBlock<int, 64>;
+    using BlockAllocator = HaklePinnedAllocator<BlockType, false>;
+    HakleBlockManager<BlockType, BlockAllocator> manager( 64 );
+    std::vector<BlockType*> blocks;
+    for ( size_t i = 0; i < 64; ++i ) {
+        BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc );
+        ASSERT_NE( block, nullptr );
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( manager.RequisitionBlock( AllocMode::CannotAlloc ), nullptr );
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+}
+
+// 测试 arena 分配器：小分配从共享的 arena 切出，大分配走 operator new，arena 随最后一个副本释放
+TEST_F( BlockPoolTest, ArenaAllocator ) {
+    struct alignas( 64 ) Aligned {
+        char data[ 40 ];
+    };
+
+    HakleArenaAllocator<int> allocator( 8192 );
+    HakleArena*              arena = allocator.GetArena();
+    EXPECT_EQ( arena->GetBytes(), 0 );
+
+    // 副本和 rebind 共用同一个 arena
+    HakleArenaAllocator<int>     copy( allocator );
+    HakleArenaAllocator<Aligned> rebound( allocator );
+    EXPECT_TRUE( copy == allocator );
+    EXPECT_EQ( rebound.GetArena(), arena );
+    EXPECT_FALSE( HakleArenaAllocator<int>() == allocator );
+
+    int*     first  = allocator.Allocate( 3 );
+    int*     second = copy.Allocate();
+    Aligned* wide   = rebound.Allocate();
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( first ) % alignof( std::max_align_t ), 0 );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( wide ) % alignof( Aligned ), 0 );
+    EXPECT_NE( first, second );
+    EXPECT_EQ( arena->GetBytes(), arena->GetChunkSize() );
+
+    // 超过四分之一 chunk 的分配不进 arena
+    constexpr size_t LARGE = 4096;
+    EXPECT_FALSE( arena->Serves( LARGE * sizeof( int ), alignof( int ) ) );
+    int* large = allocator.Allocate( LARGE );
+    large[ LARGE - 1 ] = 1;
+    allocator.Deallocate( large, LARGE );
+    EXPECT_EQ( arena->GetBytes(), arena->GetChunkSize() );
+
+    // 一个 chunk 用完后接着开新的
+    for ( int i = 0; i < 100; ++i ) {
+        allocator.Allocate( 64 )[ 63 ] = i;
+    }
+    EXPECT_GT( arena->GetBytes(), arena->GetChunkSize() );
+    allocator.Deallocate( first, 3 );
+    copy.Deallocate( second );
+    rebound.Deallocate( wide );
+}
+
+// 多线程同时从一个 arena 分配，拿到的内存互不重叠
+TEST_F( BlockPoolTest, ArenaAllocatorConcurrent ) {
+    constexpr int NUM_THREADS = 4;
+    constexpr int PER_THREAD  = 2000;
+
+    HakleArenaAllocator<std::uint64_t>        allocator( 4096 );
+    std::vector<std::vector<std::uint64_t*>> taken( NUM_THREADS );
+    std::vector<std::thread>                 threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ allocator, &taken, t ]() mutable {
+            for ( int i = 0; i < PER_THREAD; ++i ) {
+                std::uint64_t* value = allocator.Allocate( 1 + i % 5 );
+                *value               = static_cast<std::uint64_t>( t ) << 32 | static_cast<std::uint64_t>( i );
+                taken[ t ].push_back( value );
+            }
+        } );
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+
+    std::set<std::uint64_t*> unique;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        for ( int i = 0; i < PER_THREAD; ++i ) {
+            EXPECT_TRUE( unique.insert( taken[ t ][ i ] ).second );
+            EXPECT_EQ( *taken[ t ][ i ], static_cast<std::uint64_t>( t ) << 32 | static_cast<std::uint64_t>( i ) );
+        }
+    }
+}
+
+// 测试 size-class 分配器：请求按大小和对齐归到固定的档位，线程缓存后进先出地复用刚释放的块
+TEST_F( BlockPoolTest, SlabAllocator ) {
+    struct alignas( 64 ) Aligned {
+        char data[ 40 ];
+    };
+
+    // 档位是 2 的幂和两者之间的 1.5 倍，都是 16 的倍数
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabHeap::ClassOf( 1, 1 ) ), 16 );
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabHeap::ClassOf( 33, 8 ) ), 48 );
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabHeap::ClassOf( 65, 8 ) ), 96 );
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabHeap::ClassOf( 97, 8 ) ), 128 );
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabHeap::ClassCount - 1 ), HakleSlabHeap::MaxSize );
+    // 超过 16 字节的对齐只落在能整除对齐的档位上
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabAllocator<Aligned>::ClassOf( 1 ) ), 64 );
+    EXPECT_EQ( HakleSlabHeap::ClassSize( HakleSlabAllocator<Aligned>::ClassOf( 3 ) ), 192 );
+    EXPECT_EQ( HakleSlabHeap::ClassOf( HakleSlabHeap::MaxSize + 1, 8 ), HakleSlabHeap::ClassCount );
+    EXPECT_EQ( HakleSlabAllocator<int>::ClassOf( static_cast<size_t>( -1 ) ), HakleSlabHeap::ClassCount );
+
+    HakleSlabAllocator<int>     allocator;
+    HakleSlabAllocator<Aligned> rebound( allocator );
+    EXPECT_TRUE( allocator == HakleSlabAllocator<int>() );
+
+    int* first = allocator.Allocate( 10 );
+    EXPECT_GT( HakleSlabHeap::GetBytes(), 0 );
+    allocator.Deallocate( first, 10 );
+    int* second = allocator.Allocate( 12 );
+    EXPECT_EQ( first, second );
+    allocator.Deallocate( second, 12 );
+
+    std::vector<Aligned*> wides;
+    for ( int i = 0; i < 100; ++i ) {
+        wides.push_back( rebound.Allocate() );
+        EXPECT_EQ( reinterpret_cast<std::uintptr_t>( wides.back() ) % alignof( Aligned ), 0 );
+    }
+    for ( Aligned* wide : wides ) {
+        rebound.Deallocate( wide );
+    }
+
+    // 缓存最多两批，多出来的整批还给共享栈
+    const size_t cls   = HakleSlabAllocator<Aligned>::ClassOf( 1 );
+    const size_t batch = HakleSlabHeap::BatchSize( cls );
+    EXPECT_GE( HakleSlabHeap::GetThreadCached( cls ), batch );
+    EXPECT_LT( HakleSlabHeap::GetThreadCached( cls ), 2 * batch );
+
+    // 超过 MaxSize 的数组走 operator new
+    constexpr size_t LARGE = HakleSlabHeap::MaxSize;
+    int*             large = allocator.Allocate( LARGE );
+    large[ LARGE - 1 ]     = 1;
+    allocator.Deallocate( large, LARGE );
+}
+
+// 记录未释放字节数并检查对齐的 memory_resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::atomic<std::size_t> outstanding{ 0 };
+    std::atomic<std::size_t> calls{ 0 };
+    std::atomic<bool>        misaligned{ false };
+
+private:
+    void* do_allocate( std::size_t bytes, std::size_t alignment ) override {
+        void* ptr = std::pmr::new_delete_resource()->allocate( bytes, alignment );
+        if ( reinterpret_cast<std::uintptr_t>( ptr ) % alignment != 0 ) {
+            misaligned.store( true );
+        }
+        outstanding.fetch_add( bytes );
+        calls.fetch_add( 1 );
+        return ptr;
+    }
+
+    void do_deallocate( void* ptr, std::size_t bytes, std::size_t alignment ) override {
+        outstanding.fetch_sub( bytes );
+        std::pmr::new_delete_resource()->deallocate( ptr, bytes, alignment );
+    }
+
+    bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+};
+
+// 测试 pmr 适配：rebind 共用同一个 resource，释放时大小和对齐与分配时一致
+TEST_F( BlockPoolTest, PmrAllocator ) {
+    struct alignas( 64 ) Aligned {
+        char data[ 40 ];
+    };
+
+    CountingResource           resource;
+    HaklePmrAllocator<int>     allocator( &resource );
+    HaklePmrAllocator<Aligned> rebound( allocator );
+    EXPECT_EQ( rebound.GetResource(), &resource );
+    EXPECT_TRUE( HaklePmrAllocator<int>( &resource ) == allocator );
+    EXPECT_FALSE( HaklePmrAllocator<int>() == allocator );
+
+    int*     values = allocator.Allocate( 7 );
+    Aligned* wide   = rebound.Allocate( 3 );
+    EXPECT_EQ( resource.outstanding.load(), 7 * sizeof( int ) + 3 * sizeof( Aligned ) );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>( wide ) % alignof( Aligned ), 0 );
+    allocator.Deallocate( values, 7 );
+    rebound.Deallocate( wide, 3 );
+    EXPECT_EQ( resource.outstanding.load(), 0 );
+    EXPECT_THROW( allocator.Allocate( static_cast<size_t>( -1 ) ), std::bad_array_new_length );
+
+    // block manager 的池、slab 和空闲链表节点全部从 resource 分配，析构后一字节不剩
+    using BlockType = HakleFlagsBlock<int, 64>;
+    {
+        HakleBlockManager<BlockType, HaklePmrAllocator<BlockType>> manager( 4, HaklePmrAllocator<BlockType>( &resource ) );
+        std::vector<BlockType*>                                    blocks;
+        for ( int i = 0; i < 20; ++i ) {
+            blocks.push_back( manager.RequisitionBlock( AllocMode::CanAlloc ) );
+            ASSERT_NE( blocks.back(), nullptr );
+        }
+        for ( BlockType* block : blocks ) {
+            manager.ReturnBlock( block );
+        }
+        EXPECT_GT( resource.outstanding.load(), 20 * sizeof( BlockType ) );
+    }
+    EXPECT_EQ( resource.outstanding.load(), 0 );
+    EXPECT_FALSE( resource.misaligned.load() );
+}
+
+// 一个线程分配、另一个线程释放，块经共享栈回到分配方手里，内存互不重叠
+TEST_F( BlockPoolTest, SlabAllocatorCrossThread ) {
+    constexpr int ROUNDS    = 50;
+    constexpr int PER_ROUND = 500;
+
+    HakleSlabAllocator<std::uint64_t> allocator;
+    std::vector<std::uint64_t*>       handoff;
+    std::atomic<int>                  stage{ 0 };
+
+    std::thread consumer( [ & ]() {
+        for ( int round = 0; round < ROUNDS; ++round ) {
+            while ( stage.load( std::memory_order_acquire ) != 2 * round + 1 ) {
+                std::this_thread::yield();
+            }
+            for ( int i = 0; i < PER_ROUND; ++i ) {
+                EXPECT_EQ( *handoff[ i ], static_cast<std::uint64_t>( round ) << 32 | static_cast<std::uint64_t>( i ) );
+                allocator.Deallocate( handoff[ i ], 1 + i % 3 );
+            }
+            handoff.clear();
+            stage.store( 2 * round + 2, std::memory_order_release );
+        }
+    } );
+
+    for ( int round = 0; round < ROUNDS; ++round ) {
+        std::set<std::uint64_t*> unique;
+        for ( int i = 0; i < PER_ROUND; ++i ) {
+            std::uint64_t* value = allocator.Allocate( 1 + i % 3 );
+            *value               = static_cast<std::uint64_t>( round ) << 32 | static_cast<std::uint64_t>( i );
+            EXPECT_TRUE( unique.insert( value ).second );
+            handoff.push_back( value );
+        }
+        stage.store( 2 * round + 1, std::memory_order_release );
+        while ( stage.load( std::memory_order_acquire ) != 2 * round + 2 ) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    // 对方线程退出时把缓存交回共享栈，反复交接不会无限增长
+    EXPECT_LE( HakleSlabHeap::GetBytes(), 16 * HakleSlabHeap::SpanSize );
+}
+
+TEST_F( BlockPoolTest, MagazineManager ) {
+    constexpr size_t POOL_SIZE     = 8;
+    constexpr size_t BLOCK_SIZE    = 64;
+    constexpr size_t MAGAZINE_SIZE = 4;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    MagazineBlockManager<BlockType, HakleAllocator<BlockType>, MAGAZINE_SIZE> manager( POOL_SIZE, {}, 1 );
+
+    // 弹匣为空时从共享空闲链表/池里补半个弹匣，不允许分配时总共只能拿到池里的 8 块
+    std::vector<BlockType*> blocks;
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), POOL_SIZE );
+
+    // 归还超过弹匣容量时，多出来的部分整链还给共享空闲链表，不会丢块
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+    blocks.clear();
+
+    BlockType* chain = manager.RequisitionBlocks( POOL_SIZE, AllocMode::CannotAlloc );
+    size_t     count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+        ++count;
+    }
+    EXPECT_EQ( count, POOL_SIZE );
+    manager.ReturnBlocks( chain );
+
+    // 清空弹匣后块全部回到共享空闲链表
+    manager.Drain();
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), POOL_SIZE );
+    for ( BlockType* block : blocks ) {
+        manager.ReturnBlock( block );
+    }
+}
+
+TEST_F( BlockPoolTest, MagazineManagerConcurrent ) {
+    constexpr size_t POOL_SIZE   = 64;
+    constexpr size_t BLOCK_SIZE  = 64;
+    constexpr int    NUM_THREADS = 8;
+    constexpr int    ROUNDS      = 10000;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    MagazineBlockManager<BlockType> manager( POOL_SIZE );
+
+    std::atomic<int>         errors{ 0 };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ &manager, &errors, t ] {
+            BlockType* held[ 4 ];
+            for ( int round = 0; round < ROUNDS; ++round ) {
+                for ( BlockType*& block : held ) {
+                    block = manager.RequisitionBlock( AllocMode::CanAlloc );
+                    // 同一时刻一个块只能属于一个线程
+                    *( *block )[ 0 ] = t;
+                }
+                for ( BlockType* block : held ) {
+                    if ( *( *block )[ 0 ] != t ) {
+                        errors.fetch_add( 1, std::memory_order_relaxed );
+                    }
+                    manager.ReturnBlock( block );
+                }
+            }
+        } );
+    }
+    for ( auto& thread : threads ) {
+        thread.join();
+    }
+
+    EXPECT_EQ( errors.load(), 0 );
+}
+
+TEST_F( BlockPoolTest, NumaManager ) {
+    constexpr size_t POOL_SIZE  = 4;
+    constexpr size_t NODE_COUNT = 2;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    // 单节点机器上也能模拟两个节点
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    NumaBlockManager<BlockType> manager( POOL_SIZE, {}, NODE_COUNT );
+    EXPECT_EQ( manager.GetNodeCount(), NODE_COUNT );
+    EXPECT_EQ( manager.GetBlockPoolSize(), POOL_SIZE * NODE_COUNT );
+    EXPECT_GE( NumaNodeCount(), 1 );
+
+    // 先用完本地节点，再借用其他节点的空闲块
+    const size_t            local = manager.GetLocalNode();
+    std::vector<BlockType*> blocks;
+    while ( BlockType* block = manager.RequisitionBlock( AllocMode::CannotAlloc ) ) {
+        EXPECT_EQ( block->HomeNode, blocks.size() < POOL_SIZE ? local : ( local + 1 ) % NODE_COUNT );
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( blocks.size(), POOL_SIZE * NODE_COUNT );
+
+    // 两个节点都空了才在本地分配
+    BlockType* grown = manager.RequisitionBlock( AllocMode::CanAlloc );
+    ASSERT_NE( grown, nullptr );
+    EXPECT_EQ( grown->HomeNode, local );
+    EXPECT_GT( manager.GetSlabBytes(), 0 );
+    blocks.push_back( grown );
+
+    // 块按来源节点归还，本地只拿回本地的块
+    for ( size_t i = 0; i + 1 < blocks.size(); ++i ) {
+        blocks[ i ]->Next = blocks[ i + 1 ];
+    }
+    blocks.back()->Next = nullptr;
+    manager.ReturnBlocks( blocks.front() );
+
+    BlockType* chain = manager.RequisitionBlocks( POOL_SIZE + 1, AllocMode::CannotAlloc );
+    size_t     count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next, ++count ) {
+        EXPECT_EQ( block->HomeNode, local );
+    }
+    EXPECT_EQ( count, POOL_SIZE + 1 );
+    manager.ReturnBlocks( chain );
+
+    chain = manager.RequisitionBlocks( blocks.size(), AllocMode::CannotAlloc );
+    count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+        ++count;
+    }
+    EXPECT_EQ( count, blocks.size() );
+    manager.ReturnBlocks( chain );
+    EXPECT_GT( manager.Trim(), 0 );
+}
+
+TEST_F( BlockPoolTest, PolymorphicManager ) {
+    constexpr size_t POOL_SIZE  = 8;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+
+    // 具体的 manager 没有虚函数，队列直接调用
+    static_assert( !std::is_polymorphic<HakleBlockManager<BlockType>>::value, "HakleBlockManager must not be polymorphic" );
+    static_assert( !std::is_polymorphic<MagazineBlockManager<BlockType>>::value, "MagazineBlockManager must not be polymorphic" );
+
+    // 需要运行时多态时经适配器使用
+    std::unique_ptr<PolymorphicBlockManager<BlockType>> manager = std::make_unique<PolymorphicBlockManagerAdapter<HakleBlockManager<BlockType>>>( POOL_SIZE );
+
+    BlockType* chain = manager->RequisitionBlocks( POOL_SIZE, AllocMode::CannotAlloc );
+    size_t     count = 0;
+    for ( BlockType* block = chain; block != nullptr; block = block->Next ) {
+        ++count;
+    }
+    EXPECT_EQ( count, POOL_SIZE );
+    EXPECT_EQ( manager->RequisitionBlock( AllocMode::CannotAlloc ), nullptr );
+    manager->ReturnBlocks( chain );
+
+    BlockType* block = manager->RequisitionBlock( AllocMode::CannotAlloc );
+    ASSERT_NE( block, nullptr );
+    manager->ReturnBlock( block );
+}
+
+// 测试内存统计：池、溢出、空闲和已借出的字节数随借还变化
+TEST_F( BlockPoolTest, ManagerMemoryStats ) {
+    constexpr size_t POOL_SIZE  = 4;
+    constexpr size_t SLAB_SIZE  = 4;
+    constexpr size_t BLOCK_SIZE = 64;
+
+    using BlockType = HakleFlagsBlock<int, BLOCK_SIZE>;
+    HakleBlockManager<BlockType> manager( POOL_SIZE, {}, SLAB_SIZE );
+
+    MemoryStats stats = manager.GetMemoryStats();
+    EXPECT_EQ( stats.PoolBlockBytes, POOL_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( stats.OverflowBlockBytes, 0 );
+    EXPECT_EQ( stats.FreeBlockBytes, POOL_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( stats.ProducerBlockBytes, 0 );
+
+    // 池用完后从 slab 分配
+    BlockType* chain = manager.RequisitionBlocks( POOL_SIZE + 1, AllocMode::CanAlloc );
+    BlockType* block = manager.RequisitionBlock( AllocMode::CanAlloc );
+    ASSERT_NE( block, nullptr );
+    stats = manager.GetMemoryStats();
+    EXPECT_EQ( stats.OverflowBlockBytes, SLAB_SIZE * sizeof( BlockType ) );
+    EXPECT_EQ( stats.ProducerBlockBytes, ( POOL_SIZE + 2 ) * sizeof( BlockType ) );
+    EXPECT_EQ( stats.FreeBlockBytes, ( SLAB_SIZE - 2 ) * sizeof( BlockType ) );
+    EXPECT_EQ( stats.GetTotalBytes(), ( POOL_SIZE + SLAB_SIZE ) * sizeof( BlockType ) );
+
+    // 其他线程归还也能算对
+    std::thread( [ &manager, block ]() { manager.ReturnBlock( block ); } ).join();
+    manager.ReturnBlocks( chain );
+    stats = manager.GetMemoryStats();
+    EXPECT_EQ( stats.ProducerBlockBytes, 0 );
+    EXPECT_EQ( stats.FreeBlockBytes, ( POOL_SIZE + SLAB_SIZE ) * sizeof( BlockType ) );
+
+    // 接管另一个 manager 借出的 block
+    HakleBlockManager<BlockType> other( 2 );
+    BlockType*                   borrowed = other.RequisitionBlock( AllocMode::CannotAlloc );
+    manager.AdoptBlocks( other );
+    EXPECT_EQ( manager.GetMemoryStats().ProducerBlockBytes, sizeof( BlockType ) );
+    EXPECT_EQ( other.GetMemoryStats().ProducerBlockBytes, 0 );
+    manager.ReturnBlock( borrowed );
+    EXPECT_EQ( manager.GetMemoryStats().ProducerBlockBytes, 0 );
+
+    // 缓存在 magazine 里的 block 算作借出
+    MagazineBlockManager<BlockType> magazine( POOL_SIZE );
+    magazine.ReturnBlock( magazine.RequisitionBlock( AllocMode::CannotAlloc ) );
+    EXPECT_EQ( magazine.GetMemoryStats().PoolBlockBytes, POOL_SIZE * sizeof( BlockType ) );
+    magazine.Drain();
+    EXPECT_EQ( magazine.GetMemoryStats().ProducerBlockBytes, 0 );
+}
+
 int main( int argc, char** argv ) {
     ::testing::InitGoogleTest( &argc, argv );
     return RUN_ALL_TESTS();
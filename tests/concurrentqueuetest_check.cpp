@@ -4,6 +4,8 @@
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <thread>
 #include <vector>
 
@@ -396,6 +398,9 @@ TEST( ConcurrentQueueCorrectness, ProducerToken_Enq_TryDequeueFromProducer ) {
     EXPECT_EQ( produced.load(), totalItems );
     EXPECT_EQ( consumed.load(), totalItems );
     EXPECT_EQ( sum.load(), expectedSum );
+
+    // token 必须在所属队列之前析构
+    prodTokens.clear();
 }
 
 // ---------------------------------------------------------------------
@@ -542,6 +547,9 @@ TEST( ConcurrentQueueCorrectness, ProducerTokenBulkEnq_ConsumerTokenBulkDeq ) {
     EXPECT_EQ( produced.load(), totalItems );
     EXPECT_EQ( consumed.load(), totalItems );
     EXPECT_EQ( sum.load(), expectedSum );
+
+    // token 必须在所属队列之前析构
+    prodTokens.clear();
 }
 
 // ---------------------------------------------------------------------
@@ -924,6 +932,1014 @@ TEST( ConcurrentQueueCorrectness, ProducerTokenEnq_ConsumerTokenDeq_SingleElemen
     EXPECT_EQ( produced.load(), totalItems );
     EXPECT_EQ( consumed.load(), totalItems );
     EXPECT_EQ( sum.load(), expectedSum );
+
+    // token 必须在所属队列之前析构
+    prodTokens.clear();
+}
+
+// ---------------------------------------------------------------------
+// 8. Reserve 之后，预留容量内的 TryEnqueue 不需要分配
+// ---------------------------------------------------------------------
+TEST( ConcurrentQueueCorrectness, Reserve_TryEnqueueWithinReservedCapacity ) {
+    hakle::ConcurrentQueue<int> queue;
+
+    // 超过初始 block pool 的大小，不 Reserve 的话 TryEnqueue 会失败
+    constexpr std::size_t itemsPerProd = 64 * hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleAllocator<int>>::BlockSize;
+    ASSERT_TRUE( queue.Reserve( 1, 1, itemsPerProd ) );
+
+    {
+        auto token = queue.GetProducerToken();
+        for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+            ASSERT_TRUE( queue.TryEnqueue( token, static_cast<int>( i ) ) );
+        }
+    }
+
+    std::thread producer( [ & ] {
+        for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+            ASSERT_TRUE( queue.TryEnqueue( static_cast<int>( i ) ) );
+        }
+    } );
+    producer.join();
+
+    std::uint64_t sum = 0;
+    std::size_t   count = 0;
+    int           value;
+    while ( queue.TryDequeue( value ) ) {
+        sum += static_cast<std::uint64_t>( value );
+        ++count;
+    }
+
+    EXPECT_EQ( count, 2 * itemsPerProd );
+    EXPECT_EQ( sum, 2 * CalcExpectedSum( 1, itemsPerProd ) );
+
+    // 容量提示版本的 token
+    auto token = queue.GetProducerToken( itemsPerProd );
+    for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+        ASSERT_TRUE( queue.TryEnqueue( token, static_cast<int>( i ) ) );
+    }
+}
+
+// ---------------------------------------------------------------------
+// 9. 生产者节点、队列、首个索引数组和首个 block 一次分配
+// ---------------------------------------------------------------------
+struct SingleAllocationTraits : hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleAllocator<int>> {
+    static constexpr bool SingleAllocationProducers = true;
+};
+
+TEST( ConcurrentQueueCorrectness, SingleAllocationProducers_MultiProducer ) {
+    hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, SingleAllocationTraits> queue;
+
+    constexpr std::size_t prodThreads  = kProdThreadsSmall;
+    constexpr std::size_t itemsPerProd = 10000;
+
+    std::vector<std::thread> producers;
+    for ( std::size_t p = 0; p < prodThreads; ++p ) {
+        producers.emplace_back( [ &queue, p ] {
+            // 一半线程用 token（显式生产者），一半用隐式生产者
+            if ( p % 2 == 0 ) {
+                auto token = queue.GetProducerToken();
+                for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+                    queue.EnqueueWithToken( token, static_cast<int>( p * itemsPerProd + i ) );
+                }
+            }
+            else {
+                for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+                    queue.Enqueue( static_cast<int>( p * itemsPerProd + i ) );
+                }
+            }
+        } );
+    }
+    for ( auto& t : producers ) {
+        t.join();
+    }
+
+    // 移动后仍可正常出队
+    hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, SingleAllocationTraits> moved( std::move( queue ) );
+
+    std::uint64_t sum   = 0;
+    std::size_t   count = 0;
+    int           value;
+    while ( moved.TryDequeue( value ) ) {
+        sum += static_cast<std::uint64_t>( value );
+        ++count;
+    }
+
+    EXPECT_EQ( count, prodThreads * itemsPerProd );
+    EXPECT_EQ( sum, CalcExpectedSum( prodThreads, itemsPerProd ) );
+}
+
+// ---------------------------------------------------------------------
+// 10. 按 CPU 划分的隐式生产者，线程数远多于 CPU 数
+// ---------------------------------------------------------------------
+struct PerCpuTraits : hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleAllocator<int>> {
+    static constexpr bool PerCpuProducers = true;
+};
+
+TEST( ConcurrentQueueCorrectness, PerCpuProducers_ManyThreads ) {
+    hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, PerCpuTraits> queue;
+
+    constexpr std::size_t prodThreads  = 64;
+    constexpr std::size_t consThreads  = 4;
+    constexpr std::size_t itemsPerProd = 2000;
+    const std::size_t     totalItems   = prodThreads * itemsPerProd;
+
+    std::atomic<std::size_t>   consumed{ 0 };
+    std::atomic<std::uint64_t> sum{ 0 };
+
+    std::vector<std::thread> threads;
+    for ( std::size_t p = 0; p < prodThreads; ++p ) {
+        threads.emplace_back( [ &queue, p ] {
+            // 单个和批量入队混用
+            for ( std::size_t i = 0; i < itemsPerProd; i += 4 ) {
+                if ( i % 8 == 0 ) {
+                    int items[ 4 ];
+                    for ( std::size_t j = 0; j < 4; ++j ) {
+                        items[ j ] = static_cast<int>( p * itemsPerProd + i + j );
+                    }
+                    ASSERT_TRUE( queue.EnqueueBulk( items, 4 ) );
+                }
+                else {
+                    for ( std::size_t j = 0; j < 4; ++j ) {
+                        ASSERT_TRUE( queue.Enqueue( static_cast<int>( p * itemsPerProd + i + j ) ) );
+                    }
+                }
+            }
+        } );
+    }
+    for ( std::size_t c = 0; c < consThreads; ++c ) {
+        threads.emplace_back( [ & ] {
+            int value;
+            while ( consumed.load( std::memory_order_relaxed ) < totalItems ) {
+                if ( queue.TryDequeue( value ) ) {
+                    sum.fetch_add( static_cast<std::uint64_t>( value ), std::memory_order_relaxed );
+                    consumed.fetch_add( 1, std::memory_order_relaxed );
+                }
+            }
+        } );
+    }
+    for ( auto& t : threads ) {
+        t.join();
+    }
+
+    EXPECT_EQ( consumed.load(), totalItems );
+    EXPECT_EQ( sum.load(), CalcExpectedSum( prodThreads, itemsPerProd ) );
+}
+
+// ---------------------------------------------------------------------
+// 10.1 按 CPU 划分的隐式生产者：槽位被占时换下一个槽位，生产者数量随 CPU 数而定
+// ---------------------------------------------------------------------
+#if defined( __linux__ )
+// 构造时等待放行，入队线程在此期间一直占着当前 CPU 的槽位
+struct GatedItem {
+    GatedItem() = default;
+    GatedItem( int InValue, std::atomic<bool>* Entered, std::atomic<bool>* Gate ) : Value( InValue ) {
+        if ( Entered != nullptr ) {
+            Entered->store( true );
+        }
+        while ( Gate != nullptr && !Gate->load() ) {
+            std::this_thread::yield();
+        }
+    }
+    int Value{ 0 };
+};
+
+struct GatedPerCpuTraits : hakle::ConcurrentQueueDefaultTraits<GatedItem, hakle::HakleAllocator<GatedItem>> {
+    static constexpr bool PerCpuProducers = true;
+};
+
+TEST( ConcurrentQueueCorrectness, PerCpuProducers_BusySlotProbesNext ) {
+    hakle::ConcurrentQueue<GatedItem, hakle::HakleAllocator<GatedItem>, GatedPerCpuTraits> queue;
+
+    // 两个线程绑在同一个 CPU 上，共用一个槽位
+    cpu_set_t allowed;
+    ASSERT_EQ( sched_getaffinity( 0, sizeof( allowed ), &allowed ), 0 );
+    int cpu = 0;
+    while ( !CPU_ISSET( cpu, &allowed ) ) {
+        ++cpu;
+    }
+    auto pin = [ cpu ] {
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( cpu, &set );
+        sched_setaffinity( 0, sizeof( set ), &set );
+    };
+
+    std::atomic<bool> gate{ false };
+    std::atomic<bool> holding{ false };
+    std::thread       holder( [ & ] {
+        pin();
+        ASSERT_TRUE( queue.Enqueue( 1, &holding, &gate ) );
+    } );
+    while ( !holding.load() ) {
+        std::this_thread::yield();
+    }
+    // 槽位被占时不等待，换同一个 CPU 的下一个槽位，不会给线程单独建生产者
+    std::thread other( [ & ] {
+        pin();
+        EXPECT_TRUE( queue.Enqueue( 2, nullptr, nullptr ) );
+        gate.store( true );
+    } );
+    other.join();
+    holder.join();
+
+    int       sum = 0;
+    GatedItem item;
+    while ( queue.TryDequeue( item ) ) {
+        sum += item.Value;
+    }
+    EXPECT_EQ( sum, 3 );
+}
+#endif
+
+TEST( ConcurrentQueueCorrectness, PerCpuProducers_BoundedByCpuCount ) {
+    // 单线程入队一次：一个生产者加上全部槽位
+    std::size_t oneProducerBytes = 0;
+    {
+        hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, PerCpuTraits> single;
+        ASSERT_TRUE( single.Enqueue( 0 ) );
+        oneProducerBytes = single.GetMemoryStats().ProducerBytes;
+    }
+
+    hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, PerCpuTraits> queue;
+
+    constexpr std::size_t prodThreads  = 256;
+    constexpr std::size_t itemsPerProd = 100;
+
+    std::atomic<bool>        start{ false };
+    std::vector<std::thread> threads;
+    for ( std::size_t p = 0; p < prodThreads; ++p ) {
+        threads.emplace_back( [ &queue, &start, p ] {
+            while ( !start.load() ) {
+                std::this_thread::yield();
+            }
+            for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+                ASSERT_TRUE( queue.Enqueue( static_cast<int>( p * itemsPerProd + i ) ) );
+            }
+        } );
+    }
+    start.store( true );
+    for ( auto& t : threads ) {
+        t.join();
+    }
+
+    // 生产者数量不超过 CPU 数的 4 倍，和线程数无关
+    EXPECT_LE( queue.GetMemoryStats().ProducerBytes, 4 * hakle::details::cpu_count() * oneProducerBytes );
+
+    std::uint64_t sum   = 0;
+    std::size_t   count = 0;
+    int           value;
+    while ( queue.TryDequeue( value ) ) {
+        sum += static_cast<std::uint64_t>( value );
+        ++count;
+    }
+    EXPECT_EQ( count, prodThreads * itemsPerProd );
+    EXPECT_EQ( sum, CalcExpectedSum( prodThreads, itemsPerProd ) );
+}
+
+
+// ---------------------------------------------------------------------
+// 11. SpliceFrom：整块转移，不逐个拷贝元素
+// ---------------------------------------------------------------------
+TEST( ConcurrentQueueCorrectness, SpliceFrom_MovesAllItems ) {
+    hakle::ConcurrentQueue<int> queue;
+
+    constexpr std::size_t prodThreads  = 4;
+    constexpr std::size_t itemsPerProd = 10000;
+    constexpr std::size_t consumedHead = 100;
+
+    std::uint64_t sum   = 0;
+    std::size_t   count = 0;
+    int           value;
+    {
+        hakle::ConcurrentQueue<int> other;
+        auto                        token = other.GetProducerToken();
+
+        std::vector<std::thread> producers;
+        for ( std::size_t p = 1; p < prodThreads; ++p ) {
+            producers.emplace_back( [ &other, p ] {
+                for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+                    ASSERT_TRUE( other.Enqueue( static_cast<int>( p * itemsPerProd + i ) ) );
+                }
+            } );
+        }
+        for ( std::size_t i = 0; i < itemsPerProd; ++i ) {
+            ASSERT_TRUE( other.EnqueueWithToken( token, static_cast<int>( i ) ) );
+        }
+        for ( auto& t : producers ) {
+            t.join();
+        }
+
+        // 先消费一部分，让头部 block 处于半消费状态
+        for ( std::size_t i = 0; i < consumedHead; ++i ) {
+            ASSERT_TRUE( other.TryDequeue( value ) );
+            sum += static_cast<std::uint64_t>( value );
+            ++count;
+        }
+
+        ASSERT_TRUE( queue.SpliceFrom( other ) );
+        EXPECT_FALSE( other.TryDequeue( value ) );
+
+        // other 之后仍然可用
+        ASSERT_TRUE( other.EnqueueWithToken( token, 7 ) );
+        ASSERT_TRUE( other.TryDequeue( value ) );
+        EXPECT_EQ( value, 7 );
+    }
+
+    // other 已经析构，转移过来的 block 仍然有效
+    while ( queue.TryDequeue( value ) ) {
+        sum += static_cast<std::uint64_t>( value );
+        ++count;
+    }
+
+    EXPECT_EQ( count, prodThreads * itemsPerProd );
+    EXPECT_EQ( sum, CalcExpectedSum( prodThreads, itemsPerProd ) );
+}
+
+TEST( ConcurrentQueueCorrectness, SpliceFrom_RebalanceKeepsProducersBounded ) {
+    hakle::ConcurrentQueue<int> left;
+    hakle::ConcurrentQueue<int> right;
+    auto                        leftToken  = left.GetProducerToken();
+    auto                        rightToken = right.GetProducerToken();
+
+    constexpr int items = 1000;
+    std::size_t   producerBytes[ 2 ]{};
+    std::size_t   blockBytes[ 2 ]{};
+    for ( int round = 0; round < 10; ++round ) {
+        for ( int i = 0; i < items; ++i ) {
+            ASSERT_TRUE( left.EnqueueWithToken( leftToken, i ) );
+            ASSERT_TRUE( right.EnqueueWithToken( rightToken, i ) );
+        }
+        ASSERT_TRUE( left.SpliceFrom( right ) );
+        EXPECT_EQ( left.Size(), 2 * static_cast<std::size_t>( items ) );
+        // 被转移的一方保留构造时的容量，不能分配的入队照常成功
+        ASSERT_TRUE( right.TryEnqueue( rightToken, 1 ) );
+        int value;
+        ASSERT_TRUE( right.TryDequeue( value ) );
+        for ( int i = 0; i < items; ++i ) {
+            ASSERT_TRUE( left.TryDequeue( value ) );
+        }
+        ASSERT_TRUE( right.SpliceFrom( left ) );
+        EXPECT_EQ( right.Size(), static_cast<std::size_t>( items ) );
+        ASSERT_TRUE( left.TryEnqueue( leftToken, 1 ) );
+        ASSERT_TRUE( left.TryDequeue( value ) );
+        while ( right.TryDequeue( value ) ) {
+        }
+
+        // 来回转移时复用停放的空生产者，生产者链表不会一直变长；接管来的存储空闲后能被释放，block 也不会一直变多
+        left.TrimBlocks();
+        right.TrimBlocks();
+        hakle::MemoryStats stats[ 2 ] = { left.GetMemoryStats(), right.GetMemoryStats() };
+        for ( int q = 0; q < 2; ++q ) {
+            std::size_t bytes = stats[ q ].PoolBlockBytes + stats[ q ].OverflowBlockBytes;
+            if ( round == 1 ) {
+                producerBytes[ q ] = stats[ q ].ProducerBytes;
+                blockBytes[ q ]    = bytes;
+            }
+            else if ( round > 1 ) {
+                EXPECT_EQ( stats[ q ].ProducerBytes, producerBytes[ q ] );
+                EXPECT_LE( bytes, blockBytes[ q ] );
+            }
+        }
+    }
+}
+
+TEST( ConcurrentQueueCorrectness, TrimBlocks_AfterBurst ) {
+    hakle::ConcurrentQueue<int> queue;
+
+    // 超过初始池的一波流量，多出来的 block 来自 slab
+    constexpr std::size_t burst = 4 * hakle::ConcurrentQueue<int>::InitialBlockPoolSize * hakle::ConcurrentQueue<int>::BlockSize;
+
+    int value;
+    for ( int round = 0; round < 2; ++round ) {
+        for ( std::size_t i = 0; i < burst; ++i ) {
+            ASSERT_TRUE( queue.Enqueue( static_cast<int>( i ) ) );
+        }
+        std::uint64_t sum = 0;
+        while ( queue.TryDequeue( value ) ) {
+            sum += static_cast<std::uint64_t>( value );
+        }
+        EXPECT_EQ( sum, static_cast<std::uint64_t>( burst ) * ( burst - 1 ) / 2 );
+
+        // 空闲后归还 slab，之后还能照常使用
+        EXPECT_GT( queue.TrimBlocks(), 0 );
+        EXPECT_EQ( queue.TrimBlocks(), 0 );
+    }
+}
+
+TEST( ConcurrentQueueCorrectness, TrimBlocks_TryEnqueueNeverStarves ) {
+    using Queue = hakle::ConcurrentQueue<int>;
+    Queue queue;
+
+    // 入队线程同一时刻最多用两个 block，池里总有空闲的 block，TryEnqueue 不应该失败
+    constexpr std::size_t lowWater   = 64 * Queue::InitialBlockPoolSize;
+    constexpr int         trimRounds = 10;
+
+    std::atomic<bool> done{ false };
+    std::size_t       released = 0;
+    std::thread       trimmer( [ & ] {
+        // 每轮先备好一批 slab，再全部归还
+        for ( int round = 0; round < trimRounds; ++round ) {
+            queue.MaintainBlocks( lowWater );
+            released += queue.TrimBlocks();
+        }
+        done.store( true );
+    } );
+
+    std::size_t failures = 0;
+    int         value    = 0;
+    for ( int i = 0; !done.load(); ++i ) {
+        if ( !queue.TryEnqueue( i ) ) {
+            ++failures;
+            continue;
+        }
+        ASSERT_TRUE( queue.TryDequeue( value ) );
+        ASSERT_EQ( value, i );
+    }
+    trimmer.join();
+
+    EXPECT_EQ( failures, 0 );
+    EXPECT_GT( released, 0 );
+}
+
+TEST( ConcurrentQueueCorrectness, MaintainBlocks_Prefill ) {
+    hakle::ConcurrentQueue<int> queue;
+
+    // 每个 block manager 都备到 lowWater 块，多出来的来自 slab
+    constexpr std::size_t lowWater = 2 * hakle::ConcurrentQueue<int>::InitialBlockPoolSize;
+    EXPECT_GE( queue.MaintainBlocks( lowWater ), 2 * lowWater );
+    EXPECT_GE( queue.MaintainBlocks( lowWater ), 2 * lowWater );
+
+    int value = 0;
+    for ( int i = 0; i < 100; ++i ) {
+        ASSERT_TRUE( queue.Enqueue( i ) );
+    }
+    for ( int i = 0; i < 100; ++i ) {
+        ASSERT_TRUE( queue.TryDequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+
+    // 空闲时备好的 slab 可以归还
+    EXPECT_GT( queue.TrimBlocks(), 0 );
+}
+
+TEST( ConcurrentQueueCorrectness, MaintainBlocks_HighWaterUnderTraffic ) {
+    using Queue = hakle::ConcurrentQueue<int>;
+    Queue queue;
+
+    constexpr int         prodThreads = 2;
+    constexpr int         rounds      = 200;
+    constexpr std::size_t burst       = 4 * Queue::InitialBlockPoolSize;
+    constexpr std::size_t lowWater    = 8;
+    constexpr std::size_t highWater   = 16;
+
+    // 生产者和消费者一直在跑，后台线程按高水位反复归还多余的 slab
+    std::atomic<int>         done{ 0 };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < prodThreads; ++t ) {
+        threads.emplace_back( [ &queue, &done ] {
+            for ( int r = 0; r < rounds; ++r ) {
+                for ( std::size_t i = 0; i < burst; ++i ) {
+                    ASSERT_TRUE( queue.Enqueue( 1 ) );
+                }
+            }
+            done.fetch_add( 1 );
+        } );
+    }
+    std::thread maintainer( [ &queue, &done ] {
+        while ( done.load() < prodThreads ) {
+            queue.MaintainBlocks( lowWater, highWater );
+            std::this_thread::yield();
+        }
+    } );
+
+    std::size_t       count = 0;
+    const std::size_t total = prodThreads * rounds * burst;
+    int               value;
+    while ( count < total ) {
+        if ( queue.TryDequeue( value ) ) {
+            EXPECT_EQ( value, 1 );
+            ++count;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+    maintainer.join();
+    EXPECT_FALSE( queue.TryDequeue( value ) );
+
+    // 空闲后几轮维护就把多余的 slab 还掉
+    std::size_t peak = queue.GetMemoryStats().OverflowBlockBytes;
+    for ( int i = 0; i < 8; ++i ) {
+        queue.MaintainBlocks( lowWater, highWater );
+    }
+    EXPECT_LT( queue.GetMemoryStats().OverflowBlockBytes, peak );
+}
+
+TEST( ConcurrentQueueCorrectness, ArenaAllocator_ControlStructures ) {
+    using Queue = hakle::ConcurrentQueue<int, hakle::HakleArenaAllocator<int>>;
+
+    hakle::HakleArenaAllocator<int> allocator;
+    {
+        Queue queue( allocator );
+
+        // 生产者、链表节点、索引数组和哈希节点都从 allocator 的 arena 里切出
+        constexpr int prodThreads  = 4;
+        constexpr int itemsPerProd = 10000;
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < prodThreads; ++t ) {
+            threads.emplace_back( [ &queue, t ]() {
+                if ( t % 2 == 0 ) {
+                    for ( int i = 0; i < itemsPerProd; ++i ) {
+                        ASSERT_TRUE( queue.Enqueue( t * itemsPerProd + i ) );
+                    }
+                }
+                else {
+                    Queue::ProducerToken token( queue );
+                    for ( int i = 0; i < itemsPerProd; ++i ) {
+                        ASSERT_TRUE( queue.EnqueueWithToken( token, t * itemsPerProd + i ) );
+                    }
+                }
+            } );
+        }
+        for ( auto& th : threads ) {
+            th.join();
+        }
+        EXPECT_GT( allocator.GetArena()->GetBytes(), 0 );
+
+        std::uint64_t sum = 0;
+        int           value;
+        while ( queue.TryDequeue( value ) ) {
+            sum += static_cast<std::uint64_t>( value );
+        }
+        EXPECT_EQ( sum, CalcExpectedSum( prodThreads, itemsPerProd ) );
+    }
+}
+
+TEST( ConcurrentQueueCorrectness, SlabAllocator_ControlStructures ) {
+    using Queue = hakle::ConcurrentQueue<int, hakle::HakleSlabAllocator<int>>;
+
+    hakle::HakleSlabAllocator<int> allocator;
+    {
+        Queue queue( allocator );
+
+        // 生产者、链表节点、索引数组和哈希节点都从 size-class 堆的线程缓存里分配
+        constexpr int prodThreads  = 4;
+        constexpr int itemsPerProd = 10000;
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < prodThreads; ++t ) {
+            threads.emplace_back( [ &queue, t ]() {
+                if ( t % 2 == 0 ) {
+                    for ( int i = 0; i < itemsPerProd; ++i ) {
+                        ASSERT_TRUE( queue.Enqueue( t * itemsPerProd + i ) );
+                    }
+                }
+                else {
+                    Queue::ProducerToken token( queue );
+                    for ( int i = 0; i < itemsPerProd; ++i ) {
+                        ASSERT_TRUE( queue.EnqueueWithToken( token, t * itemsPerProd + i ) );
+                    }
+                }
+            } );
+        }
+        for ( auto& th : threads ) {
+            th.join();
+        }
+        EXPECT_GT( hakle::HakleSlabHeap::GetBytes(), 0 );
+
+        std::uint64_t sum = 0;
+        int           value;
+        while ( queue.TryDequeue( value ) ) {
+            sum += static_cast<std::uint64_t>( value );
+        }
+        EXPECT_EQ( sum, CalcExpectedSum( prodThreads, itemsPerProd ) );
+    }
+}
+
+TEST( ConcurrentQueueCorrectness, PmrAllocator_SynchronizedPool ) {
+    using Queue = hakle::ConcurrentQueue<int, hakle::HaklePmrAllocator<int>>;
+
+    // 上游资源计数，pool 释放时应把所有内存还回去
+    struct UpstreamResource : std::pmr::memory_resource {
+        std::atomic<std::size_t> outstanding{ 0 };
+
+        void* do_allocate( std::size_t bytes, std::size_t alignment ) override {
+            outstanding.fetch_add( bytes );
+            return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+        }
+        void do_deallocate( void* ptr, std::size_t bytes, std::size_t alignment ) override {
+            outstanding.fetch_sub( bytes );
+            std::pmr::new_delete_resource()->deallocate( ptr, bytes, alignment );
+        }
+        bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+    } upstream;
+
+    {
+        std::pmr::synchronized_pool_resource pool( &upstream );
+        hakle::HaklePmrAllocator<int>        allocator( &pool );
+        Queue                                queue( allocator );
+
+        constexpr int            prodThreads  = 4;
+        constexpr int            itemsPerProd = 10000;
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < prodThreads; ++t ) {
+            threads.emplace_back( [ &queue, t ]() {
+                if ( t % 2 == 0 ) {
+                    for ( int i = 0; i < itemsPerProd; ++i ) {
+                        ASSERT_TRUE( queue.Enqueue( t * itemsPerProd + i ) );
+                    }
+                }
+                else {
+                    Queue::ProducerToken token( queue );
+                    for ( int i = 0; i < itemsPerProd; ++i ) {
+                        ASSERT_TRUE( queue.EnqueueWithToken( token, t * itemsPerProd + i ) );
+                    }
+                }
+            } );
+        }
+        for ( auto& th : threads ) {
+            th.join();
+        }
+        EXPECT_GT( upstream.outstanding.load(), 0 );
+
+        std::uint64_t sum = 0;
+        int           value;
+        while ( queue.TryDequeue( value ) ) {
+            sum += static_cast<std::uint64_t>( value );
+        }
+        EXPECT_EQ( sum, CalcExpectedSum( prodThreads, itemsPerProd ) );
+    }
+    EXPECT_EQ( upstream.outstanding.load(), 0 );
+}
+
+struct BlockQuotaTraits : hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleAllocator<int>> {
+    static constexpr std::size_t MaxBlocksPerProducer = 2;
+};
+
+TEST( ConcurrentQueueCorrectness, BlockQuota_PerProducer ) {
+    using Queue = hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, BlockQuotaTraits>;
+    Queue queue;
+    EXPECT_TRUE( queue.SetMemoryBudget( 1 << 20 ) );
+
+    constexpr std::size_t limit = 2 * Queue::BlockSize;
+
+    // 隐式生产者最多持有 2 个 block
+    std::size_t implicitCount = 0;
+    while ( implicitCount < 4 * limit && queue.Enqueue( static_cast<int>( implicitCount ) ) ) {
+        ++implicitCount;
+    }
+    EXPECT_EQ( implicitCount, limit );
+
+    // 显式生产者同样受限，批量入队也一样
+    Queue::ProducerToken token( queue );
+    std::size_t          explicitCount = 0;
+    while ( explicitCount < 4 * limit && queue.EnqueueWithToken( token, 0 ) ) {
+        ++explicitCount;
+    }
+    EXPECT_EQ( explicitCount, limit );
+    int items[ 4 ]{};
+    EXPECT_FALSE( queue.EnqueueBulk( token, items, 4 ) );
+
+    // 其他生产者不受影响
+    std::thread other( [ &queue ] { EXPECT_TRUE( queue.Enqueue( 1 ) ); } );
+    other.join();
+
+    // 消费后 block 归还，隐式生产者又能入队
+    int         value;
+    std::size_t count = 0;
+    while ( queue.TryDequeue( value ) ) {
+        ++count;
+    }
+    EXPECT_EQ( count, implicitCount + explicitCount + 1 );
+    EXPECT_TRUE( queue.Enqueue( 2 ) );
+}
+
+struct NoPoolTraits : hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleAllocator<int>> {
+    static constexpr std::size_t InitialBlockPoolSize = 0;
+};
+
+TEST( ConcurrentQueueCorrectness, BudgetWait_BulkEnqueuers ) {
+    using Queue  = hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, NoPoolTraits>;
+    using Traits = NoPoolTraits;
+    Queue queue;
+
+    // 每个生产者攥着一个没写满的 block，还要 3 个新 block，6 块的预算只够一个批量入队先完成
+    EXPECT_TRUE( queue.SetMemoryBudget( 6 * sizeof( Traits::ImplicitBlockType ), hakle::BudgetPolicy::Wait ) );
+
+    constexpr int         prodThreads = 2;
+    constexpr int         rounds      = 2000;
+    constexpr std::size_t bulk        = 3 * Queue::BlockSize;
+
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < prodThreads; ++t ) {
+        threads.emplace_back( [ &queue, t ] {
+            std::vector<int> items( bulk, t + 1 );
+            for ( int i = 0; i < rounds; ++i ) {
+                ASSERT_TRUE( queue.EnqueueBulk( items.begin(), bulk ) );
+            }
+        } );
+    }
+
+    std::uint64_t       sum      = 0;
+    const std::uint64_t expected = static_cast<std::uint64_t>( rounds ) * bulk * ( 1 + 2 );
+    const std::size_t   total    = static_cast<std::size_t>( prodThreads ) * rounds * bulk;
+    std::size_t         count    = 0;
+    int                 value;
+    while ( count < total ) {
+        if ( queue.TryDequeue( value ) ) {
+            sum += static_cast<std::uint64_t>( value );
+            ++count;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+    EXPECT_EQ( sum, expected );
+}
+
+struct HugePageTraits : hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleHugePageAllocator<int>> {
+    static constexpr std::size_t InitialBlockPoolSize = 16384 * BlockSize;
+};
+
+TEST( ConcurrentQueueCorrectness, HugePageAllocator ) {
+    // 块池和索引数组都通过大页分配器申请
+    hakle::ConcurrentQueue<int, hakle::HakleHugePageAllocator<int>, HugePageTraits> queue;
+
+    constexpr int count = 100000;
+    for ( int i = 0; i < count; ++i ) {
+        ASSERT_TRUE( queue.Enqueue( i ) );
+    }
+    int value;
+    for ( int i = 0; i < count; ++i ) {
+        ASSERT_TRUE( queue.TryDequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+    EXPECT_FALSE( queue.TryDequeue( value ) );
+}
+
+TEST( ConcurrentQueueCorrectness, SharedBlockManager ) {
+    using Traits = hakle::ConcurrentQueueSharedTraits<int, hakle::HakleAllocator<int>>;
+    using Queue  = hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, Traits>;
+
+    Traits::ExplicitBlockManagerType explicitManager( 16 );
+    Traits::ImplicitBlockManagerType implicitManager( 16 );
+    {
+        // 多个队列共用同一组 block manager
+        std::vector<std::unique_ptr<Queue>> queues;
+        for ( int i = 0; i < 8; ++i ) {
+            queues.push_back( std::make_unique<Queue>( explicitManager.Share(), implicitManager.Share() ) );
+        }
+        EXPECT_EQ( implicitManager.GetUseCount(), 9 );
+
+        std::vector<std::thread> threads;
+        for ( int i = 0; i < 8; ++i ) {
+            threads.emplace_back( [ &queues, i ] {
+                Queue&               queue = *queues[ i ];
+                Queue::ProducerToken token( queue );
+                for ( int round = 0; round < 100; ++round ) {
+                    for ( int j = 0; j < 200; ++j ) {
+                        ASSERT_TRUE( queue.Enqueue( j ) );
+                        ASSERT_TRUE( queue.EnqueueWithToken( token, j ) );
+                    }
+                    int value;
+                    for ( int j = 0; j < 400; ++j ) {
+                        ASSERT_TRUE( queue.TryDequeue( value ) );
+                    }
+                }
+            } );
+        }
+        for ( auto& thread : threads ) {
+            thread.join();
+        }
+
+        // 共用同一个 manager 的队列之间可以整块转移
+        ASSERT_TRUE( queues[ 0 ]->Enqueue( 42 ) );
+        EXPECT_TRUE( queues[ 1 ]->SpliceFrom( *queues[ 0 ] ) );
+        int value = 0;
+        EXPECT_TRUE( queues[ 1 ]->TryDequeue( value ) );
+        EXPECT_EQ( value, 42 );
+
+        // 不同 manager 的队列拒绝转移
+        Queue alone;
+        ASSERT_TRUE( alone.Enqueue( 1 ) );
+        EXPECT_FALSE( queues[ 1 ]->SpliceFrom( alone ) );
+
+        // 统计的是共享存储
+        EXPECT_GT( implicitManager.GetCounters().CurrentBytes, 0 );
+    }
+    // 队列销毁后 manager 仍然存活，块都已归还
+    EXPECT_EQ( implicitManager.GetUseCount(), 1 );
+    EXPECT_EQ( explicitManager.GetUseCount(), 1 );
+    auto* block = implicitManager.RequisitionBlock( hakle::AllocMode::CannotAlloc );
+    EXPECT_NE( block, nullptr );
+    implicitManager.ReturnBlock( block );
+}
+
+TEST( ConcurrentQueueCorrectness, ShrinkToFit_AfterBurst ) {
+    using Queue = hakle::ConcurrentQueue<int>;
+    Queue                queue;
+    Queue::ProducerToken token( queue );
+
+    constexpr int blockSize = static_cast<int>( Queue::BlockSize );
+    constexpr int burst     = 64 * blockSize;
+
+    // 突发流量由另一个线程并发消费
+    for ( int round = 0; round < 3; ++round ) {
+        std::thread consumer( [ &queue ] {
+            int value;
+            for ( int expected = 0; expected < burst; ) {
+                if ( queue.TryDequeue( value ) ) {
+                    ASSERT_EQ( value, expected );
+                    ++expected;
+                }
+            }
+        } );
+        for ( int i = 0; i < burst; ++i ) {
+            ASSERT_TRUE( queue.EnqueueWithToken( token, i ) );
+        }
+        consumer.join();
+
+        // 空闲的 block 归还给 manager，保留 2 个
+        EXPECT_GT( queue.ShrinkToFit( token, 2 ), 0 );
+        EXPECT_EQ( queue.ShrinkToFit( token, 2 ), 0 );
+    }
+
+    // 收缩后索引仍然正确
+    for ( int i = 0; i < 10 * blockSize; ++i ) {
+        ASSERT_TRUE( queue.EnqueueWithToken( token, i ) );
+    }
+    int value;
+    for ( int i = 0; i < 10 * blockSize; ++i ) {
+        ASSERT_TRUE( queue.TryDequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+    EXPECT_FALSE( queue.TryDequeue( value ) );
+}
+
+struct IdleBlocksTraits : hakle::ConcurrentQueueDefaultTraits<int, hakle::HakleAllocator<int>> {
+    static constexpr std::size_t MaxIdleBlocksPerProducer = 4;
+};
+
+TEST( ConcurrentQueueCorrectness, ShrinkPolicy_MaxIdleBlocks ) {
+    using Queue = hakle::ConcurrentQueue<int, hakle::HakleAllocator<int>, IdleBlocksTraits>;
+    Queue                queue;
+    Queue::ProducerToken token( queue );
+
+    constexpr int blockSize = static_cast<int>( Queue::BlockSize );
+    constexpr int burst     = 32 * blockSize;
+    int           items[ blockSize ];
+    for ( int i = 0; i < blockSize; ++i ) {
+        items[ i ] = i;
+    }
+
+    for ( int i = 0; i < burst; ++i ) {
+        ASSERT_TRUE( queue.EnqueueWithToken( token, i ) );
+    }
+    int value;
+    for ( int i = 0; i < burst; ++i ) {
+        ASSERT_TRUE( queue.TryDequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+
+    // 跨过 block 边界时自动收缩到不超过 4 个空闲 block
+    ASSERT_TRUE( queue.EnqueueBulk( token, items, blockSize ) );
+    ASSERT_TRUE( queue.EnqueueWithToken( token, 0 ) );
+    EXPECT_EQ( queue.ShrinkToFit( token, 4 ), 0 );
+    for ( int i = 0; i < blockSize; ++i ) {
+        ASSERT_TRUE( queue.TryDequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+    ASSERT_TRUE( queue.TryDequeue( value ) );
+    EXPECT_FALSE( queue.TryDequeue( value ) );
+
+    // 单个 token 可以关闭策略，之后只能手动收缩
+    queue.SetShrinkPolicy( token, Queue::ExplicitProducer::NoShrink, 0 );
+    for ( int i = 0; i < burst; ++i ) {
+        ASSERT_TRUE( queue.EnqueueWithToken( token, i ) );
+    }
+    while ( queue.TryDequeue( value ) ) {
+    }
+    ASSERT_TRUE( queue.EnqueueBulk( token, items, blockSize ) );
+    EXPECT_GT( queue.ShrinkToFit( token ), 4 );
+}
+
+TEST( ConcurrentQueueCorrectness, MemoryStats_ProducersAndManagers ) {
+    using Queue = hakle::ConcurrentQueue<int>;
+    Queue queue;
+
+    constexpr int      blockSize = static_cast<int>( Queue::BlockSize );
+    constexpr int      burst     = 16 * blockSize;
+    hakle::MemoryStats empty     = queue.GetMemoryStats();
+    EXPECT_GT( empty.PoolBlockBytes, 0 );
+    EXPECT_EQ( empty.ProducerBlockBytes, 0 );
+    EXPECT_EQ( empty.FreeBlockBytes, empty.PoolBlockBytes );
+
+    {
+        Queue::ProducerToken token( queue );
+        for ( int i = 0; i < burst; ++i ) {
+            ASSERT_TRUE( queue.EnqueueWithToken( token, i ) );
+        }
+        // 隐式生产者来自另一个线程，会用到哈希表
+        std::thread( [ &queue ] {
+            for ( int i = 0; i < burst; ++i ) {
+                ASSERT_TRUE( queue.Enqueue( i ) );
+            }
+        } ).join();
+
+        hakle::MemoryStats stats = queue.GetMemoryStats();
+        EXPECT_GE( stats.ProducerBlockBytes, 32 * blockSize * sizeof( int ) );
+        EXPECT_GT( stats.IndexBytes, 0 );
+        EXPECT_GT( stats.ProducerBytes, 0 );
+        EXPECT_GT( stats.HashBytes, 0 );
+        // 空闲和借出的 block 加起来就是全部 block
+        EXPECT_EQ( stats.FreeBlockBytes + stats.ProducerBlockBytes, stats.PoolBlockBytes + stats.OverflowBlockBytes );
+        EXPECT_EQ( stats.GetTotalBytes(), stats.PoolBlockBytes + stats.OverflowBlockBytes + stats.IndexBytes + stats.ProducerBytes + stats.HashBytes );
+
+        int value;
+        while ( queue.TryDequeue( value ) ) {
+        }
+        // 隐式生产者出队后马上归还 block，显式生产者收缩后归还
+        queue.ShrinkToFit( token );
+        stats = queue.GetMemoryStats();
+        EXPECT_LE( stats.ProducerBlockBytes, 2 * sizeof( Queue::ExplicitProducer::BlockType ) );
+        EXPECT_EQ( stats.FreeBlockBytes + stats.ProducerBlockBytes, stats.PoolBlockBytes + stats.OverflowBlockBytes );
+    }
+}
+
+TEST( ConcurrentQueueCorrectness, RealTimeProfile_NoRuntimeAllocation ) {
+    constexpr std::size_t perProducer = 256;
+    using Traits                      = hakle::ConcurrentQueueRealTimeTraits<int, perProducer, 2, 2>;
+    using Queue                       = hakle::ConcurrentQueue<int, hakle::HaklePinnedAllocator<int>, Traits>;
+    Queue queue;
+
+    // 构造时就准备好了所有生产者、索引数组和 block
+    hakle::MemoryStats reserved = queue.GetMemoryStats();
+    EXPECT_EQ( reserved.PoolBlockBytes, 2 * Traits::BlocksPerProducer * ( sizeof( Queue::ExplicitProducer::BlockType ) + sizeof( Queue::ImplicitProducer::BlockType ) ) );
+    EXPECT_EQ( reserved.OverflowBlockBytes, 0 );
+    EXPECT_GT( reserved.IndexBytes, 0 );
+
+    std::size_t explicitCount = 0;
+    {
+        Queue::ProducerToken first( queue );
+        Queue::ProducerToken second( queue );
+        // 第三个 token 没有预留的生产者，入队失败而不是新建
+        Queue::ProducerToken third( queue );
+        EXPECT_FALSE( queue.TryEnqueue( third, 0 ) );
+
+        for ( std::size_t i = 0; i < perProducer; ++i ) {
+            ASSERT_TRUE( queue.TryEnqueue( first, static_cast<int>( i ) ) );
+            ASSERT_TRUE( queue.TryEnqueue( second, static_cast<int>( i ) ) );
+        }
+        explicitCount = 2 * perProducer;
+        // 超出预留容量后失败
+        while ( queue.TryEnqueue( first, 0 ) ) {
+            ++explicitCount;
+        }
+        EXPECT_LE( explicitCount, 2 * perProducer + Traits::BlocksPerProducer * Queue::BlockSize );
+    }
+
+    // 三个线程同时入队，只有两个能拿到预留的隐式生产者
+    constexpr int            threadCount = 3;
+    std::atomic<int>         arrived{ 0 };
+    std::atomic<int>         succeeded{ 0 };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < threadCount; ++t ) {
+        threads.emplace_back( [ & ] {
+            if ( queue.TryEnqueue( 0 ) ) {
+                for ( std::size_t i = 1; i < perProducer; ++i ) {
+                    ASSERT_TRUE( queue.TryEnqueue( static_cast<int>( i ) ) );
+                }
+                succeeded.fetch_add( 1 );
+            }
+            // 等所有线程都试过再退出，避免线程 id 被复用
+            arrived.fetch_add( 1 );
+            while ( arrived.load() < threadCount ) {
+                std::this_thread::yield();
+            }
+        } );
+    }
+    for ( auto& thread : threads ) {
+        thread.join();
+    }
+    EXPECT_EQ( succeeded.load(), 2 );
+
+    std::size_t count = 0;
+    int         value;
+    while ( queue.TryDequeue( value ) ) {
+        ++count;
+    }
+    EXPECT_EQ( count, explicitCount + 2 * perProducer );
+
+    // 运行期间没有任何新的分配
+    hakle::MemoryStats after = queue.GetMemoryStats();
+    EXPECT_EQ( after.GetTotalBytes(), reserved.GetTotalBytes() );
+    EXPECT_EQ( after.OverflowBlockBytes, 0 );
+    EXPECT_EQ( after.HashBytes, reserved.HashBytes );
 }
 
 // 还可以继续加：
@@ -402,6 +402,9 @@ TEST( ConcurrentQueueCorrectness, ProducerToken_Enq_TryDequeueFromProducer ) {
     EXPECT_EQ( produced.load(), totalItems );
     EXPECT_EQ( consumed.load(), totalItems );
     EXPECT_EQ( sum.load(), expectedSum );
+
+    // token 必须在所属队列之前析构
+    prodTokens.clear();
 }
 
 // ---------------------------------------------------------------------
@@ -550,6 +553,9 @@ TEST( ConcurrentQueueCorrectness, ProducerTokenBulkEnq_ConsumerTokenBulkDeq ) {
     EXPECT_EQ( produced.load(), totalItems );
     EXPECT_EQ( consumed.load(), totalItems );
     EXPECT_EQ( sum.load(), expectedSum );
+
+    // token 必须在所属队列之前析构
+    prodTokens.clear();
 }
 
 // ---------------------------------------------------------------------
@@ -938,6 +944,9 @@ TEST( ConcurrentQueueCorrectness, ProducerTokenEnq_ConsumerTokenDeq_SingleElemen
     EXPECT_EQ( produced.load(), totalItems );
     EXPECT_EQ( consumed.load(), totalItems );
     EXPECT_EQ( sum.load(), expectedSum );
+
+    // token 必须在所属队列之前析构
+    prodTokens.clear();
 }
 
 // 还可以继续加：
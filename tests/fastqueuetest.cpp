@@ -29,6 +29,30 @@ using TestCounterQueue = FastQueue<int, kBlockSize, HakleAllocator<int>, TestCou
 // 辅助：等待一段时间让操作完成
 void SleepFor( std::int64_t ms ) { std::this_thread::sleep_for( std::chrono::milliseconds( ms ) ); }
 
+// 统计队列自身（索引数组）占用的字节数，block 由 manager 分配，不计入
+std::atomic<std::size_t> g_LiveBytes{ 0 };
+
+template <class Tp>
+struct CountingAllocator : HakleAllocator<Tp> {
+    using typename HakleAllocator<Tp>::Pointer;
+    using typename HakleAllocator<Tp>::SizeType;
+
+    CountingAllocator() noexcept = default;
+    template <class Up>
+    explicit CountingAllocator( const CountingAllocator<Up>& ) noexcept {}
+
+    Pointer Allocate() { return Allocate( 1 ); }
+    Pointer Allocate( SizeType n ) {
+        g_LiveBytes += n * sizeof( Tp );
+        return HakleAllocator<Tp>::Allocate( n );
+    }
+    void Deallocate( Pointer p ) noexcept { Deallocate( p, 1 ); }
+    void Deallocate( Pointer p, SizeType n ) noexcept {
+        g_LiveBytes -= n * sizeof( Tp );
+        HakleAllocator<Tp>::Deallocate( p, n );
+    }
+};
+
 // === 测试 1: 基本 Enqueue/Dequeue ===
 TEST( FastQueueTest, BasicEnqueueDequeue ) {
     TestFlagsBlockManager blockManager( POOL_SIZE );
@@ -366,6 +390,147 @@ TEST( FastQueueTest, MultiConsumerStressTestWithException ) {
 }
 
 // test/queue_test.cpp 最后加上：
+// === 测试: 内联存储的第一个 block 不归还给 manager ===
+TEST( FastQueueTest, InlineStorage ) {
+    TestFlagsBlockManager          blockManager( 0 );
+    TestFlagsQueue::InlineStorage<4> storage;
+    TestFlagsQueue                 queue( storage, &blockManager );
+    using AllocMode = TestFlagsQueue::AllocMode;
+
+    // 内联 block 足以容纳第一个 block 的元素，不需要分配
+    for ( int i = 0; i < static_cast<int>( kBlockSize ); ++i ) {
+        EXPECT_TRUE( queue.Enqueue<AllocMode::CannotAlloc>( i ) );
+    }
+    EXPECT_FALSE( queue.Enqueue<AllocMode::CannotAlloc>( -1 ) );
+
+    int value = 0;
+    for ( int i = 0; i < static_cast<int>( kBlockSize ); ++i ) {
+        EXPECT_TRUE( queue.Dequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+
+    // 内联 block 被重复使用
+    EXPECT_TRUE( queue.Enqueue<AllocMode::CannotAlloc>( 42 ) );
+    for ( int i = 0; i < 100; ++i ) {
+        EXPECT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( i ) );
+    }
+    EXPECT_TRUE( queue.Dequeue( value ) );
+    EXPECT_EQ( value, 42 );
+    for ( int i = 0; i < 100; ++i ) {
+        EXPECT_TRUE( queue.Dequeue( value ) );
+        EXPECT_EQ( value, i );
+    }
+    EXPECT_FALSE( queue.Dequeue( value ) );
+}
+
+TEST( FastQueueTest, ReclaimIndexArrays ) {
+    using Queue     = FastQueue<int, kBlockSize, CountingAllocator<int>>;
+    using AllocMode = Queue::AllocMode;
+    constexpr std::size_t blockCount = 1000;
+    constexpr std::size_t entryBytes = sizeof( std::size_t ) + sizeof( void* );
+
+    TestFlagsBlockManager blockManager( POOL_SIZE );
+    {
+        Queue queue( 2, &blockManager );
+        // 没有消费者时，索引扩容后旧数组立即释放，只剩当前的 1024 项
+        for ( std::size_t i = 0; i < blockCount * kBlockSize; ++i ) {
+            ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( static_cast<int>( i ) ) );
+        }
+        EXPECT_LE( g_LiveBytes.load(), 1024 * entryBytes + 64 );
+
+        int value = 0;
+        for ( std::size_t i = 0; i < blockCount * kBlockSize; ++i ) {
+            ASSERT_TRUE( queue.Dequeue( value ) );
+            EXPECT_EQ( value, static_cast<int>( i ) );
+        }
+    }
+    EXPECT_EQ( g_LiveBytes.load(), 0u );
+
+    {
+        // 消费者并发读取索引时扩容，旧数组延后到没有读者时释放
+        Queue                    queue( 2, &blockManager );
+        constexpr int            N = static_cast<int>( blockCount * kBlockSize );
+        std::atomic<int>         count{ 0 };
+        std::atomic<long long>   sum{ 0 };
+        std::vector<std::thread> consumers;
+        for ( int c = 0; c < 4; ++c ) {
+            consumers.emplace_back( [ &queue, &count, &sum ] {
+                int value = 0;
+                while ( count.load() < N ) {
+                    if ( queue.Dequeue( value ) ) {
+                        sum += value;
+                        ++count;
+                    }
+                }
+            } );
+        }
+        for ( int i = 0; i < N; ++i ) {
+            ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( i ) );
+        }
+        for ( auto& t : consumers ) {
+            t.join();
+        }
+        EXPECT_EQ( sum.load(), static_cast<long long>( N ) * ( N - 1 ) / 2 );
+
+        // 下一次跨 block 入队时回收
+        for ( std::size_t i = 0; i < kBlockSize; ++i ) {
+            ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( 0 ) );
+        }
+        EXPECT_LE( g_LiveBytes.load(), 1024 * entryBytes + 64 );
+    }
+    EXPECT_EQ( g_LiveBytes.load(), 0u );
+}
+
+TEST( FastQueueTest, ReclaimIndexArraysWhileConsuming ) {
+    using Queue     = FastQueue<int, kBlockSize, CountingAllocator<int>>;
+    using AllocMode = Queue::AllocMode;
+    constexpr std::size_t blockCount = 1000;
+    constexpr std::size_t entryBytes = sizeof( std::size_t ) + sizeof( void* );
+
+    TestFlagsBlockManager blockManager( POOL_SIZE );
+    {
+        // 消费者一直在读索引，不用等它们停下，旧数组在之后的 block 边界就能回收
+        Queue                    queue( 2, &blockManager );
+        std::atomic<bool>        stop{ false };
+        std::atomic<std::size_t> count{ 0 };
+        std::vector<std::thread> consumers;
+        for ( int c = 0; c < 4; ++c ) {
+            consumers.emplace_back( [ &queue, &stop, &count ] {
+                int value = 0;
+                while ( !stop.load() ) {
+                    if ( queue.Dequeue( value ) ) {
+                        ++count;
+                    }
+                }
+            } );
+        }
+
+        std::size_t enqueued = 0;
+        for ( ; enqueued < blockCount * kBlockSize; ++enqueued ) {
+            ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( 1 ) );
+        }
+        bool reclaimed = false;
+        for ( int round = 0; round < 10000 && !reclaimed; ++round ) {
+            for ( std::size_t i = 0; i < kBlockSize; ++i, ++enqueued ) {
+                ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( 1 ) );
+            }
+            reclaimed = g_LiveBytes.load() <= 1024 * entryBytes + 64;
+        }
+        stop.store( true );
+        for ( auto& t : consumers ) {
+            t.join();
+        }
+        EXPECT_TRUE( reclaimed );
+
+        int value = 0;
+        while ( queue.Dequeue( value ) ) {
+            ++count;
+        }
+        EXPECT_EQ( count.load(), enqueued );
+    }
+    EXPECT_EQ( g_LiveBytes.load(), 0u );
+}
+
 int main( int argc, char** argv ) {
     ::testing::InitGoogleTest( &argc, argv );
 
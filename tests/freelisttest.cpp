@@ -264,6 +264,463 @@ TEST_F( FreeListTest, TypeConstraints ) {
 }
 
 // 主函数
+// 测试一次 CAS 取出一串节点
+TEST_F( FreeListTest, GetChain ) {
+    constexpr int TOTAL_NODES = 10;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        list->Add( new TestNode( i ) );
+    }
+
+    std::size_t count = 0;
+    TestNode*   chain = list->TryGetChain( 4, count );
+    ASSERT_NE( chain, nullptr );
+    EXPECT_EQ( count, 4 );
+
+    std::size_t walked = 0;
+    for ( TestNode* node = chain; node != nullptr; node = node->FreeListNext.load() ) {
+        ++walked;
+    }
+    EXPECT_EQ( walked, 4 );
+
+    // 剩下的不足时，取出全部
+    TestNode* rest = list->TryGetChain( 100, count );
+    ASSERT_NE( rest, nullptr );
+    EXPECT_EQ( count, TOTAL_NODES - 4 );
+    EXPECT_EQ( list->TryGetChain( 1, count ), nullptr );
+    EXPECT_EQ( count, 0 );
+
+    auto AddBack = [ this ]( TestNode* node ) {
+        while ( node != nullptr ) {
+            TestNode* next = node->FreeListNext.load();
+            list->Add( node );
+            node = next;
+        }
+    };
+    AddBack( chain );
+    AddBack( rest );
+
+    int get_count = 0;
+    while ( list->TryGet() != nullptr ) {
+        ++get_count;
+    }
+    EXPECT_EQ( get_count, TOTAL_NODES );
+}
+
+// 多线程同时取链、取单个节点和放回，节点不能被同时拿到两次
+TEST_F( FreeListTest, ConcurrentGetChain ) {
+    constexpr int NUM_THREADS = 4;
+    constexpr int TOTAL_NODES = 256;
+    constexpr int ITERATIONS  = 20000;
+
+    std::vector<TestNode*> nodes;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        nodes.push_back( new TestNode( i ) );
+        list->Add( nodes.back() );
+    }
+
+    std::atomic<bool>        duplicated{ false };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ this, t, &duplicated ]() {
+            std::vector<TestNode*> taken;
+            for ( int i = 0; i < ITERATIONS; ++i ) {
+                taken.clear();
+                if ( ( i + t ) % 2 == 0 ) {
+                    std::size_t count = 0;
+                    for ( TestNode* node = list->TryGetChain( 1 + i % 8, count ); node != nullptr; node = node->FreeListNext.load() ) {
+                        taken.push_back( node );
+                    }
+                }
+                else if ( TestNode* node = list->TryGet() ) {
+                    taken.push_back( node );
+                }
+
+                for ( TestNode* node : taken ) {
+                    if ( node->in_use.exchange( true ) ) {
+                        duplicated.store( true );
+                    }
+                }
+                for ( TestNode* node : taken ) {
+                    node->in_use.store( false );
+                    list->Add( node );
+                }
+            }
+        } );
+    }
+
+    for ( auto& th : threads )
+        th.join();
+
+    EXPECT_FALSE( duplicated.load() );
+
+    int get_count = 0;
+    while ( list->TryGet() != nullptr ) {
+        ++get_count;
+    }
+    EXPECT_EQ( get_count, TOTAL_NODES );
+
+    for ( TestNode* node : nodes ) {
+        list->Add( node );
+    }
+}
+
+// 测试一次 CAS 放回一串节点
+TEST_F( FreeListTest, AddChain ) {
+    constexpr int TOTAL_NODES = 10;
+    TestNode*     chain       = nullptr;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        auto* node = new TestNode( i );
+        node->FreeListNext.store( chain );
+        chain = node;
+    }
+    list->AddChain( chain );
+    list->AddChain( nullptr );
+
+    // 链和单个放回的节点混在一起
+    std::size_t count = 0;
+    TestNode*   part  = list->TryGetChain( 3, count );
+    EXPECT_EQ( count, 3 );
+    list->Add( new TestNode( TOTAL_NODES ) );
+    list->AddChain( part );
+
+    int get_count = 0;
+    while ( list->TryGet() != nullptr ) {
+        ++get_count;
+    }
+    EXPECT_EQ( get_count, TOTAL_NODES + 1 );
+}
+
+// 多线程同时放回链、取链和取单个节点，节点不能丢失也不能被同时拿到两次
+TEST_F( FreeListTest, ConcurrentAddChain ) {
+    constexpr int NUM_THREADS = 4;
+    constexpr int TOTAL_NODES = 256;
+    constexpr int ITERATIONS  = 20000;
+
+    std::vector<TestNode*> nodes;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        nodes.push_back( new TestNode( i ) );
+        list->Add( nodes.back() );
+    }
+
+    std::atomic<bool>        duplicated{ false };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ this, t, &duplicated ]() {
+            std::vector<TestNode*> taken;
+            for ( int i = 0; i < ITERATIONS; ++i ) {
+                taken.clear();
+                for ( int k = 0; k < 1 + ( i + t ) % 6; ++k ) {
+                    if ( TestNode* node = list->TryGet() ) {
+                        taken.push_back( node );
+                    }
+                }
+                std::size_t count = 0;
+                for ( TestNode* node = list->TryGetChain( 1 + i % 4, count ); node != nullptr; node = node->FreeListNext.load() ) {
+                    taken.push_back( node );
+                }
+
+                for ( TestNode* node : taken ) {
+                    if ( node->in_use.exchange( true ) ) {
+                        duplicated.store( true );
+                    }
+                }
+                TestNode* chain = nullptr;
+                for ( TestNode* node : taken ) {
+                    node->in_use.store( false );
+                    node->FreeListNext.store( chain );
+                    chain = node;
+                }
+                list->AddChain( chain );
+            }
+        } );
+    }
+
+    for ( auto& th : threads )
+        th.join();
+
+    EXPECT_FALSE( duplicated.load() );
+
+    int get_count = 0;
+    while ( list->TryGet() != nullptr ) {
+        ++get_count;
+    }
+    EXPECT_EQ( get_count, TOTAL_NODES );
+
+    for ( TestNode* node : nodes ) {
+        list->Add( node );
+    }
+}
+
+#if HAKLE_HAS_TAGGED_FREELIST
+// 单字 tagged 头的 FreeList：基本的放回、取链和析构时回收
+TEST( TaggedFreeListTest, AddAndGetChain ) {
+    constexpr int TOTAL_NODES = 10;
+
+    FreeList_Tagged<TestNode> tagged;
+    EXPECT_EQ( tagged.TryGet(), nullptr );
+
+    TestNode* chain = nullptr;
+    for ( int i = 0; i < TOTAL_NODES - 1; ++i ) {
+        auto* node = new TestNode( i );
+        node->FreeListNext.store( chain );
+        chain = node;
+    }
+    tagged.AddChain( chain );
+    tagged.Add( new TestNode( TOTAL_NODES - 1 ) );
+    EXPECT_EQ( tagged.EstimateSize( 100 ), TOTAL_NODES );
+    EXPECT_EQ( tagged.EstimateSize( 3 ), 3 );
+
+    // 后放回的先取出
+    TestNode* node = tagged.TryGet();
+    ASSERT_NE( node, nullptr );
+    EXPECT_EQ( node->value, TOTAL_NODES - 1 );
+
+    std::size_t count = 0;
+    TestNode*   part  = tagged.TryGetChain( 4, count );
+    EXPECT_EQ( count, 4 );
+    std::size_t walked = 0;
+    for ( TestNode* current = part; current != nullptr; current = current->FreeListNext.load() ) {
+        ++walked;
+    }
+    EXPECT_EQ( walked, 4 );
+    EXPECT_EQ( tagged.EstimateSize( 100 ), TOTAL_NODES - 5 );
+
+    // 剩下的节点由析构回收
+    tagged.Add( node );
+    tagged.AddChain( part );
+    EXPECT_EQ( tagged.EstimateSize( 100 ), TOTAL_NODES );
+}
+
+// 和 ConcurrentAddChain 相同的压力，tag 保证节点不会被同时拿到两次
+TEST( TaggedFreeListTest, ConcurrentAddAndGetChain ) {
+    constexpr int NUM_THREADS = 4;
+    constexpr int TOTAL_NODES = 256;
+    constexpr int ITERATIONS  = 20000;
+
+    FreeList_Tagged<TestNode> tagged;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        tagged.Add( new TestNode( i ) );
+    }
+
+    std::atomic<bool>        duplicated{ false };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ &tagged, t, &duplicated ]() {
+            std::vector<TestNode*> taken;
+            for ( int i = 0; i < ITERATIONS; ++i ) {
+                taken.clear();
+                for ( int k = 0; k < 1 + ( i + t ) % 6; ++k ) {
+                    if ( TestNode* node = tagged.TryGet() ) {
+                        taken.push_back( node );
+                    }
+                }
+                std::size_t count = 0;
+                for ( TestNode* node = tagged.TryGetChain( 1 + i % 4, count ); node != nullptr; node = node->FreeListNext.load() ) {
+                    taken.push_back( node );
+                }
+
+                for ( TestNode* node : taken ) {
+                    if ( node->in_use.exchange( true ) ) {
+                        duplicated.store( true );
+                    }
+                }
+                TestNode* chain = nullptr;
+                for ( TestNode* node : taken ) {
+                    node->in_use.store( false );
+                    if ( i % 2 == 0 ) {
+                        tagged.Add( node );
+                    }
+                    else {
+                        node->FreeListNext.store( chain );
+                        chain = node;
+                    }
+                }
+                tagged.AddChain( chain );
+            }
+        } );
+    }
+
+    for ( auto& th : threads )
+        th.join();
+
+    EXPECT_FALSE( duplicated.load() );
+    EXPECT_EQ( tagged.EstimateSize( TOTAL_NODES + 1 ), TOTAL_NODES );
+}
+
+// 超出低 48 位的地址（5 级页表下的高地址）放不进头部，release 下 Add 也直接终止，而不是截断指针
+TEST( TaggedFreeListTest, RejectsHighAddress ) {
+    auto* node = new TestNode( 0 );
+    auto* far  = reinterpret_cast<TestNode*>( ( std::uintptr_t{ 1 } << 56 ) | reinterpret_cast<std::uintptr_t>( node ) );
+    EXPECT_TRUE( FreeList_Tagged<TestNode>::CanHold( node ) );
+    EXPECT_FALSE( FreeList_Tagged<TestNode>::CanHold( far ) );
+
+    FreeList_Tagged<TestNode> tagged;
+    EXPECT_DEATH( tagged.Add( far ), "" );
+    node->FreeListNext.store( far );
+    EXPECT_DEATH( tagged.AddChain( node ), "" );
+    node->FreeListNext.store( nullptr );
+    tagged.Add( node );
+    EXPECT_EQ( tagged.EstimateSize( 100 ), 1 );
+}
+#endif
+
+// 消除槽：没有线程来取时，Add 的报价撤回到内层链表，槽里不留节点
+TEST( EliminationFreeListTest, OfferFallsBackToInner ) {
+    constexpr int TOTAL_NODES = 8;
+
+    EliminationFreeList<TestNode> elimination;
+    EXPECT_EQ( elimination.TryGet(), nullptr );
+
+    auto* first = new TestNode( 0 );
+    elimination.Add( first );
+    EXPECT_EQ( elimination.EstimateSize( 100 ), 1 );
+    EXPECT_EQ( elimination.TryGet(), first );
+    EXPECT_EQ( elimination.TryGet(), nullptr );
+
+    // 全部进了内层链表，取链时一次都能拿到
+    elimination.Add( first );
+    for ( int i = 1; i < TOTAL_NODES; ++i ) {
+        elimination.Add( new TestNode( i ) );
+    }
+    EXPECT_EQ( elimination.EstimateSize( 100 ), TOTAL_NODES );
+
+    std::size_t count = 0;
+    TestNode*   chain = elimination.TryGetChain( 100, count );
+    EXPECT_EQ( count, TOTAL_NODES );
+    std::size_t walked = 0;
+    for ( TestNode* node = chain; node != nullptr; node = node->FreeListNext.load() ) {
+        ++walked;
+    }
+    EXPECT_EQ( walked, TOTAL_NODES );
+    EXPECT_EQ( elimination.EstimateSize( 100 ), 0 );
+
+    // 放回去由析构回收
+    elimination.AddChain( chain );
+}
+
+// 一个线程只放回、一个线程只取，节点经槽交换或经内层链表都只交给一个线程
+TEST( EliminationFreeListTest, HandOffBetweenThreads ) {
+    constexpr int TOTAL_NODES = 16;
+    constexpr int ITERATIONS  = 20000;
+
+    EliminationFreeList<TestNode, HakleAllocator<TestNode>, FreeList<TestNode>, 1> elimination;
+    std::vector<TestNode*>                                                         nodes;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        nodes.push_back( new TestNode( i ) );
+    }
+
+    // 取到的节点经 handed 交回放回线程，形成一个闭环
+    std::atomic<int>        received{ 0 };
+    std::atomic<TestNode*>  handed[ TOTAL_NODES ]{};
+    std::atomic<bool>       duplicated{ false };
+    std::thread             taker( [ & ] {
+        while ( received.load() < ITERATIONS ) {
+            TestNode* node = elimination.TryGet();
+            if ( node == nullptr ) {
+                std::this_thread::yield();
+                continue;
+            }
+            if ( node->in_use.exchange( true ) ) {
+                duplicated.store( true );
+            }
+            node->in_use.store( false );
+            handed[ node->value ].store( node );
+            received.fetch_add( 1 );
+        }
+    } );
+
+    int added = 0;
+    for ( TestNode* node : nodes ) {
+        elimination.Add( node );
+        ++added;
+    }
+    while ( received.load() < ITERATIONS ) {
+        for ( auto& slot : handed ) {
+            if ( TestNode* node = slot.exchange( nullptr ) ) {
+                if ( added < ITERATIONS ) {
+                    elimination.Add( node );
+                    ++added;
+                }
+                else {
+                    slot.store( node );
+                }
+            }
+        }
+        std::this_thread::yield();
+    }
+    taker.join();
+    EXPECT_FALSE( duplicated.load() );
+
+    // 所有节点要么在交还槽里，要么还在链表里，一个不少
+    std::size_t count = 0;
+    for ( auto& slot : handed ) {
+        if ( TestNode* node = slot.exchange( nullptr ) ) {
+            elimination.Add( node );
+        }
+    }
+    TestNode* chain = elimination.TryGetChain( TOTAL_NODES + 1, count );
+    EXPECT_EQ( count, TOTAL_NODES );
+    elimination.AddChain( chain );
+}
+
+// 多线程同时放回、取单个和取链，节点既不能丢失也不能被同时拿到两次
+TEST( EliminationFreeListTest, ConcurrentAddAndGet ) {
+    constexpr int NUM_THREADS = 8;
+    constexpr int TOTAL_NODES = 64;
+    constexpr int ITERATIONS  = 20000;
+
+    EliminationFreeList<TestNode> elimination;
+    for ( int i = 0; i < TOTAL_NODES; ++i ) {
+        elimination.Add( new TestNode( i ) );
+    }
+
+    std::atomic<bool>        duplicated{ false };
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < NUM_THREADS; ++t ) {
+        threads.emplace_back( [ &elimination, t, &duplicated ]() {
+            std::vector<TestNode*> taken;
+            for ( int i = 0; i < ITERATIONS; ++i ) {
+                taken.clear();
+                if ( ( i + t ) % 3 == 0 ) {
+                    std::size_t count = 0;
+                    for ( TestNode* node = elimination.TryGetChain( 1 + i % 4, count ); node != nullptr; node = node->FreeListNext.load() ) {
+                        taken.push_back( node );
+                    }
+                }
+                else if ( TestNode* node = elimination.TryGet() ) {
+                    taken.push_back( node );
+                }
+
+                for ( TestNode* node : taken ) {
+                    if ( node->in_use.exchange( true ) ) {
+                        duplicated.store( true );
+                    }
+                }
+                for ( TestNode* node : taken ) {
+                    node->in_use.store( false );
+                    elimination.Add( node );
+                }
+            }
+        } );
+    }
+
+    for ( auto& th : threads )
+        th.join();
+
+    EXPECT_FALSE( duplicated.load() );
+
+    int                    get_count = 0;
+    std::vector<TestNode*> all;
+    while ( TestNode* node = elimination.TryGet() ) {
+        all.push_back( node );
+        ++get_count;
+    }
+    EXPECT_EQ( get_count, TOTAL_NODES );
+    for ( TestNode* node : all ) {
+        elimination.Add( node );
+    }
+}
+
 int main( int argc, char** argv ) {
     ::testing::InitGoogleTest( &argc, argv );
     return RUN_ALL_TESTS();
@@ -182,6 +182,112 @@ TEST_F( HashTableTest, HashTableResize ) {
     EXPECT_EQ( table->GetSize(), 10 );
 }
 
+// 用 size-class 分配器的哈希表，多线程插入触发扩容
+TEST_F( HashTableTest, SlabAllocatorResize ) {
+    using SlabHashTable = HashTable<uint32_t, uint32_t, 8, core::Hash<uint32_t>, HakleSlabAllocator<Pair<std::atomic<uint32_t>, std::atomic<uint32_t>>>>;
+    SlabHashTable slabTable( UINT32_MAX );
+
+    const int                num_threads = 4;
+    const uint32_t           per_thread  = 500;
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t ) {
+        threads.emplace_back( [ &slabTable, t, per_thread ]() {
+            for ( uint32_t i = 0; i < per_thread; ++i ) {
+                uint32_t key      = static_cast<uint32_t>( t ) * per_thread + i;
+                uint32_t outValue = 0;
+                EXPECT_EQ( slabTable.GetOrAdd( key, outValue, key + 1 ), HashTableStatus::ADD_SUCCESS );
+            }
+        } );
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+
+    EXPECT_EQ( slabTable.GetSize(), num_threads * per_thread );
+    for ( uint32_t key = 0; key < num_threads * per_thread; ++key ) {
+        uint32_t outValue = 0;
+        EXPECT_TRUE( slabTable.Get( key, outValue ) );
+        EXPECT_EQ( outValue, key + 1 );
+    }
+}
+
+// 泄漏计数按线程分片，跨线程释放时单个分片会变负，合并后的总数仍然准确
+TEST_F( HashTableTest, ShardedLeakCounters ) {
+    struct Tracked {
+        uint64_t value;
+    };
+    using TrackedAllocator = HakleAllocator<Tracked>;
+
+    const int                num_threads = 8;
+    const int                per_thread  = 1000;
+    std::vector<Tracked*>    handoff( num_threads * per_thread );
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < num_threads; ++t ) {
+        threads.emplace_back( [ &handoff, t, per_thread ]() {
+            TrackedAllocator allocator;
+            for ( int i = 0; i < per_thread; ++i ) {
+                Tracked* ptr = allocator.Allocate();
+                allocator.Construct( ptr, Tracked{ static_cast<uint64_t>( i ) } );
+                handoff[ t * per_thread + i ] = ptr;
+            }
+        } );
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+    EXPECT_EQ( TrackedAllocator::GetLiveAllocations(), num_threads * per_thread );
+    EXPECT_EQ( TrackedAllocator::GetLiveConstructions(), num_threads * per_thread );
+
+    // 换一批线程释放别人分配的对象
+    threads.clear();
+    for ( int t = 0; t < num_threads; ++t ) {
+        threads.emplace_back( [ &handoff, t, num_threads, per_thread ]() {
+            TrackedAllocator allocator;
+            for ( int i = 0; i < per_thread; ++i ) {
+                Tracked* ptr = handoff[ ( num_threads - 1 - t ) * per_thread + i ];
+                allocator.Destroy( ptr );
+                allocator.Deallocate( ptr );
+            }
+        } );
+    }
+    for ( auto& th : threads ) {
+        th.join();
+    }
+    EXPECT_EQ( TrackedAllocator::GetLiveAllocations(), 0 );
+    EXPECT_EQ( TrackedAllocator::GetLiveConstructions(), 0 );
+
+    // 哈希表析构后节点全部归还
+    using NodeAllocator = HakleAllocator<Pair<std::atomic<uint32_t>, std::atomic<uint32_t>>>;
+    const auto before   = NodeAllocator::GetLiveAllocations();
+    {
+        TestHashTable local( UINT32_MAX );
+        for ( uint32_t i = 0; i < 100; ++i ) {
+            uint32_t outValue = 0;
+            local.GetOrAdd( i, outValue, i );
+        }
+        EXPECT_GT( NodeAllocator::GetLiveAllocations(), before );
+    }
+    EXPECT_EQ( NodeAllocator::GetLiveAllocations(), before );
+}
+
+// 测试内存统计：扩容后旧节点仍然计入，移动后归新表
+TEST_F( HashTableTest, MemoryStats ) {
+    using Entry          = Pair<std::atomic<uint32_t>, std::atomic<uint32_t>>;
+    const size_t initial = table->GetMemoryStats().HashBytes;
+    EXPECT_GT( initial, 8 * sizeof( Entry ) );
+
+    for ( uint32_t i = 0; i < 100; ++i ) {
+        uint32_t outValue = 0;
+        table->GetOrAdd( i, outValue, i );
+    }
+    const size_t grown = table->GetMemoryStats().HashBytes;
+    EXPECT_GT( grown, initial + 100 * sizeof( Entry ) );
+
+    TestHashTable moved( std::move( *table ) );
+    EXPECT_EQ( moved.GetMemoryStats().HashBytes, grown );
+    EXPECT_EQ( table->GetMemoryStats().HashBytes, 0 );
+}
+
 // 高并发插入测试 - 大量线程同时插入不同的键
 TEST_F( HashTableTest, HighConcurrencyInsertDifferentKeys ) {
     const int        num_threads    = 16;
@@ -0,0 +1,105 @@
+#include "ConcurrentQueue/ConcurrentQueue.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// 基本配置：每轮入队 kBatch 个元素，再全部出队，每次操作单独计时
+constexpr std::size_t kBatch = 1024;
+
+using DefaultQueue   = hakle::ConcurrentQueue<int>;
+using RealTimeTraits = hakle::ConcurrentQueueRealTimeTraits<int, kBatch, 1, 1>;
+using RealTimeQueue  = hakle::ConcurrentQueue<int, hakle::HaklePinnedAllocator<int>, RealTimeTraits>;
+
+// 1ns 一格的直方图，开始计时前就分配好，记录时不再分配
+struct LatencyHistogram {
+    static constexpr std::size_t kBuckets = 1 << 16;
+
+    std::vector<std::uint64_t> counts = std::vector<std::uint64_t>( kBuckets );
+    std::uint64_t              total  = 0;
+    std::int64_t               max    = 0;
+
+    void Add( std::int64_t nanos ) {
+        ++counts[ nanos < static_cast<std::int64_t>( kBuckets ) ? static_cast<std::size_t>( nanos ) : kBuckets - 1 ];
+        ++total;
+        max = nanos > max ? nanos : max;
+    }
+
+    std::int64_t Percentile( double p ) const {
+        std::uint64_t target = static_cast<std::uint64_t>( static_cast<double>( total ) * p );
+        std::uint64_t seen   = 0;
+        for ( std::size_t i = 0; i < kBuckets; ++i ) {
+            seen += counts[ i ];
+            if ( seen > target ) {
+                return static_cast<std::int64_t>( i );
+            }
+        }
+        return max;
+    }
+
+    void Report( benchmark::State& state ) const {
+        state.counters[ "p50_ns" ]   = static_cast<double>( Percentile( 0.5 ) );
+        state.counters[ "p99.9_ns" ] = static_cast<double>( Percentile( 0.999 ) );
+        state.counters[ "max_ns" ]   = static_cast<double>( max );
+    }
+};
+
+template <class F>
+static void Timed( LatencyHistogram& histogram, F&& op ) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok    = op();
+    auto end   = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize( ok );
+    histogram.Add( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+}
+
+// 默认配置：block、索引数组按需分配，第一次用到时还要缺页
+static void BM_DefaultEnqueueLatency( benchmark::State& state ) {
+    LatencyHistogram histogram;
+    DefaultQueue     queue;
+    {
+        DefaultQueue::ProducerToken token( queue );
+        int                         value = 0;
+        for ( auto _ : state ) {
+            for ( std::size_t i = 0; i < kBatch; ++i ) {
+                Timed( histogram, [ & ] { return queue.EnqueueWithToken( token, static_cast<int>( i ) ); } );
+            }
+            for ( std::size_t i = 0; i < kBatch; ++i ) {
+                Timed( histogram, [ & ] { return queue.TryDequeueFromProducer( token, value ); } );
+            }
+        }
+    }
+    histogram.Report( state );
+    state.SetItemsProcessed( state.iterations() * kBatch * 2 );
+}
+
+// 实时配置：所有存储在构造时预分配、预缺页并锁定，运行时只有 TryEnqueue
+static void BM_RealTimeEnqueueLatency( benchmark::State& state ) {
+    LatencyHistogram histogram;
+    RealTimeQueue    queue;
+    {
+        RealTimeQueue::ProducerToken token( queue );
+        int                          value = 0;
+        for ( auto _ : state ) {
+            for ( std::size_t i = 0; i < kBatch; ++i ) {
+                Timed( histogram, [ & ] { return queue.TryEnqueue( token, static_cast<int>( i ) ); } );
+            }
+            for ( std::size_t i = 0; i < kBatch; ++i ) {
+                Timed( histogram, [ & ] { return queue.TryDequeueFromProducer( token, value ); } );
+            }
+        }
+    }
+    histogram.Report( state );
+    state.counters[ "lock_failures" ] = static_cast<double>( hakle::HaklePinnedAllocator<int>::GetLockFailures() );
+    state.SetItemsProcessed( state.iterations() * kBatch * 2 );
+}
+
+// 每次都用新队列，最坏延迟里包含冷启动
+BENCHMARK( BM_DefaultEnqueueLatency )->Iterations( 1 )->Repetitions( 20 );
+BENCHMARK( BM_RealTimeEnqueueLatency )->Iterations( 1 )->Repetitions( 20 );
+// 稳态
+BENCHMARK( BM_DefaultEnqueueLatency );
+BENCHMARK( BM_RealTimeEnqueueLatency );
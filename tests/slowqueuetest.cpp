@@ -25,6 +25,30 @@ using TestFlagsBlockManager   = HakleCounterBlockManager<int, kBlockSize>;
 // 辅助：等待一段时间让操作完成
 void SleepFor( std::int64_t ms ) { std::this_thread::sleep_for( std::chrono::milliseconds( ms ) ); }
 
+// 统计队列自身（索引数组）占用的字节数，block 由 manager 分配，不计入
+std::atomic<std::size_t> g_LiveBytes{ 0 };
+
+template <class Tp>
+struct CountingAllocator : HakleAllocator<Tp> {
+    using typename HakleAllocator<Tp>::Pointer;
+    using typename HakleAllocator<Tp>::SizeType;
+
+    CountingAllocator() noexcept = default;
+    template <class Up>
+    explicit CountingAllocator( const CountingAllocator<Up>& ) noexcept {}
+
+    Pointer Allocate() { return Allocate( 1 ); }
+    Pointer Allocate( SizeType n ) {
+        g_LiveBytes += n * sizeof( Tp );
+        return HakleAllocator<Tp>::Allocate( n );
+    }
+    void Deallocate( Pointer p ) noexcept { Deallocate( p, 1 ); }
+    void Deallocate( Pointer p, SizeType n ) noexcept {
+        g_LiveBytes -= n * sizeof( Tp );
+        HakleAllocator<Tp>::Deallocate( p, n );
+    }
+};
+
 // === 测试 1: 基本 Enqueue/Dequeue ===
 TEST( SlowQueueTest, BasicEnqueueDequeue ) {
     TestFlagsBlockManager blockManager( POOL_SIZE );
@@ -368,6 +392,128 @@ TEST( SlowQueueTest, MultiConsumerStressTestWithException ) {
 }
 
 // test/queue_test.cpp 最后加上：
+// === 测试: 内联存储的第一个 block 不归还给 manager ===
+TEST( SlowQueueTest, InlineStorage ) {
+    TestFlagsBlockManager            blockManager( 0 );
+    TestFlagsQueue::InlineStorage<4> storage;
+    TestFlagsQueue                   queue( storage, &blockManager );
+    using AllocMode = TestFlagsQueue::AllocMode;
+
+    for ( int round = 0; round < 3; ++round ) {
+        // 内联 block 足以容纳一个 block 的元素，不需要分配
+        for ( int i = 0; i < static_cast<int>( kBlockSize ); ++i ) {
+            EXPECT_TRUE( queue.Enqueue<AllocMode::CannotAlloc>( i ) );
+        }
+        EXPECT_FALSE( queue.Enqueue<AllocMode::CannotAlloc>( -1 ) );
+
+        int value = 0;
+        for ( int i = 0; i < static_cast<int>( kBlockSize ); ++i ) {
+            EXPECT_TRUE( queue.Dequeue( value ) );
+            EXPECT_EQ( value, i );
+        }
+        EXPECT_FALSE( queue.Dequeue( value ) );
+    }
+
+    // 超出内联 block 后从 manager 分配，批量入队也会先使用内联 block
+    std::vector<int> items( 10 * kBlockSize );
+    for ( std::size_t i = 0; i < items.size(); ++i ) {
+        items[ i ] = static_cast<int>( i );
+    }
+    EXPECT_TRUE( queue.EnqueueBulk<AllocMode::CanAlloc>( items.begin(), items.size() ) );
+    int value = 0;
+    for ( std::size_t i = 0; i < items.size(); ++i ) {
+        EXPECT_TRUE( queue.Dequeue( value ) );
+        EXPECT_EQ( value, static_cast<int>( i ) );
+    }
+    EXPECT_FALSE( queue.Dequeue( value ) );
+}
+
+TEST( SlowQueueTest, ReclaimIndexArrays ) {
+    using Queue     = SlowQueue<int, kBlockSize, CountingAllocator<int>>;
+    using AllocMode = Queue::AllocMode;
+    constexpr std::size_t blockCount = 1000;
+    // 每项一个 entry（两个原子量）和一个索引指针
+    constexpr std::size_t slotBytes = 3 * sizeof( void* );
+
+    TestFlagsBlockManager blockManager( POOL_SIZE );
+    {
+        // entry 分段保留，被替换的索引指针数组在没有读者时释放
+        Queue queue( 2, &blockManager );
+        for ( std::size_t i = 0; i < blockCount * kBlockSize; ++i ) {
+            ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( static_cast<int>( i ) ) );
+        }
+        EXPECT_LE( g_LiveBytes.load(), 1024 * slotBytes + 1024 );
+
+        std::atomic<int>         count{ 0 };
+        std::vector<std::thread> consumers;
+        for ( int c = 0; c < 4; ++c ) {
+            consumers.emplace_back( [ &queue, &count ] {
+                int value = 0;
+                while ( count.load() < static_cast<int>( blockCount * kBlockSize ) ) {
+                    if ( queue.Dequeue( value ) ) {
+                        ++count;
+                    }
+                }
+            } );
+        }
+        for ( auto& t : consumers ) {
+            t.join();
+        }
+        EXPECT_EQ( queue.Size(), 0u );
+    }
+    EXPECT_EQ( g_LiveBytes.load(), 0u );
+}
+
+TEST( SlowQueueTest, ReclaimIndexArraysWhileConsuming ) {
+    using Queue     = SlowQueue<int, kBlockSize, CountingAllocator<int>>;
+    using AllocMode = Queue::AllocMode;
+    constexpr std::size_t blockCount = 1000;
+    constexpr std::size_t slotBytes  = 3 * sizeof( void* );
+
+    TestFlagsBlockManager blockManager( POOL_SIZE );
+    {
+        // 消费者一直在读索引，不用等它们停下，被替换的索引指针数组在之后的 block 边界就能回收
+        Queue                    queue( 2, &blockManager );
+        std::atomic<bool>        stop{ false };
+        std::atomic<std::size_t> count{ 0 };
+        std::vector<std::thread> consumers;
+        for ( int c = 0; c < 4; ++c ) {
+            consumers.emplace_back( [ &queue, &stop, &count ] {
+                int value = 0;
+                while ( !stop.load() ) {
+                    if ( queue.Dequeue( value ) ) {
+                        ++count;
+                    }
+                }
+            } );
+        }
+
+        std::size_t enqueued = 0;
+        for ( ; enqueued < blockCount * kBlockSize; ++enqueued ) {
+            ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( 1 ) );
+        }
+        bool reclaimed = false;
+        for ( int round = 0; round < 10000 && !reclaimed; ++round ) {
+            for ( std::size_t i = 0; i < kBlockSize; ++i, ++enqueued ) {
+                ASSERT_TRUE( queue.Enqueue<AllocMode::CanAlloc>( 1 ) );
+            }
+            reclaimed = g_LiveBytes.load() <= 1024 * slotBytes + 1024;
+        }
+        stop.store( true );
+        for ( auto& t : consumers ) {
+            t.join();
+        }
+        EXPECT_TRUE( reclaimed );
+
+        int value = 0;
+        while ( queue.Dequeue( value ) ) {
+            ++count;
+        }
+        EXPECT_EQ( count.load(), enqueued );
+    }
+    EXPECT_EQ( g_LiveBytes.load(), 0u );
+}
+
 int main( int argc, char** argv ) {
     ::testing::InitGoogleTest( &argc, argv );
 
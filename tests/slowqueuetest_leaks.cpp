@@ -124,6 +124,25 @@ TEST( SlowQueueLeaks, StressTest ) {
     }
 }
 
+// 尾块只写了一部分、又被全部取走时，Dequeue 不会归还它，要靠 Clear 还给 block manager
+TEST( SlowQueueLeaks, ClearReleasesDrainedPartialTail ) {
+    HakleCounterBlockManager<int, kBlockSize> blockManager( 1 );
+    {
+        SlowQueue<int, kBlockSize> queue( 2, &blockManager );
+        ASSERT_TRUE( queue.Enqueue<SlowAllocMode::CannotAlloc>( 1 ) );
+        ASSERT_TRUE( queue.Enqueue<SlowAllocMode::CannotAlloc>( 2 ) );
+        int value = 0;
+        ASSERT_TRUE( queue.Dequeue( value ) );
+        ASSERT_TRUE( queue.Dequeue( value ) );
+        EXPECT_EQ( blockManager.RequisitionBlock( AllocMode::CannotAlloc ), nullptr );
+    }
+
+    // 唯一的 block 已经回到池里
+    TestCounterBlock* block = blockManager.RequisitionBlock( AllocMode::CannotAlloc );
+    EXPECT_NE( block, nullptr );
+    blockManager.ReturnBlock( block );
+}
+
 TEST( SlowQueueLeaks, EnqueueExceptionTest ) {
     using ExceptionBlock       = HakleCounterBlock<ExceptionTest, kBlockSize>;
     using ExceptionBlockManger = HakleBlockManager<ExceptionBlock>;